@@ -0,0 +1,154 @@
+#include "buttons_host.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "buttons.h"
+
+namespace bhost {
+
+struct In {
+  uint32_t t;
+  uint8_t id;
+  uint8_t level;
+};
+
+static char evChar(btn::Ev e) {
+  switch (e) {
+    case btn::Ev::PRESS:   return 'P';
+    case btn::Ev::RELEASE: return 'R';
+    case btn::Ev::LONG:    return 'L';
+    default:               return 'r';
+  }
+}
+
+// Entrega los flancos hasta cada poll (como loop() con la cola de la ISR)
+// y devuelve "P0@0 R0@300 ..." (REPEAT sin listar: solo se cuentan)
+static std::string drive(btn::Decoder& d, const std::vector<In>& in, uint32_t end,
+                         uint32_t pollMs, uint32_t jitterMs, std::vector<btn::Event>* reps = nullptr) {
+  std::string out;
+  size_t i = 0;
+  uint32_t rng = 777;
+  for (uint32_t now = 0; now <= end;) {
+    while (i < in.size() && in[i].t <= now) {
+      btn::Edge e;
+      e.t_ms = in[i].t;
+      e.id = in[i].id;
+      e.level = in[i].level;
+      d.onEdge(e);
+      i++;
+    }
+    d.poll(now);
+    btn::Event ev;
+    while (d.next(ev)) {
+      if (ev.type == btn::Ev::REPEAT) {
+        if (reps) reps->push_back(ev);
+        continue;
+      }
+      char s[24];
+      snprintf(s, sizeof(s), "%s%c%u@%lu", out.empty() ? "" : " ", evChar(ev.type),
+               (unsigned)ev.id, (unsigned long)ev.t_ms);
+      out += s;
+    }
+    rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+    now += pollMs + (jitterMs ? rng % (jitterMs + 1) : 0);
+  }
+  return out;
+}
+
+static int check(bool ok, const char* what, const std::string& got) {
+  printf("[btn] %s %s%s%s\n", ok ? "OK   " : "FALLA", what, ok ? "" : ": ", ok ? "" : got.c_str());
+  return ok ? 0 : 1;
+}
+
+int runChecks() {
+  int fails = 0;
+
+  // 1) rebotes al apretar y al soltar: un PRESS y un RELEASE en el primer flanco
+  {
+    btn::Decoder d;
+    d.begin(0, 0);
+    const std::vector<In> in = { {100, 1, 1}, {102, 1, 0}, {103, 1, 1}, {105, 1, 0}, {106, 1, 1},
+                                 {400, 1, 0}, {402, 1, 1}, {404, 1, 0} };
+    const std::string got = drive(d, in, 1000, 10, 0);
+    fails += check(got == "P1@100 R1@400", "rebotes", got);
+  }
+
+  // 2) toques más cortos que el lockout, entregados juntos en un solo poll:
+  //    ninguno se pierde, a lo sumo se corre al fin del lockout
+  {
+    btn::Decoder d;
+    d.begin(0, 0);
+    const std::vector<In> in = { {10, 0, 1}, {22, 0, 0}, {60, 0, 1}, {75, 0, 0} };
+    const std::string got = drive(d, in, 400, 200, 0);
+    fails += check(got == "P0@10 R0@40 P0@70 R0@100", "toques cortos", got);
+  }
+
+  // 3) poll lento y con jitter (render de 40-100 ms): mismos tiempos que a 1 ms
+  {
+    const std::vector<In> in = { {50, 2, 1}, {51, 2, 0}, {53, 2, 1}, {260, 2, 0},
+                                 {700, 0, 1}, {760, 0, 0}, {761, 0, 1}, {790, 0, 0} };
+    btn::Decoder a, b;
+    a.begin(0, 0);
+    b.begin(0, 0);
+    const std::string fast = drive(a, in, 2000, 1, 0);
+    const std::string slow = drive(b, in, 2000, 40, 60);
+    fails += check(fast == slow && fast == "P2@50 R2@260 P0@700 R0@760 P0@790 R0@820",
+                   "latencia independiente del poll", slow);
+  }
+
+  // 4) LONG en B4 (1200 ms) sin repeat; sostenido desde el arranque no cuenta
+  {
+    btn::Decoder d;
+    d.setLongMs(3, 1200);
+    d.setLongMs(0, 1200);
+    d.begin(0, 0x01);
+    const std::vector<In> in = { {0, 3, 1}, {100, 3, 1}, {2000, 3, 0}, {2500, 0, 0} };
+    const std::string got = drive(d, in, 3000, 10, 0);
+    fails += check(got == "P3@0 L3@1200 R3@2000 R0@2500", "long press", got);
+  }
+
+  // 5) auto-repeat acelerado en B2 (EDIT): plazos fijos, intervalos que bajan al mínimo
+  {
+    btn::Decoder d;
+    d.begin(0, 0);
+    d.setRepeatMask(0x06);
+    std::vector<btn::Event> reps;
+    const std::vector<In> in = { {0, 1, 1}, {5000, 1, 0} };
+    const std::string got = drive(d, in, 6000, 10, 0, &reps);
+    bool ok = got == "P1@0 R1@5000" && !reps.empty() && reps[0].t_ms == btn::REPEAT_DELAY_MS;
+    uint32_t prevGap = 0xFFFFFFFFu;
+    for (size_t i = 1; ok && i < reps.size(); i++) {
+      const uint32_t gap = reps[i].t_ms - reps[i - 1].t_ms;
+      if (gap > prevGap || gap < btn::REPEAT_MIN_MS || reps[i].rep != i + 1) ok = false;
+      prevGap = gap;
+    }
+    ok = ok && prevGap == btn::REPEAT_MIN_MS;
+
+    // speed_factor de 1.00 a 2.00 en pasos de 0.01 * accelStep
+    uint32_t units = 1, tDone = 0;   // el PRESS ya sumó 1
+    for (const btn::Event& e : reps) {
+      units += btn::accelStep(e.rep);
+      if (units >= 100) { tDone = e.t_ms; break; }
+    }
+    fails += check(ok && tDone > 0, "auto-repeat acelerado", got);
+    printf("[btn]       %u repeticiones en 5 s; +1.00 en speed_factor sostenido %lu ms (antes: 100 toques)\n",
+           (unsigned)reps.size(), (unsigned long)tDone);
+  }
+
+  // 6) fuera de la máscara no repite
+  {
+    btn::Decoder d;
+    d.begin(0, 0);
+    d.setRepeatMask(0x06);
+    std::vector<btn::Event> reps;
+    const std::vector<In> in = { {0, 0, 1}, {3000, 0, 0} };
+    const std::string got = drive(d, in, 3500, 10, 0, &reps);
+    fails += check(got == "P0@0 R0@3000" && reps.empty(), "sin repeat fuera de la mascara", got);
+  }
+
+  return fails;
+}
+
+} // namespace bhost
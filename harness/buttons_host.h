@@ -0,0 +1,12 @@
+#pragma once
+
+// ===================== Botones en host =====================
+// btn::Decoder con trenes de flancos sintéticos (rebotes, toques cortos,
+// sostenidos) y polls con jitter de render.
+
+namespace bhost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace bhost
@@ -0,0 +1,188 @@
+#include "calib_host.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "calib.h"
+#include "config_store.h"
+#include "crc16_modbus.h"
+#include "rx_pipeline.h"
+#include "mem_kv.h"
+
+namespace chost {
+
+static int check(bool ok, const char* what) {
+  printf("[cal] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+// Máximo error (centésimas) de speedCenti contra round(curva * factor) en las 65536 entradas
+static uint32_t speedMaxErr(const AppConfig& c, const calib::Tables& t) {
+  uint32_t worst = 0;
+  for (uint32_t x = 0; x < 65536; x++) {
+    double want = floor((double)calib::curveCenti(c, (float)x) * c.speed_factor + 0.5);
+    if (want < 0) want = 0;
+    if (want > 65535) want = 65535;
+    const uint32_t e = (uint32_t)fabs((double)t.speedCenti((uint16_t)x) - want);
+    if (e > worst) worst = e;
+  }
+  return worst;
+}
+
+static uint32_t dirMaxErr(const AppConfig& c, const calib::Tables& t) {
+  uint32_t worst = 0;
+  for (uint32_t a = 0; a < 36000; a++) {
+    double want = fmod(a + c.dir_offset_deg * 100.0 + calib::deviationCdeg(c, (float)a), 36000.0);
+    if (want < 0) want += 36000.0;
+    double e = fabs((double)t.dirCdeg((uint16_t)a) - want);
+    if (e > 18000.0) e = 36000.0 - e;
+    if (e > worst) worst = (uint32_t)ceil(e - 1e-6);
+  }
+  return worst;
+}
+
+// Copa real: umbral de arranque ~1 kn y curva que se aplana arriba
+static AppConfig cupCurve() {
+  AppConfig c;
+  const uint16_t in[]  = { 0,    150,  500,  1500, 3000, 6000, 12000, 20000 };
+  const uint16_t out[] = { 0,    110,  480,  1460, 2870, 5550, 10400, 16300 };
+  c.spd_cal_n = 8;
+  memcpy(c.spd_cal_in, in, sizeof(in));
+  memcpy(c.spd_cal_out, out, sizeof(out));
+  const int16_t dev[] = { 120, 340, -210, -480, -150, 260, 410, -90 };
+  memcpy(c.dir_dev_cdeg, dev, sizeof(dev));
+  c.dir_offset_deg = -12;
+  c.speed_factor = 1.05f;
+  return c;
+}
+
+int runChecks() {
+  int fails = 0;
+  static calib::Tables t;   // ~2 KB
+
+  // 1) sin curva: igual que el factor lineal de antes
+  {
+    AppConfig c;
+    c.speed_factor = 1.07f;
+    c.dir_offset_deg = 170;
+    t.compile(c);
+    fails += check(speedMaxErr(c, t) <= 1 && dirMaxErr(c, t) == 0 && t.segments() == 1,
+                   "lineal (factor + offset)");
+  }
+
+  // 2) curva de 8 puntos + desvío por sector: todas las entradas
+  {
+    const AppConfig c = cupCurve();
+    t.compile(c);
+    const uint32_t es = speedMaxErr(c, t), ed = dirMaxErr(c, t);
+    bool knots = true;
+    for (uint8_t i = 0; i < c.spd_cal_n; i++) {
+      const long want = lround(c.spd_cal_out[i] * (double)c.speed_factor);
+      if (labs((long)t.speedCenti(c.spd_cal_in[i]) - want) > 1) knots = false;
+    }
+    char what[96];
+    snprintf(what, sizeof(what), "curva 8 puntos: err max vel %lu cKn, dir %lu cdeg",
+             (unsigned long)es, (unsigned long)ed);
+    fails += check(es <= 1 && ed <= 1 && knots && t.segments() == 7, what);
+  }
+
+  // 3) curvas inválidas vuelven a lineal; desvío acotado
+  {
+    AppConfig c = cupCurve();
+    c.spd_cal_in[3] = c.spd_cal_in[2] + CAL_MIN_SPACING - 1;   // demasiado juntos
+    c.dir_dev_cdeg[0] = 9000;
+    sanitizeConfig(c);
+    AppConfig d = cupCurve();
+    d.spd_cal_n = 1;
+    sanitizeConfig(d);
+    fails += check(c.spd_cal_n == 0 && d.spd_cal_n == 0 && c.dir_dev_cdeg[0] == CAL_DEV_MAX_CDEG,
+                   "sanitize de curva y desvio");
+  }
+
+  // 4) blob v3 ida y vuelta; blob v2 (más corto) carga sin curva
+  {
+    MemKv kv;
+    cfgstore::ConfigStore st;
+    AppConfig live;
+    st.begin(kv, live);
+    live = cupCurve();
+    st.commitNow();
+    AppConfig back;
+    cfgstore::ConfigStore st2;
+    st2.begin(kv, back);
+    const bool v3 = st2.stats().loadedBlob && back.spd_cal_n == 8 &&
+                    memcmp(back.spd_cal_out, live.spd_cal_out, sizeof(back.spd_cal_out)) == 0 &&
+                    memcmp(back.dir_dev_cdeg, live.dir_dev_cdeg, sizeof(back.dir_dev_cdeg)) == 0;
+
+    // v2: header + payload hasta avg_nmea + CRC
+    const size_t v2Len = offsetof(cfgstore::Payload, spd_cal_n);
+    uint8_t raw[cfgstore::BLOB_MAX];
+    const cfgstore::BlobHeader h { cfgstore::BLOB_MAGIC, 2, (uint8_t)v2Len };
+    cfgstore::Payload p {};
+    p.dir_offset_deg = 7;
+    p.speed_factor = 1.2f;
+    p.espnow_channel = 6;
+    memcpy(raw, &h, sizeof(h));
+    memcpy(raw + sizeof(h), &p, v2Len);
+    const uint16_t crc = crc16_modbus(raw, sizeof(h) + v2Len);
+    memcpy(raw + sizeof(h) + v2Len, &crc, sizeof(crc));
+    kv.putBytes(cfgstore::BLOB_KEY, raw, sizeof(h) + v2Len + sizeof(crc));
+    AppConfig old;
+    cfgstore::ConfigStore st3;
+    st3.begin(kv, old);
+    const bool v2 = st3.stats().loadedBlob && old.dir_offset_deg == 7 && old.espnow_channel == 6 &&
+                    old.spd_cal_n == 0 && old.dir_dev_cdeg[3] == 0;
+    fails += check(v3 && v2, "blob v3 y compatibilidad v2");
+  }
+
+  // 5) throughput: derive() con tablas vs el float de antes (factor + offset con %)
+  {
+    const AppConfig c = cupCurve();
+    t.compile(c);
+    static WindPacket pk[4096];
+    uint32_t rng = 99;
+    for (WindPacket& p : pk) {
+      rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+      p.angle_cdeg = (uint16_t)(rng % 36000);
+      p.pps_centi = (uint16_t)((rng >> 16) % 4000);
+      p.rpm_centi = p.pps_centi * 3;
+    }
+    const uint32_t N = 4000000;
+    uint32_t acc = 0;
+    auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < N; i++) {
+      const rxpipe::Derived d = rxpipe::derive(pk[i & 4095], t);
+      acc += d.dir_cdeg + d.spd_centi;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < N; i++) {
+      const WindPacket& p = pk[i & 4095];
+      int32_t dir = ((int32_t)p.angle_cdeg + (int32_t)c.dir_offset_deg * 100) % 36000;
+      if (dir < 0) dir += 36000;
+      const float kn = (float)p.pps_centi / 100.0f * c.speed_factor;
+      const float sc = kn * 100.0f + 0.5f;
+      acc += (uint32_t)dir + (sc >= 65535.0f ? 65535u : (sc > 0.0f ? (uint16_t)sc : 0u));
+    }
+    auto t2 = std::chrono::steady_clock::now();
+    // la misma curva + desvío evaluados en float por muestra (sin compilar)
+    for (uint32_t i = 0; i < N; i++) {
+      const WindPacket& p = pk[i & 4095];
+      float dir = (float)p.angle_cdeg + c.dir_offset_deg * 100.0f + calib::deviationCdeg(c, p.angle_cdeg);
+      while (dir < 0.0f) dir += 36000.0f;
+      while (dir >= 36000.0f) dir -= 36000.0f;
+      const float sc = calib::curveCenti(c, p.pps_centi) * c.speed_factor + 0.5f;
+      acc += (uint32_t)dir + (sc >= 65535.0f ? 65535u : (sc > 0.0f ? (uint16_t)sc : 0u));
+    }
+    auto t3 = std::chrono::steady_clock::now();
+    const double nsT = std::chrono::duration<double, std::nano>(t1 - t0).count() / N;
+    const double nsL = std::chrono::duration<double, std::nano>(t2 - t1).count() / N;
+    const double nsC = std::chrono::duration<double, std::nano>(t3 - t2).count() / N;
+    printf("[cal]       derive con tablas %.1f ns/muestra; en float: curva + desvio %.1f, lineal de antes %.1f (chk %u)\n",
+           nsT, nsC, nsL, (unsigned)(acc & 0xFF));
+  }
+
+  return fails;
+}
+
+} // namespace chost
@@ -0,0 +1,12 @@
+#pragma once
+
+// ===================== Calibración en host =====================
+// calib::Tables contra la referencia en float (todas las entradas posibles
+// de velocidad y dirección), blob v3 / v2 y throughput de derive().
+
+namespace chost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace chost
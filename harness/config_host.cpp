@@ -0,0 +1,226 @@
+#include "config_host.h"
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+
+#include "config_store.h"
+#include "crc16_modbus.h"
+#include "mem_kv.h"
+
+namespace khost {
+
+static int check(bool ok, const char* what) {
+  printf("[cfg] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+static void oldKeys(MemKv& kv) {
+  kv.set<int16_t>("dir_off", -25);
+  kv.set<float>("spd_fac", 1.15f);
+  kv.set<uint8_t>("spd_src", 1);
+  kv.set<uint8_t>("esp_ch", 6);
+}
+
+static bool fromOldKeys(const AppConfig& c) {
+  return c.dir_offset_deg == -25 && c.speed_factor == 1.15f && c.speed_src == 1 && c.espnow_channel == 6;
+}
+
+// Blob guardado por un ConfigStore con cfg = c
+static std::vector<uint8_t> blobOf(const AppConfig& c) {
+  MemKv kv;
+  cfgstore::ConfigStore st;
+  AppConfig live;
+  st.begin(kv, live);
+  live = c;
+  st.commitNow();
+  return kv.m_[cfgstore::BLOB_KEY];
+}
+
+// Arranque con el blob raw: devuelve cfg cargada y si vino del blob
+static AppConfig bootWith(const std::vector<uint8_t>& raw, bool& loaded) {
+  MemKv kv;
+  kv.m_[cfgstore::BLOB_KEY] = raw;
+  cfgstore::ConfigStore st;
+  AppConfig c;
+  st.begin(kv, c);
+  loaded = st.stats().loadedBlob;
+  return c;
+}
+
+static void resealCrc(std::vector<uint8_t>& raw) {
+  const size_t n = raw.size() - sizeof(uint16_t);
+  const uint16_t crc = crc16_modbus(raw.data(), n);
+  memcpy(raw.data() + n, &crc, sizeof(crc));
+}
+
+int runChecks() {
+  int fails = 0;
+
+  // 1) migración: claves viejas -> blob, se borran; el segundo boot lee el blob
+  {
+    MemKv kv;
+    oldKeys(kv);
+    cfgstore::ConfigStore st;
+    AppConfig c;
+    st.begin(kv, c);
+    const bool first = st.stats().migrated && !st.stats().loadedBlob && fromOldKeys(c) &&
+                       kv.isKey(cfgstore::BLOB_KEY) && !kv.isKey("dir_off") && !kv.isKey("esp_ch");
+    cfgstore::ConfigStore st2;
+    AppConfig c2;
+    st2.begin(kv, c2);
+    fails += check(first && st2.stats().loadedBlob && !st2.stats().migrated && fromOldKeys(c2),
+                   "migracion de claves sueltas a blob");
+  }
+
+  // 2) migración que no pudo escribir: las claves viejas quedan y se reintenta al bootear
+  {
+    MemKv kv;
+    oldKeys(kv);
+    kv.failPuts = 1;
+    cfgstore::ConfigStore st;
+    AppConfig c;
+    st.begin(kv, c);
+    const bool kept = fromOldKeys(c) && !kv.isKey(cfgstore::BLOB_KEY) && kv.isKey("dir_off");
+    cfgstore::ConfigStore st2;
+    AppConfig c2;
+    st2.begin(kv, c2);
+    fails += check(kept && st2.stats().migrated && kv.isKey(cfgstore::BLOB_KEY) && !kv.isKey("dir_off"),
+                   "migracion fallida se reintenta en el proximo boot");
+  }
+
+  // 3) blobs corruptos: defaults, sin tocar nada
+  {
+    AppConfig ref;
+    ref.dir_offset_deg = 40;
+    ref.espnow_channel = 11;
+    ref.avg_nmea = 2;
+    const std::vector<uint8_t> good = blobOf(ref);
+    bool loaded = false;
+    AppConfig c = bootWith(good, loaded);
+    bool ok = loaded && c.dir_offset_deg == 40 && c.espnow_channel == 11 && c.avg_nmea == 2;
+
+    // un bit cambiado en el payload
+    std::vector<uint8_t> bad = good;
+    bad[sizeof(cfgstore::BlobHeader) + 1] ^= 0x10;
+    c = bootWith(bad, loaded);
+    ok = ok && !loaded && c.dir_offset_deg == 0 && c.espnow_channel == 1;
+
+    // truncado (escritura cortada): len del header no coincide
+    bad.assign(good.begin(), good.end() - 5);
+    c = bootWith(bad, loaded);
+    ok = ok && !loaded && c.dir_offset_deg == 0;
+
+    // magic equivocado aunque el CRC cierre
+    bad = good;
+    bad[0] ^= 0xFF;
+    resealCrc(bad);
+    c = bootWith(bad, loaded);
+    ok = ok && !loaded;
+
+    // len menor que v1
+    bad = good;
+    bad[3] = 2;
+    bad.resize(sizeof(cfgstore::BlobHeader) + 2 + sizeof(uint16_t));
+    resealCrc(bad);
+    c = bootWith(bad, loaded);
+    ok = ok && !loaded;
+
+    // vacío
+    bad.clear();
+    c = bootWith(bad, loaded);
+    ok = ok && !loaded && c.espnow_channel == 1;
+    fails += check(ok, "blob corrupto/truncado/magic/len: defaults");
+  }
+
+  // 4) versión futura (payload más largo): carga lo conocido, ignora la cola
+  {
+    AppConfig ref;
+    ref.dir_offset_deg = -90;
+    ref.avg_display = 3;
+    std::vector<uint8_t> raw = blobOf(ref);
+    const size_t extra = 6;
+    raw.insert(raw.end() - sizeof(uint16_t), extra, 0xAB);
+    raw[2] = cfgstore::BLOB_VERSION + 1;
+    raw[3] = (uint8_t)(sizeof(cfgstore::Payload) + extra);
+    resealCrc(raw);
+    bool loaded = false;
+    const AppConfig c = bootWith(raw, loaded);
+    fails += check(loaded && c.dir_offset_deg == -90 && c.avg_display == 3, "blob de version futura");
+  }
+
+  // 5) blob válido con valores fuera de rango: sanitizeConfig
+  {
+    AppConfig ref;
+    ref.dir_offset_deg = 500;
+    ref.espnow_channel = 40;
+    ref.avg_nmea = 9;
+    ref.speed_factor = -3.0f;
+    bool loaded = false;
+    const AppConfig c = bootWith(blobOf(ref), loaded);
+    fails += check(loaded && c.dir_offset_deg == 180 && c.espnow_channel == 13 && c.avg_nmea == 0 &&
+                   c.speed_factor == 1.0f, "valores fuera de rango se acotan");
+  }
+
+  // 6) commit que falla: queda pendiente y tick() reintenta tras IDLE_COMMIT_MS
+  {
+    MemKv kv;
+    cfgstore::ConfigStore st;
+    AppConfig c;
+    st.begin(kv, c);
+    c.dir_offset_deg = 33;
+    st.markDirty(1000);
+    kv.failPuts = 1;
+    const uint32_t t1 = 1000 + cfgstore::IDLE_COMMIT_MS;
+    const bool first = !st.tick(t1) && st.pending() && st.stats().write_errors == 1;
+    const bool waits = !st.tick(t1 + 100) && kv.puts() == 1;       // no martilla NVS
+    const bool retry = st.tick(t1 + cfgstore::IDLE_COMMIT_MS) && !st.pending();
+
+    cfgstore::ConfigStore st2;
+    AppConfig c2;
+    st2.begin(kv, c2);
+    fails += check(first && waits && retry && c2.dir_offset_deg == 33, "commit fallido se reintenta");
+  }
+
+  // 7) fin de sesión sin cambios reales: no escribe
+  {
+    MemKv kv;
+    cfgstore::ConfigStore st;
+    AppConfig c;
+    st.begin(kv, c);
+    st.endSession();
+    fails += check(!st.tick(10) && kv.puts() == 0 && st.stats().skipped == 1 && !st.pending(),
+                   "sin cambios no escribe");
+  }
+
+  // 8) revert() descarta solo la sesión: un $PANA aplicado antes sigue pendiente
+  {
+    MemKv kv;
+    cfgstore::ConfigStore st;
+    AppConfig c;
+    st.begin(kv, c);
+    c.speed_factor = 1.25f;              // $PANA,FAC sin commit todavía
+    st.markDirty(1000);
+    st.beginSession();
+    c.dir_offset_deg = 40;               // editado en el menú
+    st.revert();
+    const bool kept = c.speed_factor == 1.25f && c.dir_offset_deg == 0 && st.pending();
+    const bool wrote = st.tick(1000 + cfgstore::IDLE_COMMIT_MS) && !st.pending();
+
+    st.beginSession();
+    c.speed_src = 1;
+    st.revert();
+    const bool clean = c.speed_src == 0 && !st.pending() && !st.tick(100000);
+    st.revert();                         // sin sesión abierta: nada
+    const bool noop = c.speed_factor == 1.25f && !st.pending();
+
+    cfgstore::ConfigStore st2;
+    AppConfig c2;
+    st2.begin(kv, c2);
+    fails += check(kept && wrote && clean && noop && c2.speed_factor == 1.25f && c2.dir_offset_deg == 0,
+                   "revert vuelve a beginSession, no a lo persistido");
+  }
+
+  return fails;
+}
+
+} // namespace khost
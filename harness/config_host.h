@@ -0,0 +1,13 @@
+#pragma once
+
+// ===================== Store de configuración en host =====================
+// cfgstore::ConfigStore sobre un Kv en memoria: migración de las claves
+// sueltas viejas, blobs corruptos/truncados/de otra versión y reintento
+// de un commit que no se pudo escribir.
+
+namespace khost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace khost
@@ -0,0 +1,106 @@
+#include "crc_host.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "crc16_modbus.h"
+
+namespace mhost {
+
+static int check(bool ok, const char* what) {
+  printf("[crc] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+// xorshift32: mismo buffer en cada corrida
+struct Rng {
+  uint32_t s;
+  uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+};
+
+static void fill(uint8_t* p, size_t n, Rng& rng) {
+  for (size_t i = 0; i < n; i++) p[i] = (uint8_t)rng.next();
+}
+
+int runChecks() {
+  int fails = 0;
+  Rng rng { 0xC16C16u };
+
+  // vector de referencia de Modbus
+  const uint8_t ref[] = { '1', '2', '3', '4', '5', '6', '7', '8', '9' };
+  fails += check(crc16_modbus(ref, sizeof(ref)) == 0x4B37 && crc16_modbus_bitwise(ref, sizeof(ref)) == 0x4B37,
+                 "\"123456789\" = 0x4B37");
+
+  // todos los largos 0..300 (colas de slicing-by-4) y 2000 buffers al azar
+  uint8_t buf[1024], dst[1024];
+  uint32_t badTable = 0, badSlice = 0, badCopy = 0, badInc = 0;
+  for (uint32_t it = 0; it < 2300; it++) {
+    const size_t n = (it <= 300) ? it : rng.next() % sizeof(buf);
+    fill(buf, n, rng);
+    const uint16_t want = crc16_modbus_bitwise(buf, n);
+
+    if (crc16::update(crc16::INIT, buf, n) != want) badTable++;
+    if (crc16::update4(crc16::INIT, buf, n) != want || crc16_modbus(buf, n) != want) badSlice++;
+
+    memset(dst, 0, sizeof(dst));
+    if (crc16::copyUpdate(crc16::INIT, dst, buf, n) != want || memcmp(dst, buf, n) != 0) badCopy++;
+
+    // Modbus en partes al azar, mezclando bloques y bytes sueltos
+    crc16::Modbus m;
+    m.update(buf, 0);
+    for (size_t off = 0; off < n; ) {
+      const size_t k = rng.next() % 9;
+      if (k == 0) {
+        m.update(buf[off]);
+        off++;
+      } else {
+        const size_t take = (k > n - off) ? n - off : k;
+        m.update(buf + off, take);
+        off += take;
+      }
+    }
+    if (m.value() != want) badInc++;
+    m.reset();
+    if (m.value() != crc16::INIT) badInc++;
+  }
+  fails += check(badTable == 0, "tabla byte a byte = bit a bit");
+  fails += check(badSlice == 0, "slicing-by-4 = bit a bit (largos 0..300 y al azar)");
+  fails += check(badCopy == 0, "copyUpdate copia y da el mismo CRC");
+  fails += check(badInc == 0, "Modbus incremental en partes al azar");
+  return fails;
+}
+
+// ----------------- bench -----------------
+template <typename F>
+static double mbps(const std::vector<uint8_t>& data, size_t chunk, F fn, uint32_t& sink) {
+  const auto t0 = std::chrono::steady_clock::now();
+  for (size_t off = 0; off + chunk <= data.size(); off += chunk) sink += fn(data.data() + off, chunk);
+  const auto t1 = std::chrono::steady_clock::now();
+  const double s = std::chrono::duration<double>(t1 - t0).count();
+  return (double)(data.size() / chunk * chunk) / s / 1e6;
+}
+
+void runBench(uint32_t kb) {
+  std::vector<uint8_t> data((size_t)kb * 1024);
+  Rng rng { 0xBE7C4u };
+  fill(data.data(), data.size(), rng);
+  std::vector<uint8_t> dst(1024);
+  uint32_t sink = 0;
+
+  printf("[crc] %lu KB por variante (MB/s)\n", (unsigned long)kb);
+  const size_t chunks[] = { 28, 250, 1024 };   // v1, v2 máximo, bloque
+  for (size_t c : chunks) {
+    const double bit = mbps(data, c, [](const uint8_t* p, size_t n) { return crc16_modbus_bitwise(p, n); }, sink);
+    const double tab = mbps(data, c, [](const uint8_t* p, size_t n) { return crc16::update(crc16::INIT, p, n); }, sink);
+    const double s4  = mbps(data, c, [](const uint8_t* p, size_t n) { return crc16::update4(crc16::INIT, p, n); }, sink);
+    const double cpy = mbps(data, c, [&](const uint8_t* p, size_t n) {
+      return crc16::copyUpdate(crc16::INIT, dst.data(), p, n);
+    }, sink);
+    printf("[crc] %4lu B: bit a bit %7.1f  tabla %7.1f (x%.1f)  slicing-4 %7.1f (x%.1f)  copia+crc %7.1f\n",
+           (unsigned long)c, bit, tab, tab / bit, s4, s4 / bit, cpy);
+  }
+  printf("[crc] (chk %lu)\n", (unsigned long)(sink & 0xFFFF));
+}
+
+} // namespace mhost
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+// ===================== CRC16-Modbus en host =====================
+// Tabla byte a byte, slicing-by-4, copyUpdate() y el acumulador Modbus
+// (en partes al azar) contra la referencia bit a bit sobre buffers al azar.
+
+namespace mhost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+// MB/s de cada variante sobre 'kb' KB (tramas de 28 y 250 B, y bloque grande)
+void runBench(uint32_t kb);
+
+} // namespace mhost
@@ -0,0 +1,115 @@
+#include "flush_host.h"
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+#include "lcd_flush.h"
+
+namespace fhost {
+
+static int check(bool ok, const char* what) {
+  printf("[flush] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+using Rows = lcd_flush::DirtyRows<16, 8>;   // ST7920: 128x64
+
+// Graba los rectángulos "y+n" y los copia al LCD simulado, como
+// updateDisplayArea()
+struct Recorder {
+  const uint8_t* fb = nullptr;
+  uint8_t lcd[Rows::BUF_BYTES] = {};
+  std::string calls;
+  uint32_t bytes = 0;
+  int lastEnd = -1;
+  bool adjacent = false;      // dos rectángulos seguidos que debieron ser uno
+
+  void operator()(uint8_t ty, uint8_t rows) {
+    char c[12];
+    snprintf(c, sizeof(c), "%u+%u ", ty, rows);
+    calls += c;
+    if (ty == lastEnd) adjacent = true;
+    lastEnd = ty + rows;
+    const uint16_t off = (uint16_t)ty * Rows::ROW_BYTES;
+    memcpy(lcd + off, fb + off, (size_t)rows * Rows::ROW_BYTES);
+    bytes += (uint32_t)rows * Rows::ROW_BYTES;
+  }
+};
+
+// Un flush: devuelve los rectángulos grabados ("" = nada)
+static std::string flush(Rows& d, Recorder& r, const uint8_t* fb, uint16_t& sent) {
+  r.fb = fb;
+  r.calls.clear();
+  r.lastEnd = -1;
+  sent = d.flush(fb, [&](uint8_t ty, uint8_t rows) { r(ty, rows); });
+  if (!r.calls.empty()) r.calls.pop_back();
+  return r.calls;
+}
+
+static void px(uint8_t* fb, uint8_t ty, uint16_t x) {
+  fb[(uint16_t)ty * Rows::ROW_BYTES + x] ^= 0x01;
+}
+
+int runChecks() {
+  int fails = 0;
+  static Rows d;
+  static Recorder r;
+  uint8_t fb[Rows::BUF_BYTES] = {};
+  uint16_t sent = 0;
+
+  std::string c = flush(d, r, fb, sent);
+  fails += check(c == "0+8" && sent == Rows::BUF_BYTES, "primer flush: pantalla completa");
+
+  c = flush(d, r, fb, sent);
+  fails += check(c.empty() && sent == 0 && d.lastBytes() == 0, "sin cambios: nada");
+
+  px(fb, 3, 77);
+  c = flush(d, r, fb, sent);
+  fails += check(c == "3+1" && sent == Rows::ROW_BYTES, "un pixel: una fila (128 B)");
+
+  px(fb, 1, 0); px(fb, 2, 127); px(fb, 5, 40);
+  c = flush(d, r, fb, sent);
+  fails += check(c == "1+2 5+1" && sent == 3 * Rows::ROW_BYTES, "filas 1,2 juntas y 5 aparte");
+
+  px(fb, 0, 5); px(fb, 7, 5);
+  c = flush(d, r, fb, sent);
+  fails += check(c == "0+1 7+1", "primera y ultima fila");
+
+  for (uint8_t ty = 2; ty < 8; ty++) px(fb, ty, ty);
+  c = flush(d, r, fb, sent);
+  fails += check(c == "2+6" && sent == 6 * Rows::ROW_BYTES, "corrida hasta el final");
+
+  // un cambio que vuelve al valor del shadow no es sucio
+  px(fb, 4, 9);
+  px(fb, 4, 9);
+  c = flush(d, r, fb, sent);
+  fails += check(c.empty(), "cambio revertido antes del flush: nada");
+
+  d.invalidate();
+  c = flush(d, r, fb, sent);
+  fails += check(c == "0+8" && memcmp(r.lcd, fb, sizeof(fb)) == 0, "invalidate: pantalla completa");
+
+  // al azar: el LCD simulado siempre igual al framebuffer, rectángulos maximales
+  uint32_t s = 0x5EEDu, bad = 0, bytes = 0, full = 0;
+  r.bytes = 0;
+  for (uint32_t f = 0; f < 5000; f++) {
+    const uint32_t n = (s >> 8) % 6;    // 0..5 pixels cambiados
+    for (uint32_t k = 0; k < n; k++) {
+      s = s * 1664525u + 1013904223u;
+      px(fb, (uint8_t)((s >> 24) & 7), (uint16_t)((s >> 8) % Rows::ROW_BYTES));
+    }
+    s = s * 1664525u + 1013904223u;
+    r.adjacent = false;
+    flush(d, r, fb, sent);
+    if (memcmp(r.lcd, fb, sizeof(fb)) != 0 || r.adjacent) bad++;
+    bytes += sent;
+    full += Rows::BUF_BYTES;
+  }
+  fails += check(bad == 0 && bytes == r.bytes, "5000 frames al azar: LCD = framebuffer");
+  printf("[flush]       %lu B enviados de %lu (%.0f%% del flush completo)\n",
+         (unsigned long)bytes, (unsigned long)full, 100.0 * bytes / full);
+  return fails;
+}
+
+} // namespace fhost
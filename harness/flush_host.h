@@ -0,0 +1,13 @@
+#pragma once
+
+// ===================== Flush de filas sucias en host =====================
+// lcd_flush::DirtyRows con un sink que graba cada rectángulo y lo copia a
+// un LCD simulado: filas juntadas, bytes enviados y pantalla siempre igual
+// al framebuffer.
+
+namespace fhost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace fhost
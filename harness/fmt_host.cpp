@@ -0,0 +1,153 @@
+#include "fmt_host.h"
+#include <math.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "fmt_fixed.h"
+
+namespace ohost {
+
+static int check(bool ok, const char* what) {
+  printf("[fmt] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+struct Rng {
+  uint32_t s;
+  uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+};
+
+// float al azar: mantisa al azar y exponente para |v| en [2^-12, 2^40),
+// a veces con pocas cifras binarias para caer en empates exactos
+static float randFloat(Rng& rng) {
+  uint32_t bits = rng.next();
+  const uint32_t exp = 127 - 12 + rng.next() % 52;
+  bits = (bits & 0x807FFFFFu) | (exp << 23);
+  if ((rng.next() & 3) == 0) bits &= 0xFFFFF000u;
+  float v;
+  memcpy(&v, &bits, sizeof(v));
+  return v;
+}
+
+static uint32_t mismatches = 0;
+static void same(const char* got, const char* want) {
+  if (strcmp(got, want) != 0 && ++mismatches <= 5) printf("[fmt]       \"%s\" != \"%s\"\n", got, want);
+}
+
+int runChecks() {
+  int fails = 0;
+  char a[48], b[48];
+  Rng rng { 0xF0F1u };
+
+  // %.Nf, %W.Nf y %0W.Nf
+  static const char* const FMT[4][3] = {
+    { "%.0f", "%5.0f", "%06.0f" }, { "%.1f", "%5.1f", "%06.1f" },
+    { "%.2f", "%5.2f", "%06.2f" }, { "%.3f", "%5.3f", "%08.3f" },
+  };
+  static const uint8_t W[4][3] = { { 0, 5, 6 }, { 0, 5, 6 }, { 0, 5, 6 }, { 0, 5, 8 } };
+  mismatches = 0;
+  for (uint32_t it = 0; it < 400000; it++) {
+    const float v = randFloat(rng);
+    for (uint8_t d = 0; d < 4; d++) {
+      for (uint8_t k = 0; k < 3; k++) {
+        fmt::Writer(a, sizeof(a)).f(v, d, W[d][k], k == 2 ? '0' : ' ');
+        snprintf(b, sizeof(b), FMT[d][k], (double)v);
+        same(a, b);
+      }
+    }
+  }
+  fails += check(mismatches == 0, "f(): 400k floats x %.0f..%.3f con ancho/pad = snprintf");
+
+  // empates y bordes elegidos a mano
+  static const float EDGE[] = { 0.0f, -0.0f, 0.5f, 1.5f, 2.5f, -2.5f, 0.125f, 0.375f, -0.0004f,
+                                0.05f, 9.995f, 99.95f, 359.95f, 1e15f, -1e15f, 1.0e-7f };
+  mismatches = 0;
+  for (float v : EDGE) {
+    for (uint8_t d = 0; d < 4; d++) {
+      fmt::Writer(a, sizeof(a)).f(v, d);
+      snprintf(b, sizeof(b), FMT[d][0], (double)v);
+      same(a, b);
+    }
+  }
+  fmt::Writer(a, sizeof(a)).f(NAN, 1, 5);        same(a, "  nan");
+  fmt::Writer(a, sizeof(a)).f(-INFINITY, 2);     same(a, "-inf");
+  fails += check(mismatches == 0, "f(): empates (par), -0, chicos, 1e15, nan/inf");
+
+  // enteros, hex y punto fijo
+  mismatches = 0;
+  for (uint32_t it = 0; it < 200000; it++) {
+    const uint32_t r = rng.next() >> (rng.next() % 32);
+    const int32_t s = (int32_t)rng.next() >> (rng.next() % 32);
+    fmt::Writer(a, sizeof(a)).u(r);                      snprintf(b, sizeof(b), "%lu", (unsigned long)r);   same(a, b);
+    fmt::Writer(a, sizeof(a)).u(r, 5);                   snprintf(b, sizeof(b), "%5lu", (unsigned long)r);  same(a, b);
+    fmt::Writer(a, sizeof(a)).i(s, 3, '0');              snprintf(b, sizeof(b), "%03ld", (long)s);          same(a, b);
+    fmt::Writer(a, sizeof(a)).i(s, 6);                   snprintf(b, sizeof(b), "%6ld", (long)s);           same(a, b);
+    fmt::Writer(a, sizeof(a)).hex(r, 4);                 snprintf(b, sizeof(b), "%04lX", (unsigned long)r); same(a, b);
+    fmt::Writer(a, sizeof(a)).hex(r & 0xFF, 2);          snprintf(b, sizeof(b), "%02lX", (unsigned long)(r & 0xFF)); same(a, b);
+    fmt::Writer(a, sizeof(a)).fixed(s, 2);
+    snprintf(b, sizeof(b), "%s%ld.%02ld", s < 0 ? "-" : "", (long)(llabs(s) / 100), (long)(llabs(s) % 100));
+    same(a, b);
+  }
+  fmt::Writer(a, sizeof(a)).i(INT32_MIN);        snprintf(b, sizeof(b), "%ld", (long)INT32_MIN); same(a, b);
+  fmt::Writer(a, sizeof(a)).fixed(-5, 3, 7, '0'); same(a, "-00.005");
+  fmt::Writer(a, sizeof(a)).hex(0, 0);           same(a, "0");
+  fails += check(mismatches == 0, "u/i/hex/fixed = %lu %5lu %03ld %6ld %04lX %02lX");
+
+  // truncado: mismo contenido que snprintf para toda capacidad, len/truncated
+  mismatches = 0;
+  uint32_t badLen = 0;
+  for (size_t cap = 0; cap <= 24; cap++) {
+    memset(a, '#', sizeof(a));
+    memset(b, '#', sizeof(b));
+    fmt::Writer w(a, cap);
+    w.str("Dir: ").f(123.45f, 1).ch('*').hex(0xAB, 2).i(-42, 5);
+    const int n = snprintf(b, cap, "Dir: %.1f*%02X%5d", (double)123.45f, 0xAB, -42);
+    if (memcmp(a, b, sizeof(a)) != 0) mismatches++;
+    if (w.truncated() != ((size_t)n >= cap) || w.len() != (cap ? ((size_t)n < cap ? (size_t)n : cap - 1) : 0)) badLen++;
+  }
+  fails += check(mismatches == 0 && badLen == 0, "truncado por cap 0..24 = snprintf, len()/truncated()");
+  return fails;
+}
+
+// ----------------- bench -----------------
+template <typename F>
+static double nsPerOp(uint32_t n, uint32_t& acc, F fn) {
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; i++) acc += fn(i);
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+void runBench(uint32_t n) {
+  uint32_t acc = 0;
+  char b[32];
+
+  const double fs = nsPerOp(n, acc, [&](uint32_t i) {
+    return (uint32_t)snprintf(b, sizeof(b), "%.2f", (double)((float)(i % 40000) * 0.01f));
+  });
+  const double fw = nsPerOp(n, acc, [&](uint32_t i) {
+    return (uint32_t)fmt::Writer(b, sizeof(b)).f((float)(i % 40000) * 0.01f, 2).len();
+  });
+  const double us = nsPerOp(n, acc, [&](uint32_t i) {
+    return (uint32_t)snprintf(b, sizeof(b), "Age:%lums St:0x%04X", (unsigned long)i, i & 0xFFFF);
+  });
+  const double uw = nsPerOp(n, acc, [&](uint32_t i) {
+    return (uint32_t)fmt::Writer(b, sizeof(b)).str("Age:").u(i).str("ms St:0x").hex(i & 0xFFFF, 4).len();
+  });
+  const double ms = nsPerOp(n, acc, [&](uint32_t i) {
+    return (uint32_t)snprintf(b, sizeof(b), "$WIMWV,%03d,R,%.1f,N,A", (int)(i % 360), (double)((float)(i % 400) * 0.1f));
+  });
+  const double mw = nsPerOp(n, acc, [&](uint32_t i) {
+    return (uint32_t)fmt::Writer(b, sizeof(b)).str("$WIMWV,").i((int32_t)(i % 360), 3, '0')
+                       .str(",R,").f((float)(i % 400) * 0.1f, 1).str(",N,A").len();
+  });
+
+  printf("[fmt] %lu llamadas por variante (ns/llamada)\n", (unsigned long)n);
+  printf("[fmt] %%.2f          : snprintf %6.1f  Writer %6.1f (x%.1f)\n", fs, fw, fs / fw);
+  printf("[fmt] Age/St int+hex: snprintf %6.1f  Writer %6.1f (x%.1f)\n", us, uw, us / uw);
+  printf("[fmt] cuerpo MWV     : snprintf %6.1f  Writer %6.1f (x%.1f)\n", ms, mw, ms / mw);
+  printf("[fmt] (chk %lu)\n", (unsigned long)(acc & 0xFFFF));
+}
+
+} // namespace ohost
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+// ===================== Formateo sin printf en host =====================
+// fmt::Writer contra snprintf de glibc, byte a byte: floats %.Nf con ancho y
+// pad, enteros, hex, punto fijo y truncado por capacidad del buffer.
+
+namespace ohost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+// ns por llamada: Writer vs snprintf para los formatos de LCD y NMEA
+void runBench(uint32_t n);
+
+} // namespace ohost
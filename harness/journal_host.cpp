@@ -0,0 +1,248 @@
+#include "journal_host.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <string.h>
+#include <chrono>
+#include <vector>
+
+#include "hist_journal.h"
+
+namespace jhost {
+
+static int check(bool ok, const char* what) {
+  printf("[journal] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+// ----------------- flash de archivo -----------------
+// write() hace AND con lo que hay (NOR); cutAfter(n) deja pasar n bytes más
+// de escritura/borrado y "corta la luz": lo que sigue falla hasta powerOn().
+class FileFlash : public hjournal::Flash {
+public:
+  explicit FileFlash(uint32_t sectors) : size_(sectors * hjournal::SECTOR_SIZE), erases_(sectors, 0) {
+    f_ = tmpfile();
+    std::vector<uint8_t> ff(hjournal::SECTOR_SIZE, 0xFF);
+    for (uint32_t s = 0; f_ && s < sectors; s++) fwrite(ff.data(), 1, ff.size(), f_);
+  }
+  ~FileFlash() override { if (f_) fclose(f_); }
+
+  bool ok() const { return f_ != nullptr; }
+  void cutAfter(uint32_t bytes) { budget_ = bytes; armed_ = true; }
+  void powerOn() { armed_ = dead_ = false; }
+  bool dead() const { return dead_; }
+  const std::vector<uint32_t>& erases() const { return erases_; }
+
+  uint32_t size() const override { return size_; }
+
+  bool read(uint32_t addr, void* dst, size_t n) override {
+    if (dead_ || addr + n > size_) return false;
+    fseek(f_, (long)addr, SEEK_SET);
+    return fread(dst, 1, n, f_) == n;
+  }
+
+  bool write(uint32_t addr, const void* src, size_t n) override {
+    if (dead_ || addr + n > size_) return false;
+    std::vector<uint8_t> cur(n);
+    fseek(f_, (long)addr, SEEK_SET);
+    if (fread(cur.data(), 1, n, f_) != n) return false;
+    const size_t k = take(n);
+    for (size_t i = 0; i < k; i++) cur[i] &= ((const uint8_t*)src)[i];
+    fseek(f_, (long)addr, SEEK_SET);
+    fwrite(cur.data(), 1, k, f_);
+    return k == n;
+  }
+
+  bool eraseSector(uint32_t addr) override {
+    if (dead_ || addr % hjournal::SECTOR_SIZE || addr >= size_) return false;
+    const size_t k = take(hjournal::SECTOR_SIZE);
+    std::vector<uint8_t> ff(k, 0xFF);
+    fseek(f_, (long)addr, SEEK_SET);
+    fwrite(ff.data(), 1, k, f_);
+    if (k < hjournal::SECTOR_SIZE) return false;
+    erases_[addr / hjournal::SECTOR_SIZE]++;
+    return true;
+  }
+
+private:
+  // bytes que llegan a la flash antes del corte
+  size_t take(size_t n) {
+    if (!armed_) return n;
+    if (n <= budget_) { budget_ -= (uint32_t)n; return n; }
+    const size_t k = budget_;
+    budget_ = 0;
+    dead_ = true;
+    return k;
+  }
+
+  FILE* f_ = nullptr;
+  uint32_t size_;
+  std::vector<uint32_t> erases_;
+  uint32_t budget_ = 0;
+  bool armed_ = false;
+  bool dead_ = false;
+};
+
+// ----------------- muestras -----------------
+// La muestra i lleva i en (dir, vel): el replay se verifica en orden exacto
+static void put(hjournal::Journal& j, uint32_t i) {
+  j.append((uint16_t)(i & 0xFFFF), (uint16_t)(i >> 16));
+}
+
+struct Collect {
+  uint32_t n = 0;
+  uint32_t first = 0;
+  uint32_t last = 0;
+  uint32_t jumps = 0;   // saltos != +1 entre muestras seguidas
+};
+
+static void onSample(uint16_t dir, uint16_t spd, void* ctx) {
+  Collect& c = *(Collect*)ctx;
+  const uint32_t i = ((uint32_t)spd << 16) | dir;
+  if (c.n == 0) c.first = i;
+  else if (i != c.last + 1) c.jumps++;
+  c.last = i;
+  c.n++;
+}
+
+// Reinicio: Journal nuevo sobre la misma flash, replay de hasta max.
+// cold = arranque después de estar apagado (power-on), no un reinicio breve.
+static Collect reboot(FileFlash& fl, hjournal::Journal& j, uint32_t max, bool cold = false) {
+  fl.powerOn();
+  j = hjournal::Journal();
+  Collect c;
+  if (j.begin(fl, cold)) j.replay(max, onSample, &c);
+  return c;
+}
+
+// Escribe muestras [from, to) como histTaskFn: append + prepare()
+static void feed(hjournal::Journal& j, uint32_t from, uint32_t to) {
+  for (uint32_t i = from; i < to; i++) {
+    put(j, i);
+    j.prepare();
+  }
+}
+
+int runChecks() {
+  int fails = 0;
+  static constexpr uint32_t DAY = 24u * 3600u;
+  static constexpr uint32_t SECTORS = 0x80000 / hjournal::SECTOR_SIZE;   // partición histlog
+
+  // 1) 24 h con prepare() en la tarea: ningún borrado cae en append(); restore medido
+  {
+    FileFlash fl(SECTORS);
+    hjournal::Journal j;
+    const bool ok = fl.ok() && j.begin(fl);
+    feed(j, 0, DAY);
+    j.flush();
+    fails += check(ok && j.stats().inline_erases == 0 && j.stats().write_errors == 0,
+                   "24 h con prepare(): sin borrados dentro de append()");
+
+    const auto t0 = std::chrono::steady_clock::now();
+    const Collect c = reboot(fl, j, DAY);
+    const auto t1 = std::chrono::steady_clock::now();
+    fails += check(c.n == DAY && c.first == 0 && c.last == DAY - 1 && c.jumps == 0,
+                   "restore 24 h completo y en orden");
+    printf("[journal] restore 24 h: %lu muestras, %lu paginas en %.2f ms\n",
+           (unsigned long)c.n, (unsigned long)((DAY + hjournal::SAMPLES_PER_PAGE - 1) / hjournal::SAMPLES_PER_PAGE),
+           std::chrono::duration<double, std::milli>(t1 - t0).count());
+  }
+
+  // 2) sin prepare() el borrado vuelve a append() (y sigue funcionando)
+  {
+    FileFlash fl(8);
+    hjournal::Journal j;
+    j.begin(fl);
+    for (uint32_t i = 0; i < 2000; i++) put(j, i);
+    const Collect c = reboot(fl, j, 2000);
+    fails += check(c.n == 2000 - 2000 % hjournal::SAMPLES_PER_PAGE && c.jumps == 0,
+                   "sin prepare(): borra en append()");
+  }
+
+  // 3) corte a mitad de las muestras, y 4) corte dentro del magic (último write)
+  const uint32_t cuts[] = { 100, hjournal::PAGE_SIZE - 2 + 1 };
+  const char* what[] = { "corte a mitad de pagina: se pierde solo esa pagina",
+                         "corte dentro del magic: se pierde solo esa pagina" };
+  for (int k = 0; k < 2; k++) {
+    FileFlash fl(SECTORS);
+    hjournal::Journal j;
+    j.begin(fl);
+    const uint32_t before = 40 * hjournal::SAMPLES_PER_PAGE + 7;   // página 40 a mitad de sector
+    feed(j, 0, before);
+    fl.cutAfter(cuts[k]);
+    for (uint32_t i = before; !fl.dead(); i++) put(j, i);          // la página 41 se corta
+
+    Collect c = reboot(fl, j, DAY);
+    bool ok = c.n == 40 * hjournal::SAMPLES_PER_PAGE && c.jumps == 0 && j.stats().bad_pages == 0;
+
+    // después del reinicio se sigue escribiendo y la cadena salta la página cortada
+    const uint32_t resume = 100000;
+    feed(j, resume, resume + 10 * hjournal::SAMPLES_PER_PAGE);
+    c = reboot(fl, j, DAY);
+    ok = ok && c.n == 50 * hjournal::SAMPLES_PER_PAGE && c.first == 0 &&
+         c.last == resume + 10 * hjournal::SAMPLES_PER_PAGE - 1 && c.jumps == 1 && j.stats().bad_pages == 1;
+    fails += check(ok, what[k]);
+  }
+
+  // 5) corte durante el borrado adelantado de un sector con datos viejos
+  {
+    static constexpr uint32_t SPP = hjournal::SAMPLES_PER_PAGE;
+    FileFlash fl(8);                                     // 128 páginas
+    hjournal::Journal j;
+    j.begin(fl);
+    feed(j, 0, 176 * SPP);                               // vuelta y media; sector 3 ya borrado
+    for (uint32_t i = 176 * SPP; i < 177 * SPP; i++) put(j, i);   // página 176 al sector 3
+    fl.cutAfter(hjournal::SECTOR_SIZE / 2);
+    j.prepare();                                         // borra el sector 4 y se corta a la mitad
+
+    // quedan las páginas 72..176: la mitad vieja del sector 4 sigue siendo válida
+    const Collect c = reboot(fl, j, DAY);
+    feed(j, 177 * SPP, 217 * SPP);
+    const Collect c2 = reboot(fl, j, DAY);
+    fails += check(c.n == (177 - 72) * SPP && c.first == 72 * SPP && c.jumps == 0 &&
+                   c2.last == 217 * SPP - 1 && c2.jumps == 0 && j.stats().bad_pages == 0,
+                   "corte durante prepare(): sector a medio borrar no rompe la cadena");
+  }
+
+  // 6) varias vueltas: replay acotado al pedido y desgaste parejo entre sectores
+  {
+    FileFlash fl(8);
+    hjournal::Journal j;
+    j.begin(fl);
+    const uint32_t total = 5 * 8 * hjournal::PAGES_PER_SECTOR * hjournal::SAMPLES_PER_PAGE;
+    feed(j, 0, total);
+    const Collect c = reboot(fl, j, 1000);
+    uint32_t lo = UINT32_MAX, hi = 0;
+    for (uint32_t e : fl.erases()) { lo = e < lo ? e : lo; hi = e > hi ? e : hi; }
+    fails += check(c.n == 1000 && c.last == total - 1 && c.jumps == 0 && hi - lo <= 1,
+                   "vueltas: replay acotado y desgaste parejo");
+  }
+
+  // 7) apagado largo: lo de antes de un arranque en frío no se reproduce;
+  //    los reinicios breves posteriores sí encadenan con la corrida en frío
+  {
+    static constexpr uint32_t SPP = hjournal::SAMPLES_PER_PAGE;
+    FileFlash fl(SECTORS);
+    hjournal::Journal j;
+    j.begin(fl);
+    feed(j, 0, 10 * SPP);
+    const Collect off = reboot(fl, j, DAY, true);          // power-on: nada de antes
+    feed(j, 10 * SPP, 15 * SPP);
+    const Collect warm = reboot(fl, j, DAY);               // reinicio breve: solo la corrida en frío
+    feed(j, 15 * SPP, 17 * SPP);
+    const Collect warm2 = reboot(fl, j, DAY);              // y la siguiente encadena
+    const bool runs = off.n == 0 && warm.n == 5 * SPP && warm.first == 10 * SPP && warm.jumps == 0 &&
+                      warm2.n == 7 * SPP && warm2.first == 10 * SPP && warm2.last == 17 * SPP - 1 &&
+                      warm2.jumps == 0;
+
+    // en frío sin llegar a escribir una página: la marca vacía igual corta
+    reboot(fl, j, DAY, true);
+    for (uint32_t i = 0; i < SPP / 2; i++) put(j, 17 * SPP + i);   // se pierde con el reinicio
+    const Collect lost = reboot(fl, j, DAY);
+    fails += check(runs && lost.n == 0 && j.stats().bad_pages == 0,
+                   "arranque en frio corta el replay; reinicios breves encadenan");
+  }
+
+  return fails;
+}
+
+} // namespace jhost
@@ -0,0 +1,13 @@
+#pragma once
+
+// ===================== Journal de historial en host =====================
+// hjournal::Journal sobre una flash de archivo con semántica NOR (escribir
+// solo baja bits, borrar por sector) y cortes de luz inyectados a mitad de
+// escritura o de borrado. Mide el restore de 24 h.
+
+namespace jhost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace jhost
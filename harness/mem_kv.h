@@ -0,0 +1,57 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+#include <map>
+#include <string>
+#include <vector>
+
+#include "config_store.h"
+
+// ===================== Kv en memoria (host) =====================
+// Reemplaza a Preferences para ConfigStore. Los getters tipados leen los
+// bytes guardados con set() (claves sueltas de la versión vieja).
+// failPuts = cuántos putBytes siguientes fallan (NVS llena / error de flash).
+class MemKv : public cfgstore::Kv {
+public:
+  bool begin(const char*, bool) override { return true; }
+  void end() override {}
+  bool isKey(const char* key) override { return m_.count(key) != 0; }
+  size_t getBytes(const char* key, void* buf, size_t len) override {
+    auto it = m_.find(key);
+    if (it == m_.end() || it->second.size() > len) return 0;
+    if (!it->second.empty()) memcpy(buf, it->second.data(), it->second.size());
+    return it->second.size();
+  }
+  size_t putBytes(const char* key, const void* buf, size_t len) override {
+    puts_++;
+    if (failPuts) { failPuts--; return 0; }
+    m_[key].assign((const uint8_t*)buf, (const uint8_t*)buf + len);
+    return len;
+  }
+  bool remove(const char* key) override { return m_.erase(key) != 0; }
+  int16_t getShort(const char* key, int16_t def) override { return get(key, def); }
+  float getFloat(const char* key, float def) override { return get(key, def); }
+  uint8_t getUChar(const char* key, uint8_t def) override { return get(key, def); }
+
+  template <typename T>
+  void set(const char* key, T v) {
+    m_[key].assign((const uint8_t*)&v, (const uint8_t*)&v + sizeof(v));
+  }
+
+  uint32_t puts() const { return puts_; }
+
+  uint32_t failPuts = 0;
+  std::map<std::string, std::vector<uint8_t>> m_;
+
+private:
+  template <typename T>
+  T get(const char* key, T def) {
+    auto it = m_.find(key);
+    if (it == m_.end() || it->second.size() != sizeof(T)) return def;
+    T v;
+    memcpy(&v, it->second.data(), sizeof(v));
+    return v;
+  }
+
+  uint32_t puts_ = 0;
+};
@@ -0,0 +1,401 @@
+#include "nmea_host.h"
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "nmea.h"
+
+namespace nhost {
+
+static int check(bool ok, const char* what) {
+  printf("[nmea] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+struct Rng {
+  uint32_t s;
+  uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+};
+
+// Entrada de pollIn() desde un string; lo que escribe tickOut() queda en out
+class FeedStream : public Stream {
+public:
+  size_t write(uint8_t c) override { out.push_back((char)c); return 1; }
+  int availableForWrite() override { return 4096; }
+  int available() override { return (int)(in.size() - pos); }
+  int read() override { return (pos < in.size()) ? (uint8_t)in[pos++] : -1; }
+  int peek() override { return (pos < in.size()) ? (uint8_t)in[pos] : -1; }
+
+  void load(const std::string& s) { in = s; pos = 0; }
+
+  std::string in;
+  size_t pos = 0;
+  std::string out;
+};
+
+// "$" + body + "*HH\r\n" con checksum calculado acá (no con checksumBody)
+static std::string line(const std::string& body, char start = '$') {
+  uint8_t cs = 0;
+  for (char c : body) cs ^= (uint8_t)c;
+  char tail[8];
+  snprintf(tail, sizeof(tail), "*%02X\r\n", cs);
+  return start + body + tail;
+}
+
+// Misma línea con el último dígito del checksum cambiado
+static std::string corrupt(std::string l) {
+  char& d = l[l.find('*') + 2];
+  d = (d == '0') ? '1' : '0';
+  return l;
+}
+
+// Alimenta todo y devuelve cuántas sentencias cerraron; guarda la última
+struct Fed {
+  uint32_t done = 0;
+  std::string talker, id;
+  std::vector<std::string> fields;
+};
+
+static Fed feed(nmea::Parser& p, const std::string& s) {
+  Fed f;
+  for (char c : s) {
+    if (!p.feed(c)) continue;
+    const nmea::Sentence& st = p.sentence();
+    f.done++;
+    f.talker = st.talker;
+    f.id = st.id;
+    f.fields.assign(st.field, st.field + st.nfields);
+  }
+  return f;
+}
+
+// ----------------- despacho -----------------
+struct Hits {
+  uint32_t wiMwv = 0, anyMwv = 0, pana = 0;
+  std::string panaArgs;
+};
+
+static void onWiMwv(const nmea::Sentence&, void* ctx) { ((Hits*)ctx)->wiMwv++; }
+static void onAnyMwv(const nmea::Sentence&, void* ctx) { ((Hits*)ctx)->anyMwv++; }
+static void onPana(const nmea::Sentence& s, void* ctx) {
+  Hits& h = *(Hits*)ctx;
+  h.pana++;
+  for (uint8_t i = 0; i < s.nfields; i++) h.panaArgs += std::string(i ? "|" : "") + s.field[i];
+}
+static void onNothing(const nmea::Sentence&, void*) {}
+
+static int checkDispatch() {
+  int fails = 0;
+  static FeedStream io;
+  static Hits hits;
+
+  nmea::Config nc;
+  nc.enabled_out = false;
+  nc.enabled_in = true;
+  nmea::begin(io, nc);
+
+  bool reg = nmea::onSentence("WI", "MWV", onWiMwv, &hits)
+          && nmea::onSentence(nullptr, "MWV", onAnyMwv, &hits)
+          && nmea::onSentence("P", "ANA", onPana, &hits);
+  reg = reg && !nmea::onSentence("WI", "TOOLNG", onNothing)     // id de 6
+            && !nmea::onSentence("WIX", "MWV", onNothing)       // talker de 3
+            && !nmea::onSentence("WI", "MWV", nullptr)
+            && !nmea::onSentence("WI", nullptr, onNothing);
+  uint8_t extra = 0;
+  while (nmea::onSentence("ZZ", "NOP", onNothing)) extra++;
+  fails += check(reg && extra == nmea::MAX_HANDLERS - 3, "onSentence: largos, nulls y tabla llena rechazados");
+
+  // todo de una vez: pollIn() drena todo lo disponible
+  const uint32_t un0 = nmea::inUnhandled();
+  const uint32_t cs0 = nmea::inParser().badChecksum();
+  io.load(line("WIMWV,045,R,12.5,N,A") + line("GPMWV,050,R,3.0,N,A") + line("PANA,CH,6")
+          + line("GPGGA,1,2,3") + corrupt(line("WIMWV,045,R,12.5,N,A")) + line("PANA,FAC,1.05"));
+  nmea::pollIn();
+  fails += check(io.available() == 0, "pollIn drena todos los bytes en una llamada");
+  fails += check(hits.wiMwv == 1 && hits.anyMwv == 2, "MWV: handler de WI y el de cualquier talker");
+  fails += check(hits.pana == 2 && hits.panaArgs == "CH|6FAC|1.05", "PANA: talker P, id ANA, campos");
+  fails += check(nmea::inUnhandled() - un0 == 1, "GGA sin handler cuenta como no despachada");
+  fails += check(nmea::inParser().badChecksum() - cs0 == 1, "checksum malo contado y no despachado");
+
+  // una sentencia partida entre dos pollIn()
+  const std::string l = line("PANA,OFF,-12");
+  io.load(l.substr(0, 7));
+  nmea::pollIn();
+  const uint32_t mid = hits.pana;
+  io.load(l.substr(7));
+  nmea::pollIn();
+  fails += check(mid == 2 && hits.pana == 3, "sentencia partida entre dos pollIn()");
+  return fails;
+}
+
+// ----------------- salida -----------------
+// Un tickOut() con MWV y suavizado vencidos; devuelve las líneas escritas
+static std::vector<std::string> tickLines(const nmea::Config& nc, const nmea::OutData& d) {
+  static FeedStream io;
+  io.out.clear();
+  shim::setMillis(50000);
+  nmea::begin(io, nc);
+  shim::setMillis(50000 + nc.out_period_ms);
+  nmea::tickOut(d);
+
+  std::vector<std::string> lines;
+  for (size_t a = 0, b; (b = io.out.find("\r\n", a)) != std::string::npos; a = b + 2)
+    lines.push_back(io.out.substr(a, b - a));
+  return lines;
+}
+
+static int checkOut() {
+  int fails = 0;
+  nmea::Config nc;
+  nc.enabled_out = true;
+  nc.baud = 38400;
+  nc.out_period_ms = 1000;
+  nc.smooth_period_ms = 1000;
+
+  nmea::OutData d;
+  d.dir_deg = 45.0f;          d.speed_kn = 12.5f;        d.valid = true;
+  d.dir_smooth_deg = 50.0f;   d.speed_smooth_kn = 10.0f; d.smooth_valid = false;
+
+  std::vector<std::string> l = tickLines(nc, d);
+  bool cs = true;
+  for (const std::string& x : l) cs = cs && nmea::validateLine(x.c_str());
+  fails += check(l.size() == 2 && cs
+                 && l[0].compare(0, 22, "$WIMWV,045,R,12.5,N,A*") == 0
+                 && l[1].compare(0, 22, "$IIMWV,050,R,10.0,N,V*") == 0,
+                 "MWV suavizado: talker II y A/V de smooth_valid, no de valid");
+
+  d.valid = false;
+  d.smooth_valid = true;
+  nc.smooth_talker = nullptr;
+  l = tickLines(nc, d);
+  fails += check(l.size() == 2 && l[0].compare(0, 22, "$WIMWV,045,R,12.5,N,V*") == 0
+                 && l[1].compare(0, 22, "$WIMWV,050,R,10.0,N,A*") == 0,
+                 "smooth_talker nullptr: mismo talker que el MWV relativo");
+  return fails;
+}
+
+// ----------------- al azar -----------------
+static std::string randBody(Rng& rng, size_t minLen) {
+  static const char* const ADDR[] = { "WIMWV", "GPRMC", "GPGGA", "PANA", "IIXDR", "HCHDG" };
+  std::string b = ADDR[rng.next() % 6];
+  const uint32_t nf = 1 + rng.next() % 12;
+  for (uint32_t k = 0; k < nf || b.size() < minLen; k++) {
+    b += ',';
+    const uint32_t len = rng.next() % 7;
+    for (uint32_t j = 0; j < len; j++) b += "0123456789.-ABCNSEW"[rng.next() % 19];
+  }
+  return b;
+}
+
+static int checkRandom() {
+  nmea::Parser p;
+  Rng rng { 0x4E3Au };
+  uint32_t wantOk = 0, wantBad = 0, wantOver = 0, wrong = 0;
+  std::string in;
+  std::vector<std::string> want;   // bodies que deben salir, en orden
+
+  for (uint32_t it = 0; it < 20000; it++) {
+    const uint32_t kind = rng.next() % 10;
+    if (kind == 0) {                                   // checksum malo
+      in += corrupt(line(randBody(rng, 0)));
+      wantBad++;
+    } else if (kind == 1) {                            // cortada antes del '*'
+      const std::string l = line(randBody(rng, 0));
+      in += l.substr(0, 1 + rng.next() % l.find('*'));
+    } else if (kind == 2) {                            // demasiado larga
+      in += line(randBody(rng, nmea::LINE_MAX));
+      wantOver++;
+    } else if (kind == 3) {                            // fin de línea y basura
+      in += "\r\n";
+      for (uint32_t j = rng.next() % 20; j; j--) in += "xyz*,\r\n09AF"[rng.next() % 12];
+    } else {
+      const std::string b = randBody(rng, 0);
+      if (b.size() + 1 >= nmea::LINE_MAX) continue;
+      in += line(b, (rng.next() & 7) ? '$' : '!');
+      want.push_back(b);
+      wantOk++;
+    }
+  }
+
+  size_t next = 0;
+  for (char c : in) {
+    if (!p.feed(c)) continue;
+    const nmea::Sentence& st = p.sentence();
+    std::string got = std::string(st.talker) + st.id;
+    for (uint8_t i = 0; i < st.nfields; i++) got += std::string(",") + st.field[i];
+    if (next >= want.size() || got != want[next]) wrong++;
+    next++;
+  }
+  char msg[120];
+  snprintf(msg, sizeof(msg), "20000 lineas al azar: ok %lu/%lu, cs malo %lu/%lu, largas %lu/%lu",
+           (unsigned long)p.okCount(), (unsigned long)wantOk, (unsigned long)p.badChecksum(),
+           (unsigned long)wantBad, (unsigned long)p.overflows(), (unsigned long)wantOver);
+  return check(wrong == 0 && next == want.size() && p.okCount() == wantOk
+               && p.badChecksum() == wantBad && p.overflows() == wantOver, msg);
+}
+
+int runChecks() {
+  int fails = 0;
+
+  {
+    nmea::Parser p;
+    Fed f = feed(p, line("WIMWV,045,R,12.5,N,A"));
+    fails += check(f.done == 1 && f.talker == "WI" && f.id == "MWV" && f.fields.size() == 5
+                   && f.fields[0] == "045" && f.fields[3] == "N" && f.fields[4] == "A",
+                   "MWV: talker, id y 5 campos");
+    f = feed(p, line("PANA,SCAL,0,0,5.0,4.6"));
+    fails += check(f.done == 1 && f.talker == "P" && f.id == "ANA" && f.fields.size() == 5,
+                   "propietaria PANA -> talker P, id ANA");
+    f = feed(p, line("GPGGA,,,"));
+    fails += check(f.done == 1 && f.fields.size() == 3 && f.fields[0].empty() && f.fields[2].empty(),
+                   "campos vacios");
+    std::string low = line("GPRMC,1,A");                // checksum 0x3B
+    low[low.find('*') + 2] = 'b';
+    f = feed(p, low);
+    fails += check(f.done == 1, "checksum en minusculas");
+    f = feed(p, line("IIXDR,U,12.3,V,BATT", '!'));
+    fails += check(f.done == 1 && f.id == "XDR", "arranque con '!'");
+  }
+
+  {
+    nmea::Parser p;
+    Fed f = feed(p, corrupt(line("WIMWV,045,R,12.5,N,A")));
+    uint32_t cs = p.badChecksum();
+    f.done += feed(p, "$WIMWV,045,R*G1\r\n").done;     // no hex
+    f.done += feed(p, "$WIMWV,045,R*5\r\n").done;      // un solo dígito
+    fails += check(f.done == 0 && cs == 1 && p.badChecksum() == 3 && p.okCount() == 0,
+                   "checksum malo / no hex / un digito: descartadas y contadas");
+  }
+
+  {
+    nmea::Parser p;
+    const Fed none = feed(p, "$WIMWV,045,R,12.5,N,A\r\n");                  // sin '*'
+    Fed f = feed(p, "$WIMWV,045,R,1" + line("WIMWV,046,R,12.5,N,A"));       // cortada + '$'
+    fails += check(none.done == 0 && f.done == 1 && f.fields[0] == "046"
+                   && p.badChecksum() == 0 && p.overflows() == 0,
+                   "sin checksum descartada; cortada resincroniza en el '$' siguiente");
+    f = feed(p, "basura*,12\r\n" + line("HCHDG,98.3,,,,"));
+    fails += check(f.done == 1 && f.id == "HDG" && f.fields.size() == 5, "basura antes del '$'");
+  }
+
+  {
+    nmea::Parser p;
+    // body máximo: LINE_MAX - 1 chars con el '\0' del '*'
+    std::string b = "GPTXT,";
+    while (b.size() < nmea::LINE_MAX - 1) b += 'x';
+    Fed f = feed(p, line(b));
+    const bool fits = f.done == 1 && p.overflows() == 0;
+    f = feed(p, line(b + "y"));
+    const bool over = f.done == 0 && p.overflows() == 1;
+    f = feed(p, line("WIMWV,045,R,12.5,N,A"));
+    fails += check(fits && over && f.done == 1, "95 chars entra, 96 desborda y la siguiente entra");
+
+    std::string many = "GPXXX";
+    for (int k = 0; k < nmea::MAX_FIELDS + 6; k++) many += ",1";
+    f = feed(p, line(many));
+    fails += check(f.done == 1 && f.fields.size() == nmea::MAX_FIELDS, "mas de MAX_FIELDS campos: se cortan en 24");
+  }
+
+  fails += check(nmea::validateLine(line("WIMWV,045,R,12.5,N,A").c_str())
+                 && nmea::validateLine(line("PANA,CH,6").c_str())
+                 && !nmea::validateLine(corrupt(line("PANA,CH,6")).c_str())
+                 && !nmea::validateLine("$*00")
+                 && !nmea::validateLine("$GPGGA,1*4") && !nmea::validateLine("GPGGA,1*4A"),
+                 "validateLine: bien, checksum malo, vacia, un digito, sin '$'");
+
+  fails += checkRandom();
+  fails += checkDispatch();
+  fails += checkOut();
+  return fails;
+}
+
+// ----------------- bench -----------------
+// Log de sentencias típicas (viento, GPS, rumbo, comandos) con ~2% malas
+static std::string makeLog(uint32_t kb) {
+  Rng rng { 0x106u };
+  std::string log;
+  char b[96];
+  while (log.size() < (size_t)kb * 1024) {
+    const uint32_t k = rng.next() % 5;
+    if (k == 0) snprintf(b, sizeof(b), "WIMWV,%03u,R,%u.%u,N,A", rng.next() % 360, rng.next() % 40, rng.next() % 10);
+    else if (k == 1) snprintf(b, sizeof(b), "GPRMC,123519,A,4807.038,N,01131.000,E,%03u.4,084.4,230394,003.1,W", rng.next() % 30);
+    else if (k == 2) snprintf(b, sizeof(b), "GPGGA,123519,4807.038,N,01131.000,E,1,08,0.9,%u.4,M,46.9,M,,", rng.next() % 600);
+    else if (k == 3) snprintf(b, sizeof(b), "HCHDG,%u.%u,,,4.0,E", rng.next() % 360, rng.next() % 10);
+    else snprintf(b, sizeof(b), "PANA,OFF,%d", (int)(rng.next() % 61) - 30);
+    log += (rng.next() % 50 == 0) ? corrupt(line(b)) : line(b);
+  }
+  return log;
+}
+
+// Camino anterior: línea a buffer, strchr + sscanf("%2x"), campos con strtok
+static uint32_t lineParse(const std::string& log) {
+  uint32_t ok = 0;
+  char line[96];
+  size_t n = 0;
+  for (char c : log) {
+    if (c != '\n') {
+      if (c != '\r' && n + 1 < sizeof(line)) line[n++] = c;
+      continue;
+    }
+    line[n] = 0;
+    n = 0;
+    const char* star = strchr(line, '*');
+    if (line[0] != '$' || !star || star - line < 2) continue;
+    uint8_t cs = 0;
+    for (const char* p = line + 1; p < star; ++p) cs ^= (uint8_t)*p;
+    unsigned got = 0;
+    if (sscanf(star + 1, "%2x", &got) != 1 || cs != (uint8_t)got) continue;
+    line[star - line] = 0;
+    char* save = nullptr;
+    for (char* t = strtok_r(line + 1, ",", &save); t; t = strtok_r(nullptr, ",", &save)) ok += (t[0] != 0);
+    ok++;
+  }
+  return ok;
+}
+
+static void onBench(const nmea::Sentence& s, void* ctx) { *(uint32_t*)ctx += s.nfields; }
+
+template <typename F>
+static double seconds(uint32_t reps, F fn) {
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t r = 0; r < reps; r++) fn();
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double>(t1 - t0).count();
+}
+
+void runBench(uint32_t kb) {
+  const std::string log = makeLog(kb);
+  uint32_t lines = 0;
+  for (char c : log) lines += (c == '\n');
+  const uint32_t reps = (uint32_t)(64u * 1024u * 1024u / log.size()) + 1;   // ~64 MB por variante
+  const double mb = (double)log.size() * reps / 1e6;
+  uint32_t sink = 0;
+
+  nmea::Parser p;
+  const double tp = seconds(reps, [&] { for (char c : log) sink += p.feed(c); });
+
+  static FeedStream io;
+  nmea::Config nc;
+  nc.enabled_out = false;
+  nc.enabled_in = true;
+  nmea::begin(io, nc);
+  nmea::onSentence(nullptr, "MWV", onBench, &sink);
+  nmea::onSentence("GP", "RMC", onBench, &sink);
+  nmea::onSentence("P", "ANA", onBench, &sink);
+  const double td = seconds(reps, [&] { io.load(log); nmea::pollIn(); });
+
+  const double tl = seconds(reps, [&] { sink += lineParse(log); });
+
+  printf("[nmea] log %lu B, %lu sentencias, %lu pasadas (%.0f MB por variante)\n",
+         (unsigned long)log.size(), (unsigned long)lines, (unsigned long)reps, mb);
+  printf("[nmea] Parser::feed      %7.1f MB/s  %6.2f M sentencias/s\n", mb / tp, lines * (double)reps / tp / 1e6);
+  printf("[nmea] pollIn+despacho   %7.1f MB/s  %6.2f M sentencias/s\n", mb / td, lines * (double)reps / td / 1e6);
+  printf("[nmea] linea+sscanf      %7.1f MB/s  %6.2f M sentencias/s (x%.1f mas lento que Parser)\n",
+         mb / tl, lines * (double)reps / tl / 1e6, tl / tp);
+  printf("[nmea] ok %lu, cs malo %lu (chk %lu)\n", (unsigned long)p.okCount(), (unsigned long)p.badChecksum(),
+         (unsigned long)(sink & 0xFFFF));
+}
+
+} // namespace nhost
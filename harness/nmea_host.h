@@ -0,0 +1,17 @@
+#pragma once
+#include <stdint.h>
+
+// ===================== Parser NMEA IN en host =====================
+// nmea::Parser byte a byte y el despacho de pollIn(): checksums malos,
+// sentencias cortadas y demasiado largas, resincronización y tabla de handlers.
+
+namespace nhost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+// MB/s y sentencias/s sobre un log NMEA de 'kb' KB: Parser, pollIn() con
+// despacho y la lectura por línea con sscanf que reemplazó
+void runBench(uint32_t kb);
+
+} // namespace nhost
@@ -0,0 +1,99 @@
+#include "peers_host.h"
+#include <stdio.h>
+#include <string.h>
+
+#include "peer_table.h"
+
+namespace phost {
+
+static int check(bool ok, const char* what) {
+  printf("[peer] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+// Mismo fabricante, 3 bytes bajos distintos (como los topes reales)
+static void macOf(uint32_t n, uint8_t mac[6]) {
+  const uint8_t m[6] = { 0x24, 0x6F, 0x28, (uint8_t)(n >> 16), (uint8_t)(n >> 8), (uint8_t)n };
+  memcpy(mac, m, 6);
+}
+
+static void packet(peers::Table& t, uint8_t id, uint32_t seq, uint32_t now) {
+  WindPacket p {};
+  p.seq = seq;
+  t.onPacket(id, p, now);
+}
+
+// Cada peer de la tabla se encuentra por su MAC con su propio id
+static bool allFound(const peers::Table& t) {
+  for (uint8_t id = 0; id < t.count(); id++) {
+    if (t.find(t.peer(id).mac) != id) return false;
+  }
+  return true;
+}
+
+int runChecks() {
+  int fails = 0;
+  uint8_t mac[6];
+
+  // 1) llena: la MAC nueva toma el id del más viejo (no primario ni preferido)
+  {
+    static peers::Table t;
+    for (uint32_t i = 0; i < peers::MAX_PEERS; i++) {
+      macOf(0x100 + i, mac);
+      const uint8_t id = t.findOrAdd(mac);
+      packet(t, id, 1, 1000 + i * 100);
+    }
+    // 0 = primario (primero en llegar); 1 preferido y el más viejo de todos
+    packet(t, 0, 2, 5000);
+    t.setPreferred(1);
+    for (uint8_t id = 2; id < peers::MAX_PEERS; id++) packet(t, id, 2, 6000 + id);
+    // el más viejo no protegido: id 2 (6002)
+    uint8_t victim[6];
+    memcpy(victim, t.peer(2).mac, 6);
+
+    macOf(0x999, mac);
+    const uint8_t id = t.findOrAdd(mac);
+    fails += check(id == 2 && t.find(victim) == peers::NONE && t.find(mac) == 2 &&
+                   t.primary() == 0 && t.preferred() == 1 && t.evictions() == 1 &&
+                   t.fullDrops() == 0 && t.peer(2).seq.rx == 0 && allFound(t),
+                   "tabla llena desaloja al mas viejo no primario/preferido");
+  }
+
+  // 2) los que nunca mandaron un paquete válido se van primero
+  {
+    static peers::Table t;
+    for (uint32_t i = 0; i < peers::MAX_PEERS; i++) {
+      macOf(0x200 + i, mac);
+      const uint8_t id = t.findOrAdd(mac);
+      if (i != 6) packet(t, id, 1, 100 + i);
+    }
+    macOf(0x2FF, mac);
+    fails += check(t.findOrAdd(mac) == 6 && allFound(t), "sin paquetes se desaloja primero");
+  }
+
+  // 3) muchas MACs de paso: la tabla sigue consistente y el primario no se va
+  {
+    static peers::Table t;
+    uint32_t now = 0;
+    bool ok = true;
+    macOf(0xABCDEF, mac);
+    const uint8_t prim = t.findOrAdd(mac);
+    packet(t, prim, 1, now);
+    for (uint32_t i = 0; i < 5000; i++) {
+      now += 7;
+      macOf((i * 2654435761u) >> 8, mac);
+      const uint8_t id = t.findOrAdd(mac);
+      if (id == peers::NONE) { ok = false; break; }
+      packet(t, id, i, now);
+      if ((i & 63) == 0) packet(t, prim, 2 + i, now);
+      if (!allFound(t) || t.primary() != prim) { ok = false; break; }
+    }
+    macOf(0xABCDEF, mac);
+    fails += check(ok && t.find(mac) == prim && t.count() == peers::MAX_PEERS && t.fullDrops() == 0,
+                   "5000 MACs de paso: slots consistentes, primario fijo");
+  }
+
+  return fails;
+}
+
+} // namespace phost
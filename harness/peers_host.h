@@ -0,0 +1,12 @@
+#pragma once
+
+// ===================== Tabla de transmisores en host =====================
+// peers::Table llena: desalojo del más viejo que no sea primario ni
+// preferido, y que los slots sigan encontrando a todos después.
+
+namespace phost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace phost
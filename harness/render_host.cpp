@@ -0,0 +1,344 @@
+#include "render_host.h"
+#include <Arduino.h>
+#include <U8g2lib.h>
+#include <stdio.h>
+#include <string.h>
+#include <chrono>
+
+#include "lcd_ui.h"
+#include "wind_hist.h"
+#include "frame_gate.h"
+#include "sched_wheel.h"
+
+namespace rhost {
+
+// ST7920 full buffer (mismo layout que U8G2_ST7920_128X64_F_SW_SPI);
+// los bytes del bus van a u8x8_byte_empty
+class HostLcd : public U8G2 {
+public:
+  HostLcd() : U8G2() {
+    u8g2_Setup_st7920_s_128x64_f(&u8g2, U8G2_R0, u8x8_byte_empty, u8x8_dummy_cb);
+  }
+};
+
+static constexpr uint8_t W = 128;
+static constexpr uint8_t H = 64;
+static constexpr uint16_t FB_BYTES = W / 8 * H;
+
+static HostLcd s_lcd;
+static hist::WindHistory s_hist;   // ~14 KB: estático, no en el stack
+static bool s_ready = false;
+
+// Historial sintético determinista: 3 h de muestras de 1 Hz
+static void setup() {
+  if (s_ready) return;
+  lcd_ui::begin(s_lcd);
+  for (uint32_t t = 0; t < 3 * 3600u; t++) {
+    const uint16_t dir = (uint16_t)((2100 + (t / 7) % 400 + (t % 13) * 5) % 3600);
+    const uint16_t spd = (uint16_t)(900 + (t % 240) * 4 + ((t % 37) < 5 ? 600 : 0));
+    s_hist.append(dir, spd);
+  }
+  s_ready = true;
+}
+
+// ===================== Entradas fijas por pantalla =====================
+// 'i' varía dirección/velocidad como lo harían frames sucesivos
+
+static WindPacket packet(uint32_t i) {
+  WindPacket p {};
+  p.magic = WIND_MAGIC;
+  p.version = WIND_VER;
+  p.seq = 4200 + i;
+  p.timestamp_ms = 123456 + i * 100;
+  p.angle_cdeg = (uint16_t)((23740 + i * 37) % 36000);
+  p.raw_angle = (uint16_t)((uint32_t)p.angle_cdeg * 4096u / 36000u);
+  p.pps_centi = 1480;
+  p.rpm_centi = 4440;
+  p.vbat_mV = 3910;
+  p.status = 0x0003;
+  return p;
+}
+
+static void drawMain(uint32_t i) {
+  const WindPacket p = packet(i);
+  lcd_ui::renderMain(&p, true, 40, p.angle_cdeg / 100.0f, 14.3f + (float)(i % 50) / 10.0f, -1.0f, "2m");
+}
+
+static void drawMainNok(uint32_t i) {
+  lcd_ui::renderMain(nullptr, false, 5000 + i, 0.0f, 0.0f, 0.4f);
+}
+
+static void drawDiag(uint32_t i) {
+  const WindPacket p = packet(i);
+
+  wstats::Mean avg;
+  avg.valid = true;
+  avg.dir_deg = 241.5f;
+  avg.spd_kn = 13.8f;
+  avg.n = 1200;
+
+  wstats::Extremes gl;
+  gl.valid = true;
+  gl.gust_kn = 19.4f;
+  gl.lull_kn = 8.1f;
+
+  seqtrk::Summary link;
+  link.tot.rx = 4200 + i;
+  link.tot.lost = 17;
+  link.tot.late = 3;
+  link.w10.expected = 100;
+  link.w10.got = 98;
+  link.w60.expected = 600;
+  link.w60.got = 591;
+  link.w10.hist[0] = 90;
+  link.w10.hist[2] = 8;
+  link.jitter_ms = 4;
+
+  lat::Summary ls;
+  ls.synced = true;
+  ls.offset_ms = 73210;
+  ls.drift_ppm = 12.5f;
+  ls.txToRx.p50 = 5;
+  ls.txToRx.p90 = 10;
+  ls.txToRx.p99 = 50;
+  ls.txToRx.n = 600;
+  ls.rxToLcd.p50 = 100;
+  ls.rxToLcd.p90 = 200;
+  ls.rxToLcd.p99 = 200;
+  ls.rxToLcd.n = 300;
+
+  lcd_ui::renderDiag(&p, true, 40, p.seq, p.status, "24:6F:28:AB:CD:EF", 2, 0, 5,
+                     avg, "2m", gl, link, ls);
+}
+
+static void drawPeers(uint32_t i) {
+  peers::Row rows[3] = {
+    { { 0x24, 0x6F, 0x28, 0xAB, 0xCD, 0xEF }, 4200 + i, 17, 2, 80, true, false },
+    { { 0x24, 0x6F, 0x28, 0x10, 0x22, 0x9A }, 1311, 240, 31, 12400, false, false },
+    { { 0x3C, 0x71, 0xBF, 0x01, 0x02, 0x03 }, 9, 0, 0, peers::NO_AGE, false, true },
+  };
+  lcd_ui::renderPeers(rows, 3, false, 0);
+}
+
+static lcd_ui::SettingsView settings() {
+  lcd_ui::SettingsView v;
+  v.dir_offset_deg = -12;
+  v.speed_factor = 1.07f;
+  v.speed_src = 0;
+  v.espnow_channel = 6;
+  v.macStr = "24:6F:28:AB:CD:EF";
+  v.avg_display = 2;
+  v.avg_nmea = 1;
+  return v;
+}
+
+static void drawMenu(uint32_t i) {
+  lcd_ui::renderMenu(lcd_ui::UiMode::MENU, (int)(i % 6), settings());
+}
+
+static void drawEdit(uint32_t i) {
+  lcd_ui::SettingsView v = settings();
+  v.dir_offset_deg = (int16_t)(-12 + (int)(i % 20));
+  lcd_ui::renderMenu(lcd_ui::UiMode::EDIT, 0, v);
+}
+
+static void drawHist10m(uint32_t i) {
+  if (i) s_hist.append((uint16_t)(2300 + i % 100), (uint16_t)(1000 + i % 300));
+  lcd_ui::renderHist10m(s_hist.h10m());
+}
+
+static void drawHist1h(uint32_t) {
+  lcd_ui::renderHistTier(s_hist.h1h(), "1 h");
+}
+
+static void drawHist24h(uint32_t) {
+  lcd_ui::renderHistTier(s_hist.h24h(), "24 h");
+}
+
+struct Screen {
+  const char* name;
+  void (*draw)(uint32_t i);
+};
+
+static const Screen SCREENS[] = {
+  { "main",     drawMain },
+  { "main_nok", drawMainNok },
+  { "diag",     drawDiag },
+  { "peers",    drawPeers },
+  { "menu",     drawMenu },
+  { "edit",     drawEdit },
+  { "hist10m",  drawHist10m },
+  { "hist1h",   drawHist1h },
+  { "hist24h",  drawHist24h },
+};
+
+// ===================== PBM =====================
+// P4: 1 bit por pixel, MSB = pixel izquierdo, 1 = negro. El buffer del
+// ST7920 (horizontal, MSB a la izquierda) ya tiene ese orden.
+
+static std::string toPbm(const uint8_t* fb) {
+  char hdr[24];
+  const int n = snprintf(hdr, sizeof(hdr), "P4\n%u %u\n", W, H);
+  std::string s(hdr, (size_t)n);
+  s.append((const char*)fb, FB_BYTES);
+  return s;
+}
+
+static bool readFile(const std::string& path, std::string& out) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char buf[1024];
+  size_t n;
+  out.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+static bool writeFile(const std::string& path, const std::string& s) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  fwrite(s.data(), 1, s.size(), f);
+  fclose(f);
+  return true;
+}
+
+static uint32_t diffPixels(const std::string& a, const std::string& b) {
+  if (a.size() != b.size()) return 0xFFFFFFFFu;
+  uint32_t n = 0;
+  for (size_t i = 0; i < a.size(); i++) n += (uint32_t)__builtin_popcount((uint8_t)(a[i] ^ b[i]));
+  return n;
+}
+
+int runSnapshots(const std::string& dir, bool update) {
+  setup();
+  int fails = 0;
+  for (const Screen& sc : SCREENS) {
+    sc.draw(0);
+    const std::string got = toPbm(s_lcd.getBufferPtr());
+    const std::string path = dir + "/ui_" + sc.name + ".pbm";
+
+    if (update) {
+      const bool ok = writeFile(path, got);
+      printf("[ui_%s] %s %s\n", sc.name, ok ? "golden escrito" : "NO se pudo escribir", path.c_str());
+      if (!ok) fails++;
+      continue;
+    }
+
+    std::string want;
+    if (!readFile(path, want)) {
+      printf("[ui_%s] FALTA golden %s (correr con --update)\n", sc.name, path.c_str());
+      fails++;
+    } else if (want != got) {
+      const std::string act = dir + "/ui_" + sc.name + ".actual.pbm";
+      writeFile(act, got);
+      printf("[ui_%s] DIFIERE del golden: %lu pixels (ver %s)\n", sc.name,
+             (unsigned long)diffPixels(want, got), act.c_str());
+      fails++;
+    } else {
+      printf("[ui_%s] OK\n", sc.name);
+    }
+  }
+  return fails;
+}
+
+void runBench(uint32_t frames) {
+  setup();
+  printf("[render] %lu frames por pantalla (host, sin bus; relativo entre pantallas)\n",
+         (unsigned long)frames);
+  for (const Screen& sc : SCREENS) {
+    uint32_t bytes = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < frames; i++) {
+      sc.draw(i);
+      bytes += lcd_ui::lastFlushBytes();
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / (double)frames;
+    printf("[render] %-9s %8.2f us/frame  flush %6.1f B/frame\n", sc.name, us,
+           (double)bytes / (double)frames);
+  }
+}
+
+// ===================== Gate de frames =====================
+
+struct GateSim {
+  fgate::Gate gate { fgate::Config { 200, 1000, 10000 } };
+  sched::Wheel wheel;
+  uint8_t job = sched::NONE;
+  // entradas de la pantalla en el instante simulado
+  bool ok = false;
+  float dir = 0.0f, spd = 0.0f;
+  // resultados
+  uint32_t drawn = 0, evals = 0;
+  double drawUs = 0.0;
+  uint32_t lastDrawMs = 0;
+};
+
+// Igual que frameChanged() de main.cpp para MAIN
+static void gateJob(uint32_t now, void* ctx) {
+  GateSim& g = *static_cast<GateSim*>(ctx);
+  fgate::Fingerprint f;
+  f.u32(0).u32(0).u32(g.ok ? 1 : 0).u32(2);
+  if (g.ok) f.u32(1).q(g.dir, 10.0f).q(g.spd, 100.0f);
+  f.i32(-1);
+  g.evals++;
+  if (g.gate.check(f.value(), now)) {
+    WindPacket p = packet(0);
+    const auto t0 = std::chrono::steady_clock::now();
+    lcd_ui::renderMain(g.ok ? &p : nullptr, g.ok, 0, g.dir, g.spd, -1.0f, "2m");
+    g.drawUs += std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - t0).count();
+    g.drawn++;
+    g.lastDrawMs = now;
+  }
+  g.wheel.setPeriod(g.job, g.gate.period());
+}
+
+int runGate() {
+  setup();
+  int fails = 0;
+  static GateSim g;
+  g.job = g.wheel.every(0, 200, gateJob, &g, "render");
+
+  struct Phase { const char* name; uint32_t ms; };
+  const Phase PH[] = { { "sin datos", 40000 }, { "viento estable", 40000 }, { "viento moviendose", 40000 } };
+
+  uint32_t now = 0;
+  for (uint8_t ph = 0; ph < 3; ph++) {
+    const uint32_t d0 = g.drawn, e0 = g.evals;
+    const double us0 = g.drawUs;
+    uint32_t firstChangeLag = 0;
+    const uint32_t end = now + PH[ph].ms;
+    bool changed = false;
+    while ((int32_t)(now - end) < 0) {
+      // muestras a 10 Hz: estable = misma media; moviéndose = cambia a cada muestra
+      g.ok = ph > 0;
+      if (ph == 1) { g.dir = 241.5f; g.spd = 13.8f; }
+      if (ph == 2) { g.dir = 241.5f + (float)((now / 100) % 50) * 0.3f; g.spd = 13.8f + (float)((now / 100) % 7) * 0.05f; }
+      const uint32_t before = g.drawn;
+      uint32_t wait = g.wheel.run(now);
+      if (!changed && g.drawn != before) {
+        changed = true;
+        firstChangeLag = now - (end - PH[ph].ms);
+      }
+      if (wait > 100 - now % 100) wait = 100 - now % 100;   // próxima muestra
+      now += wait;
+    }
+    const uint32_t dn = g.drawn - d0, ev = g.evals - e0;
+    // lo que costaría redibujar cada 200 ms al mismo costo por frame
+    const double fixedPh = (double)(PH[ph].ms / 200) * (g.drawUs - us0) / (double)(dn ? dn : 1);
+    printf("[gate] %-17s dibujados %4lu/%4lu  T=%4lums  1er frame %4lums  render %7.0f us (fijo 5 Hz: %7.0f)\n",
+           PH[ph].name, (unsigned long)dn, (unsigned long)ev, (unsigned long)g.gate.period(),
+           (unsigned long)firstChangeLag, g.drawUs - us0, fixedPh);
+
+    if (ph == 0 && !(dn <= 6 && g.gate.period() == 1000)) fails++;          // NOK quieto: 1 Hz y casi nada dibujado
+    if (ph == 1 && !(dn <= 6 && firstChangeLag <= 1000)) fails++;           // aparece el viento en <= 1 período lento
+    if (ph == 2 && !(dn >= 190 && g.gate.period() == 200)) fails++;         // se mueve: 5 Hz
+  }
+  const fgate::Stats& st = g.gate.stats();
+  printf("[gate] %s skip=%.0f%% (%lu/%lu)\n", fails ? "FALLA" : "OK", st.skipPct(),
+         (unsigned long)st.skipped, (unsigned long)st.frames);
+  return fails;
+}
+
+} // namespace rhost
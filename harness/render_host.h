@@ -0,0 +1,25 @@
+#pragma once
+#include <stdint.h>
+#include <string>
+
+// ===================== Render en host =====================
+// Los lcd_ui::render* dibujan en un U8G2 con el mismo framebuffer que el
+// ST7920 del equipo (128x64, 16x8 tiles) pero sin bus: sirve para medir
+// cada pantalla y para snapshots PBM contra harness/golden/.
+
+namespace rhost {
+
+// Snapshots de entradas fijas vs <dir>/ui_<pantalla>.pbm; con update los
+// reescribe. Si difiere deja <pantalla>.actual.pbm al lado. Devuelve fallas.
+int runSnapshots(const std::string& dir, bool update);
+
+// 'frames' renders por pantalla (entradas que cambian en cada frame, como
+// en el equipo) con flush de filas sucias incluido
+void runBench(uint32_t frames);
+
+// Pantalla MAIN con fgate::Gate y el job de render en sched::Wheel (reloj
+// virtual): sin datos, viento estable y viento moviéndose. Imprime frames
+// dibujados / salteados y tiempo de render contra el refresco fijo; devuelve fallas.
+int runGate();
+
+} // namespace rhost
@@ -0,0 +1,618 @@
+// Harness de replay en host (pio run -e native; .pio/build/native/program)
+//
+// Reproduce streams de WindPacket (sintéticos o capturados con la telemetría
+// binaria) a través del mismo camino que el equipo: validación de onRecv(),
+// ventana de seq, offset/calibración, promedios, historial y NMEA OUT.
+// El reloj es virtual (shim::setMillis), así que corre más rápido que real.
+//
+//   program                       chequeos y escenarios vs harness/golden/
+//   program --update              regenera los golden
+//   program --snapshots           además compara pantallas con ui_*.pbm (U8g2 real)
+//   program --capture cap.bin     replay de una captura ('b' por consola)
+//   program --bench 2000000       tasa máxima sostenible del pipeline
+//   program --decode-bench 1000000  decodificación v1 vs v2 (FrameReader)
+//   program --render-bench 2000   tiempo de render por pantalla (render_host)
+//   program --crc-bench 4096      CRC16: bit a bit vs tabla vs slicing-by-4 (crc_host)
+//   program --trig-bench 10000000  trig Q15/BAM vs libm (trig_host)
+//   program --fmt-bench 2000000   fmt::Writer vs snprintf (fmt_host)
+//   program --nmea-bench 64       parser NMEA IN sobre un log de 64 KB (nmea_host)
+//   program --stats-bench 3000000  promedios deslizantes por muestra (stats_host)
+//   program --golden DIR          otro directorio de golden
+//
+// Sale con 1 si algún escenario o pantalla no coincide con su golden.
+
+#include <Arduino.h>
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <chrono>
+#include <string>
+#include <vector>
+
+#include "wind_packet.h"
+#include "crc16_modbus.h"
+#include "wind_packet_v2.h"
+#include "rx_pipeline.h"
+#include "pipeline.h"
+#include "seq_track.h"
+#include "wind_stats.h"
+#include "wind_hist.h"
+#include "trig_q15.h"
+#include "nmea.h"
+#include "telemetry.h"
+#include "crc_host.h"
+#include "spsc_host.h"
+#include "flush_host.h"
+#include "trig_host.h"
+#include "fmt_host.h"
+#include "nmea_host.h"
+#include "render_host.h"
+#include "sched_host.h"
+#include "buttons_host.h"
+#include "calib_host.h"
+#include "stats_host.h"
+#include "journal_host.h"
+#include "config_host.h"
+#include "peers_host.h"
+
+// ===================== Stream de captura NMEA =====================
+class MemStream : public Stream {
+public:
+  size_t write(uint8_t c) override { out.push_back((char)c); return 1; }
+  size_t write(const uint8_t* b, size_t n) override { out.append((const char*)b, n); return n; }
+  int availableForWrite() override { return 4096; }
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+  std::string out;
+};
+
+// ===================== Tramas a reproducir =====================
+// Bytes de todas las tramas en un solo buffer (v2 llega a 250 B; el bench
+// genera millones): cada Frame apunta a su tramo.
+struct Frame {
+  uint32_t rx_ms;
+  uint32_t off;
+  uint8_t len;
+};
+
+struct Replay {
+  std::vector<Frame> frames;
+  std::vector<uint8_t> bytes;
+
+  Frame add(uint32_t rx_ms, const void* data, size_t len) {
+    Frame f { rx_ms, (uint32_t)bytes.size(), (uint8_t)len };
+    bytes.insert(bytes.end(), (const uint8_t*)data, (const uint8_t*)data + len);
+    return f;
+  }
+  const uint8_t* data(const Frame& f) const { return bytes.data() + f.off; }
+};
+
+static void sealPacket(WindPacket& p) {
+  p.crc16 = crc16_modbus((const uint8_t*)&p, sizeof(WindPacket) - sizeof(p.crc16));
+}
+
+// xorshift32: determinista en cualquier plataforma
+struct Rng {
+  uint32_t s;
+  uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+  bool chance(uint32_t ppm) { return (next() % 1000000u) < ppm; }
+  int32_t range(int32_t lo, int32_t hi) { return lo + (int32_t)(next() % (uint32_t)(hi - lo + 1)); }
+};
+
+// ===================== Escenarios sintéticos =====================
+struct Scenario {
+  const char* name;
+  uint32_t packets;       // muestras
+  uint32_t period_ms;     // período de muestreo del transmisor
+  uint32_t seed;
+  // impairments en ppm por trama
+  uint32_t loss, reorder, dup, crc, badlen;
+  uint8_t batch;          // muestras por trama: 1 = v1, > 1 = v2
+};
+
+static const Scenario SCENARIOS[] = {
+  { "clean_10hz",  9000, 100, 0x1234567u,     0,     0,     0,     0,    0,  1 },
+  { "lossy_10hz",  9000, 100, 0xBEEF01u,  50000, 20000, 10000, 10000, 5000,  1 },
+  { "burst_25hz", 22500,  40, 0xC0FFEEu,  20000, 50000, 20000,  2000, 2000,  1 },
+  { "v2_50hz",    45000,  20, 0x5EED50u,  20000, 20000, 10000,  5000, 5000, 10 },
+};
+
+// Viento que rola despacio y rachea; ruido de sensor
+static WindPacket sample(const Scenario& sc, uint32_t i, uint32_t tx, Rng& rng) {
+  const double t = (double)i * sc.period_ms / 1000.0;
+
+  WindPacket p {};
+  p.magic = WIND_MAGIC;
+  p.version = WIND_VER;
+  p.seq = i + 1;
+  p.timestamp_ms = tx;
+  int32_t ang = (int32_t)(18000.0 + 4000.0 * sin(t / 97.0)) + rng.range(-300, 300);
+  ang %= 36000;
+  if (ang < 0) ang += 36000;
+  p.angle_cdeg = (uint16_t)ang;
+  p.raw_angle = (uint16_t)((uint32_t)ang * 4096u / 36000u);
+  const double gust = (fmod(t, 37.0) < 4.0) ? 600.0 : 0.0;
+  int32_t pps = (int32_t)(1200.0 + 300.0 * sin(t / 23.0) + gust) + rng.range(-50, 50);
+  p.pps_centi = (uint16_t)(pps < 0 ? 0 : pps);
+  p.rpm_centi = (uint16_t)(p.pps_centi * 3u);
+  p.vbat_mV = 3900;
+  p.status = 0x0003;
+  return p;
+}
+
+static Replay synth(const Scenario& sc) {
+  Replay r;
+  std::vector<Frame>& v = r.frames;
+  v.reserve(sc.packets / sc.batch + sc.packets / sc.batch / 10);
+  Rng rng { sc.seed };
+
+  uint32_t rx = 1000;
+  uint32_t tx = 50000;          // reloj del transmisor, desfasado
+  wpv2::Builder b;
+  for (uint32_t i = 0; i < sc.packets; ) {
+    uint8_t buf[ESPNOW_MAX_LEN];
+    size_t len;
+    if (sc.batch <= 1) {
+      WindPacket p = sample(sc, i, tx, rng);
+      sealPacket(p);
+      memcpy(buf, &p, sizeof(p));
+      len = sizeof(p);
+      i++;
+      tx += sc.period_ms;
+      rx += sc.period_ms + (uint32_t)rng.range(0, 6);   // jitter de llegada
+    } else {
+      b.begin(i + 1, tx, (uint16_t)sc.period_ms, 3900, 0x0003, 0);
+      uint8_t n = 0;
+      for (; n < sc.batch && i < sc.packets; n++, i++) {
+        const WindPacket p = sample(sc, i, tx, rng);
+        if (!b.add(p.raw_angle, p.angle_cdeg, p.pps_centi, p.rpm_centi)) break;
+        tx += sc.period_ms;
+      }
+      len = b.finish();
+      memcpy(buf, b.data(), len);
+      rx += n * sc.period_ms + (uint32_t)rng.range(0, 6);
+    }
+
+    if (rng.chance(sc.loss)) continue;
+
+    if (rng.chance(sc.crc)) buf[rng.next() % (len - 8) + 4] ^= 0x5A;
+    if (rng.chance(sc.badlen)) len = (size_t)rng.range(4, (int32_t)len - 1);
+    const Frame f = r.add(rx, buf, len);
+
+    v.push_back(f);
+    if (rng.chance(sc.dup)) {
+      Frame d = f;
+      d.rx_ms += 1;
+      v.push_back(d);
+    }
+    // reorden: se intercambia con el anterior (mantiene los tiempos de llegada)
+    if (v.size() >= 2 && rng.chance(sc.reorder)) {
+      Frame& a = v[v.size() - 2];
+      Frame& c = v[v.size() - 1];
+      std::swap(a.off, c.off);
+      std::swap(a.len, c.len);
+    }
+  }
+  return r;
+}
+
+// Captura de telemetría binaria: cada RecPkt vuelve a ser una trama v1
+// válida (las muestras de una trama v2 se capturan con crc16 = 0)
+static bool loadCapture(const char* path, Replay& v) {
+  FILE* f = fopen(path, "rb");
+  if (!f) { perror(path); return false; }
+
+  std::vector<uint8_t> fr;
+  uint8_t rec[telem::MAX_REC];
+  int ch;
+  while ((ch = fgetc(f)) != EOF) {
+    if (ch != 0x00) {
+      if (fr.size() <= telem::MAX_FRAME) fr.push_back((uint8_t)ch);
+      continue;
+    }
+    const size_t m = fr.empty() ? 0 : telem::cobsDecode(fr.data(), fr.size(), rec, sizeof(rec));
+    fr.clear();
+    if (m != 1 + sizeof(telem::RecPkt) + 2 || rec[0] != telem::REC_PKT) continue;
+    if (crc16_modbus(rec, m - 2) != (uint16_t)(rec[m - 2] | (rec[m - 1] << 8))) continue;
+
+    telem::RecPkt r;
+    memcpy(&r, rec + 1, sizeof(r));
+    WindPacket p = r.pkt;
+    sealPacket(p);
+    v.frames.push_back(v.add(r.rx_ms, &p, sizeof(p)));
+  }
+  fclose(f);
+  return true;
+}
+
+// ===================== Pipeline (como onRecv + loop) =====================
+// La validación y la ventana de seq siguen a onRecv() (sin peers ni cola);
+// lo que hace loop() con cada muestra es pipeline::Processor, el mismo del equipo.
+class Pipeline {
+public:
+  explicit Pipeline(const AppConfig& cfg) : cfg_(cfg), proc_(2000) {   // NO_DATA_MS de config.h
+    cal_.compile(cfg);
+    nmea::Config nc;
+    nc.enabled_out = true;
+    nc.out_period_ms = 1000;
+    nc.smooth_period_ms = 1000;
+    nc.xdr_period_ms = 5000;
+    nc.baud = 4800;
+    nmea::begin(nmeaOut_, nc);
+  }
+
+  // onRecv(): validación + ventana de seq por muestra; processSample(): derivados
+  void feed(const uint8_t* data, uint8_t len, uint32_t rx_ms) {
+    shim::setMillis(rx_ms);
+
+    rxpipe::FrameReader frame;
+    const rxpipe::Verdict vd = frame.open(data, len);
+    if (vd != rxpipe::Verdict::OK) {
+      bad_[(int)vd]++;
+      return;
+    }
+
+    WindPacket pkt;
+    const uint32_t before = accepted_;
+    bool arrival = false;
+    while (frame.next(pkt)) {
+      const seqtrk::Kind k = link_.onPacket(pkt.seq, rx_ms);
+      if (k != seqtrk::Kind::DUP && k != seqtrk::Kind::OLD) arrival = true;
+      if (k == seqtrk::Kind::DUP || k == seqtrk::Kind::OLD || k == seqtrk::Kind::LATE) continue;
+
+      proc_.onSample(pkt, rx_ms, cal_);
+      accepted_++;
+    }
+
+    if (arrival) link_.onArrival(rx_ms);
+    if (accepted_ != before) tick(rx_ms);
+  }
+
+  // loop(): promedios, historial 1 Hz (jobHist), NMEA (jobNmea)
+  void tick(uint32_t now) {
+    shim::setMillis(now);
+    proc_.stats().advance(now);
+
+    if (!histStarted_) { histStarted_ = true; lastHist_ = now; }
+    if (now - lastHist_ >= 1000) {
+      lastHist_ = now;
+      uint16_t dd, sc;
+      if (proc_.closeSecond(dd, sc)) histN_++;
+    }
+
+    nmea::tickOut(proc_.nmeaOut(now, (wstats::Avg)cfg_.avg_nmea));
+  }
+
+  // Resumen determinista: es lo que se compara con el golden
+  std::string report() const {
+    std::string r;
+    char line[192];
+    const seqtrk::Summary ls = link_.summary();
+    snprintf(line, sizeof(line), "accepted=%lu badLen=%lu badMagic=%lu badCrc=%lu\n",
+             (unsigned long)accepted_, (unsigned long)bad_[1], (unsigned long)bad_[2], (unsigned long)bad_[3]);
+    r += line;
+    snprintf(line, sizeof(line), "seq rx=%lu lost=%lu late=%lu dup=%lu old=%lu wrap=%lu reset=%lu\n",
+             (unsigned long)ls.tot.rx, (unsigned long)ls.tot.lost, (unsigned long)ls.tot.late,
+             (unsigned long)ls.tot.dup, (unsigned long)ls.tot.old, (unsigned long)ls.tot.wrap,
+             (unsigned long)ls.tot.reset);
+    r += line;
+    // jitter por llegada de trama (las muestras de un v2 comparten la llegada)
+    snprintf(line, sizeof(line), "jitter J=%u J50=%u J90=%u (60s)\n", ls.jitter_ms,
+             ls.w60.jitterPctMs(50), ls.w60.jitterPctMs(90));
+    r += line;
+    for (uint8_t a = 0; a < (uint8_t)wstats::Avg::COUNT; a++) {
+      const wstats::Mean m = proc_.stats().mean((wstats::Avg)a);
+      snprintf(line, sizeof(line), "avg %-4s n=%lu dir=%.1f spd=%.2f\n", wstats::avgLabel((wstats::Avg)a),
+               (unsigned long)m.n, m.dir_deg, m.spd_kn);
+      r += line;
+    }
+    const wstats::Extremes gl = proc_.stats().gustLull();
+    snprintf(line, sizeof(line), "gust=%.2f lull=%.2f\n", gl.gust_kn, gl.lull_kn);
+    r += line;
+    const hist::WindHistory& wh = proc_.history();
+    const hist::Totals t = wh.h10m().totals();
+    snprintf(line, sizeof(line), "hist n=%lu 10m: n=%lu min=%u max=%u dir=%u 1h=%u 24h=%u\n",
+             (unsigned long)histN_, (unsigned long)t.n, t.min_spd, t.max_spd,
+             trig::toDdeg(trig::atan2Bam(t.sum_sin, t.sum_cos)),
+             wh.h1h().count, wh.h24h().count);
+    r += line;
+
+    // NMEA: largo, hash FNV-1a y última sentencia
+    uint32_t h = 2166136261u;
+    for (char c : nmeaOut_.out) { h ^= (uint8_t)c; h *= 16777619u; }
+    size_t lastStart = nmeaOut_.out.rfind('$');
+    std::string last = (lastStart == std::string::npos) ? "" : nmeaOut_.out.substr(lastStart);
+    while (!last.empty() && (last.back() == '\n' || last.back() == '\r')) last.pop_back();
+    snprintf(line, sizeof(line), "nmea bytes=%lu fnv=%08lx last=%s\n",
+             (unsigned long)nmeaOut_.out.size(), (unsigned long)h, last.c_str());
+    r += line;
+    return r;
+  }
+
+  uint32_t accepted() const { return accepted_; }
+
+private:
+  AppConfig cfg_;
+  calib::Tables cal_;
+  seqtrk::LinkStats link_;
+  pipeline::Processor proc_;
+  MemStream nmeaOut_;
+
+  uint32_t lastHist_ = 0;
+  bool histStarted_ = false;
+  uint32_t histN_ = 0;
+
+  uint32_t accepted_ = 0;
+  uint32_t bad_[4] = {};
+};
+
+static AppConfig scenarioConfig() {
+  AppConfig c;
+  c.dir_offset_deg = -12;
+  c.speed_factor = 1.07f;
+  c.speed_src = 0;
+  c.avg_nmea = (uint8_t)wstats::Avg::S3;
+  return c;
+}
+
+static std::string runFrames(const Replay& r) {
+  static Pipeline* p = nullptr;   // WindHistory es grande: fuera del stack
+  const std::vector<Frame>& frames = r.frames;
+  delete p;
+  // nmea::begin() planifica desde millis(): el reloj arranca en la 1ra trama
+  shim::setMillis(frames.empty() ? 0 : frames.front().rx_ms);
+  p = new Pipeline(scenarioConfig());
+  for (const Frame& f : frames) p->feed(r.data(f), f.len, f.rx_ms);
+  if (!frames.empty()) p->tick(frames.back().rx_ms + 1000);
+  return p->report();
+}
+
+// ===================== golden =====================
+static bool readFile(const std::string& path, std::string& out) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  char buf[1024];
+  size_t n;
+  out.clear();
+  while ((n = fread(buf, 1, sizeof(buf), f)) > 0) out.append(buf, n);
+  fclose(f);
+  return true;
+}
+
+static bool writeFile(const std::string& path, const std::string& s) {
+  FILE* f = fopen(path.c_str(), "wb");
+  if (!f) return false;
+  fwrite(s.data(), 1, s.size(), f);
+  fclose(f);
+  return true;
+}
+
+static int runScenarios(const std::string& dir, bool update) {
+  int fails = 0;
+  for (const Scenario& sc : SCENARIOS) {
+    const Replay frames = synth(sc);
+    const std::string got = runFrames(frames);
+    const std::string path = dir + "/" + sc.name + ".txt";
+
+    if (update) {
+      const bool ok = writeFile(path, got);
+      printf("[%s] %s %s\n", sc.name, ok ? "golden escrito" : "NO se pudo escribir", path.c_str());
+      if (!ok) fails++;
+      continue;
+    }
+
+    std::string want;
+    if (!readFile(path, want)) {
+      printf("[%s] FALTA golden %s (correr con --update)\n", sc.name, path.c_str());
+      fails++;
+    } else if (want != got) {
+      printf("[%s] DIFIERE del golden\n--- golden\n%s--- actual\n%s", sc.name, want.c_str(), got.c_str());
+      fails++;
+    } else {
+      printf("[%s] OK (%lu tramas)\n", sc.name, (unsigned long)frames.frames.size());
+    }
+  }
+  return fails;
+}
+
+// ===================== bench =====================
+// Tramas limpias a 100 Hz virtuales; mide solo el pipeline (no la generación)
+static void runBench(uint32_t n) {
+  Scenario sc { "bench", n, 10, 42u, 0, 0, 0, 0, 0, 1 };
+  const Replay r = synth(sc);
+  shim::setMillis(r.frames.front().rx_ms);
+  Pipeline* p = new Pipeline(scenarioConfig());
+
+  const auto t0 = std::chrono::steady_clock::now();
+  for (const Frame& f : r.frames) p->feed(r.data(f), f.len, f.rx_ms);
+  const auto t1 = std::chrono::steady_clock::now();
+
+  const double s = std::chrono::duration<double>(t1 - t0).count();
+  const size_t nf = r.frames.size();
+  printf("[bench] %lu tramas en %.3f s -> %.0f tramas/s (%.0f ns/trama), aceptadas=%lu\n",
+         (unsigned long)nf, s, (double)nf / s, s * 1e9 / (double)nf, (unsigned long)p->accepted());
+  printf("[bench] tiempo virtual %.1f min -> %.0fx tiempo real\n",
+         (double)n * 10 / 60000.0, ((double)n * 10 / 1000.0) / s);
+  delete p;
+}
+
+// ===================== WindPacket v2 =====================
+// Ida y vuelta Builder -> FrameReader con series que cruzan el norte, saltan
+// fuerte y llenan la trama; además, tramas cortadas / corruptas se rechazan.
+static int v2RoundTrip() {
+  Rng rng { 0xD17A2u };
+  uint32_t frames = 0, samples = 0, bytes = 0, fails = 0;
+  uint32_t seq = 1, ts = 777;
+
+  for (int it = 0; it < 2000; it++) {
+    const uint8_t want = (uint8_t)rng.range(1, 80);     // más de lo que entra
+    const int32_t step = (it % 5 == 0) ? 9000 : 400;     // saltos grandes a veces
+    wpv2::Builder b;
+    b.begin(seq, ts, 20, (uint16_t)rng.range(3000, 4200), (uint16_t)rng.next(), (uint16_t)it);
+
+    WindPacket in[255];
+    uint16_t ang = (uint16_t)rng.range(35000, 35999);   // arranca cerca del norte
+    uint16_t pps = (uint16_t)rng.range(0, 3000);
+    uint8_t n = 0;
+    while (n < want) {
+      WindPacket& p = in[n];
+      p.angle_cdeg = wpv2::wrapAdd(ang, rng.range(-step, step), wpv2::CDEG_MOD);
+      p.raw_angle = (uint16_t)((uint32_t)p.angle_cdeg * 4096u / 36000u);
+      p.pps_centi = (uint16_t)(pps + rng.range(-200, 200));   // puede dar la vuelta (uint16)
+      p.rpm_centi = (uint16_t)rng.next();
+      if (!b.add(p.raw_angle, p.angle_cdeg, p.pps_centi, p.rpm_centi)) break;
+      ang = p.angle_cdeg;
+      pps = p.pps_centi;
+      n++;
+    }
+    const size_t len = b.finish();
+    if (len > ESPNOW_MAX_LEN || n != b.count()) fails++;
+
+    rxpipe::FrameReader fr;
+    if (fr.open(b.data(), (int)len) != rxpipe::Verdict::OK || fr.count() != n) {
+      fails++;
+      continue;
+    }
+    WindPacket out;
+    for (uint8_t k = 0; k < n; k++) {
+      if (!fr.next(out) || out.seq != seq + k || out.timestamp_ms != ts + 20u * k ||
+          out.angle_cdeg != in[k].angle_cdeg || out.raw_angle != in[k].raw_angle ||
+          out.pps_centi != in[k].pps_centi || out.rpm_centi != in[k].rpm_centi ||
+          out.i2c_err_count != (uint16_t)it) {
+        fails++;
+        break;
+      }
+    }
+    if (fr.next(out)) fails++;
+
+    // cortada (el CRC tiene que fallar o la estructura no cerrar) y un bit flip
+    uint8_t bad[ESPNOW_MAX_LEN];
+    memcpy(bad, b.data(), len);
+    if (fr.open(bad, (int)len - 1 - (int)(rng.next() % 8)) == rxpipe::Verdict::OK) fails++;
+    bad[4 + rng.next() % (len - 4)] ^= (uint8_t)(1u << (rng.next() % 8));
+    if (fr.open(bad, (int)len) == rxpipe::Verdict::OK) fails++;
+
+    frames++;
+    samples += n;
+    bytes += (uint32_t)len;
+    seq += n;
+    ts += 20u * n;
+  }
+
+  printf("[v2] ida y vuelta %s: %lu tramas, %lu muestras, %.1f B/muestra (v1: %u)\n",
+         fails ? "FALLA" : "OK", (unsigned long)frames, (unsigned long)samples,
+         (double)bytes / (double)samples, (unsigned)sizeof(WindPacket));
+  if (fails) printf("[v2] %lu errores\n", (unsigned long)fails);
+  return fails ? 1 : 0;
+}
+
+// Decodificación sola (open + next de cada muestra), v1 contra v2
+static void runDecodeBench(uint32_t n) {
+  Scenario v1 { "dec_v1", 20000, 20, 7u, 0, 0, 0, 0, 0, 1 };
+  Scenario v2 { "dec_v2", 20000, 20, 7u, 0, 0, 0, 0, 0, 40 };
+  for (const Scenario* sc : { &v1, &v2 }) {
+    const Replay r = synth(*sc);
+    uint64_t got = 0;
+    uint32_t sink = 0;
+    const auto t0 = std::chrono::steady_clock::now();
+    for (uint32_t k = 0; k < n; k++) {
+      const Frame& f = r.frames[k % r.frames.size()];
+      rxpipe::FrameReader fr;
+      if (fr.open(r.data(f), f.len) != rxpipe::Verdict::OK) continue;
+      WindPacket p;
+      while (fr.next(p)) {
+        sink += p.angle_cdeg;
+        got++;
+      }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+    const double s = std::chrono::duration<double>(t1 - t0).count();
+    printf("[decode] %s: %lu tramas %.0f B/trama -> %.1f ns/trama, %.1f ns/muestra, %.1fM muestras/s (%lu)\n",
+           sc->name, (unsigned long)n, (double)r.bytes.size() / (double)r.frames.size(),
+           s * 1e9 / n, s * 1e9 / (double)got, (double)got / s / 1e6, (unsigned long)(sink & 1));
+  }
+}
+
+int main(int argc, char** argv) {
+  std::string golden = "harness/golden";
+  bool update = false;
+  bool snapshots = false;
+  const char* capture = nullptr;
+  uint32_t bench = 0;
+  uint32_t renderBench = 0;
+  uint32_t decodeBench = 0;
+  uint32_t crcBench = 0;
+  uint32_t trigBench = 0;
+  uint32_t fmtBench = 0;
+  uint32_t nmeaBench = 0;
+  uint32_t statsBench = 0;
+
+  for (int i = 1; i < argc; i++) {
+    if (!strcmp(argv[i], "--update")) update = true;
+    else if (!strcmp(argv[i], "--snapshots")) snapshots = true;
+    else if (!strcmp(argv[i], "--golden") && i + 1 < argc) golden = argv[++i];
+    else if (!strcmp(argv[i], "--capture") && i + 1 < argc) capture = argv[++i];
+    else if (!strcmp(argv[i], "--bench") && i + 1 < argc) bench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--decode-bench") && i + 1 < argc) decodeBench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--render-bench") && i + 1 < argc) renderBench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--crc-bench") && i + 1 < argc) crcBench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--trig-bench") && i + 1 < argc) trigBench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--fmt-bench") && i + 1 < argc) fmtBench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--nmea-bench") && i + 1 < argc) nmeaBench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else if (!strcmp(argv[i], "--stats-bench") && i + 1 < argc) statsBench = (uint32_t)strtoul(argv[++i], nullptr, 10);
+    else {
+      fprintf(stderr, "uso: %s [--update] [--snapshots] [--golden DIR] [--capture FILE] [--bench N] [--decode-bench N] [--render-bench N] [--crc-bench KB] [--trig-bench N] [--fmt-bench N] [--nmea-bench KB] [--stats-bench N]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  if (capture) {
+    Replay frames;
+    if (!loadCapture(capture, frames)) return 2;
+    printf("[capture] %lu paquetes\n%s", (unsigned long)frames.frames.size(), runFrames(frames).c_str());
+    return 0;
+  }
+  if (bench) {
+    runBench(bench);
+    return 0;
+  }
+  if (decodeBench) {
+    runDecodeBench(decodeBench);
+    return 0;
+  }
+  if (renderBench) {
+    rhost::runBench(renderBench);
+    return 0;
+  }
+  if (crcBench) {
+    mhost::runBench(crcBench);
+    return 0;
+  }
+  if (trigBench) {
+    thost::runBench(trigBench);
+    return 0;
+  }
+  if (fmtBench) {
+    ohost::runBench(fmtBench);
+    return 0;
+  }
+  if (nmeaBench) {
+    nhost::runBench(nmeaBench);
+    return 0;
+  }
+  if (statsBench) {
+    whost::runBench(statsBench);
+    return 0;
+  }
+  // Los ui_*.pbm tienen que salir del U8g2 real (acá no está): hasta tenerlos
+  // commiteados, las pantallas se comparan solo con --snapshots
+  const int ui = snapshots ? rhost::runSnapshots(golden, update) : 0;
+  const int fails = mhost::runChecks() + qhost::runChecks() + fhost::runChecks() + thost::runChecks()
+                  + ohost::runChecks() + nhost::runChecks()
+                  + v2RoundTrip() + shost::runChecks() + bhost::runChecks() + chost::runChecks()
+                  + whost::runChecks() + jhost::runChecks() + khost::runChecks() + phost::runChecks()
+                  + runScenarios(golden, update) + ui + rhost::runGate();
+  return fails ? 1 : 0;
+}
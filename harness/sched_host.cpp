@@ -0,0 +1,140 @@
+#include "sched_host.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <vector>
+
+#include "sched_wheel.h"
+
+namespace shost {
+
+struct Log {
+  std::vector<uint32_t> at;
+};
+
+static void record(uint32_t now, void* ctx) {
+  static_cast<Log*>(ctx)->at.push_back(now);
+}
+
+// Todas las corridas en t0 + k * period (fase fija), sin huecos
+static bool onPhase(const Log& l, uint32_t t0, uint32_t period, uint32_t tol) {
+  for (size_t k = 0; k < l.at.size(); k++) {
+    const uint32_t want = t0 + (uint32_t)k * period;
+    if (l.at[k] < want || l.at[k] - want > tol) return false;
+  }
+  return true;
+}
+
+static int check(bool ok, const char* what) {
+  printf("[sched] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+int runChecks() {
+  int fails = 0;
+
+  // 1) dormir exactamente lo que dice run(): todo en su deadline
+  {
+    sched::Wheel w;
+    Log a, b, c, d;
+    const uint32_t t0 = 1000;
+    w.every(t0, 10, record, &a, "10ms");
+    w.every(t0, 250, record, &b, "250ms", 3);
+    w.every(t0, 1000, record, &c, "1s");
+    w.every(t0, 5000, record, &d, "5s");          // más de una vuelta (256 ms)
+    uint32_t now = t0, wakes = 0;
+    while (now < t0 + 20000) {
+      now += w.run(now);
+      wakes++;
+    }
+    fails += check(a.at.size() == 2000 && onPhase(a, t0, 10, 0), "periodo 10 ms exacto");
+    fails += check(b.at.size() == 80 && onPhase(b, t0 + 3, 250, 0), "periodo 250 ms con fase");
+    fails += check(c.at.size() == 20 && onPhase(c, t0, 1000, 0) &&
+                   d.at.size() == 4 && onPhase(d, t0, 5000, 0), "jobs a mas de una vuelta");
+    fails += check(w.stats(0).overruns == 0 && w.stats(0).maxLateMs == 0, "sin overruns");
+    printf("[sched]       %lu despertares para %lu corridas\n", (unsigned long)wakes,
+           (unsigned long)(a.at.size() + b.at.size() + c.at.size() + d.at.size()));
+  }
+
+  // 2) despertares tarde 0..3 ms: la fase no deriva
+  {
+    sched::Wheel w;
+    Log a;
+    uint32_t rng = 12345;
+    w.every(0, 200, record, &a, "200ms");
+    uint32_t now = 0;
+    while (now < 60000) {
+      rng ^= rng << 13; rng ^= rng >> 17; rng ^= rng << 5;
+      now += w.run(now) + rng % 4;
+    }
+    fails += check(a.at.size() >= 299 && onPhase(a, 0, 200, 3) && w.stats(0).overruns == 0,
+                   "jitter de despertar sin deriva");
+  }
+
+  // 3) loop trabado 350 ms: un overrun, 3 periodos salteados, misma fase
+  {
+    sched::Wheel w;
+    Log a;
+    w.every(0, 100, record, &a, "100ms");
+    uint32_t now = 0;
+    while (now < 1000) now += w.run(now);
+    now += 350;                                   // render lento / flash
+    w.run(now);
+    const uint32_t after = now;
+    while (now < 3000) now += w.run(now);
+    const sched::JobStats& st = w.stats(0);
+    bool phase = true;
+    for (uint32_t t : a.at) if (t != after && t % 100 != 0) phase = false;
+    fails += check(st.overruns == 1 && st.skipped == 3 && st.maxLateMs == 350 && phase,
+                   "overrun saltea periodos y conserva la fase");
+  }
+
+  // 4) one-shot y cancel
+  {
+    sched::Wheel w;
+    Log a, b;
+    w.after(0, 730, record, &a, "once");
+    const uint8_t id = w.after(0, 900, record, &b, "cancelado");
+    uint32_t now = 0;
+    while (now < 2000) {
+      if (now >= 800) w.cancel(id);
+      now += w.run(now);
+    }
+    fails += check(a.at.size() == 1 && a.at[0] == 730 && b.at.empty() && !w.active(id),
+                   "one-shot y cancel");
+  }
+
+  // 5) setPeriod desde el propio job y kick desde otro
+  {
+    sched::Wheel w;
+    Log a;
+    struct Ctx { sched::Wheel* w; uint8_t id; Log* log; } c { &w, sched::NONE, &a };
+    c.id = w.every(0, 100, [](uint32_t now, void* p) {
+      Ctx& x = *static_cast<Ctx*>(p);
+      x.log->at.push_back(now);
+      x.w->setPeriod(x.id, x.log->at.size() < 3 ? 100 : 400);   // después de 3 corridas, más lento
+    }, &c, "adapt");
+    uint32_t now = 0;
+    while (now < 1500) {
+      if (now == 800) w.kick(c.id, now);             // p. ej. un botón
+      uint32_t wait = w.run(now);
+      if (now < 800 && now + wait > 800) wait = 800 - now;
+      now += wait;
+    }
+    // 0 100 200 | 600 | 800 (kick) 1200
+    const bool ok = a.at.size() == 6 && a.at[2] == 200 && a.at[3] == 600 && a.at[4] == 800 && a.at[5] == 1200;
+    fails += check(ok, "setPeriod y kick");
+  }
+
+  // 6) capacidad fija
+  {
+    sched::Wheel w;
+    Log a;
+    uint8_t last = 0;
+    for (uint8_t i = 0; i <= sched::MAX_JOBS; i++) last = w.every(0, 100 + i, record, &a, "x");
+    fails += check(last == sched::NONE, "tabla llena devuelve NONE");
+  }
+
+  return fails;
+}
+
+} // namespace shost
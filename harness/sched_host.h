@@ -0,0 +1,12 @@
+#pragma once
+
+// ===================== Scheduler en host =====================
+// sched::Wheel contra un reloj virtual: deadlines sin deriva, overruns,
+// one-shots, jobs a más de una vuelta de la rueda y despertares con jitter.
+
+namespace shost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace shost
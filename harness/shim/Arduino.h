@@ -0,0 +1,44 @@
+#pragma once
+// Stand-in mínimo de Arduino para el entorno native (harness/).
+// Solo lo que usan los módulos que se linkean en host: millis() con reloj
+// virtual, Print/Stream y min/max.
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <algorithm>
+
+using std::min;
+using std::max;
+
+// Reloj virtual: lo mueve el harness, no pasa tiempo real
+uint32_t millis();
+
+namespace shim {
+void setMillis(uint32_t ms);
+}
+
+class Print {
+public:
+  virtual ~Print() {}
+  virtual size_t write(uint8_t c) = 0;
+  virtual size_t write(const uint8_t* buf, size_t n) {
+    size_t k = 0;
+    while (k < n && write(buf[k])) k++;
+    return k;
+  }
+  virtual int availableForWrite() { return 0; }
+
+  size_t print(const char* s) { return write((const uint8_t*)s, strlen(s)); }
+  size_t printf(const char* fmt, ...) __attribute__((format(printf, 2, 3)));
+};
+
+class Stream : public Print {
+public:
+  virtual int available() = 0;
+  virtual int read() = 0;
+  virtual int peek() = 0;
+};
@@ -0,0 +1,19 @@
+#include "Arduino.h"
+
+static uint32_t s_ms = 0;
+
+uint32_t millis() { return s_ms; }
+
+namespace shim {
+void setMillis(uint32_t ms) { s_ms = ms; }
+}
+
+size_t Print::printf(const char* fmt, ...) {
+  char buf[256];
+  va_list ap;
+  va_start(ap, fmt);
+  const int n = vsnprintf(buf, sizeof(buf), fmt, ap);
+  va_end(ap);
+  if (n <= 0) return 0;
+  return write((const uint8_t*)buf, (size_t)n < sizeof(buf) ? (size_t)n : sizeof(buf) - 1);
+}
@@ -0,0 +1,110 @@
+#include "spsc_host.h"
+#include <stdio.h>
+#include <chrono>
+#include <memory>
+#include <thread>
+
+#include "spsc_queue.h"
+
+namespace qhost {
+
+static int check(bool ok, const char* what) {
+  printf("[spsc] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+// Del tamaño de RxSample: si el consumidor viera un elemento a medio
+// escribir, el chequeo no cerraría
+struct Item {
+  uint32_t seq;
+  uint32_t w[6];
+  uint32_t sum;
+};
+
+static Item make(uint32_t seq) {
+  Item it;
+  it.seq = seq;
+  it.sum = seq;
+  for (uint32_t k = 0; k < 6; k++) {
+    it.w[k] = seq * 2654435761u + k;
+    it.sum ^= it.w[k];
+  }
+  return it;
+}
+
+static bool intact(const Item& it) {
+  uint32_t s = it.seq;
+  for (uint32_t k = 0; k < 6; k++) s ^= it.w[k];
+  return s == it.sum;
+}
+
+struct Result {
+  uint32_t got = 0;
+  uint32_t order = 0;      // fuera de orden / duplicados / faltantes
+  uint32_t torn = 0;
+  uint32_t fullTries = 0;  // push() rechazados por cola llena (productor)
+  double secs = 0;
+};
+
+// N elementos; el productor reintenta si está llena (cuenta cada rechazo),
+// el consumidor alterna pop() y popBatch()
+template <uint32_t CAP>
+static Result run(uint32_t n, bool batch) {
+  std::unique_ptr<SpscQueue<Item, CAP>> qp(new SpscQueue<Item, CAP>());
+  SpscQueue<Item, CAP>& q = *qp;
+  Result r;
+
+  const auto t0 = std::chrono::steady_clock::now();
+  std::thread prod([&] {
+    for (uint32_t i = 0; i < n; i++) {
+      const Item it = make(i);
+      while (!q.push(it)) {
+        r.fullTries++;
+        std::this_thread::yield();
+      }
+    }
+  });
+
+  uint32_t expect = 0;
+  Item buf[8];
+  while (expect < n) {
+    size_t k = 0;
+    if (batch && (expect & 1)) k = q.popBatch(buf, 8);
+    else if (q.pop(buf[0])) k = 1;
+    if (k == 0) {
+      std::this_thread::yield();
+      continue;
+    }
+    for (size_t i = 0; i < k; i++) {
+      if (!intact(buf[i])) r.torn++;
+      if (buf[i].seq != expect) r.order++;
+      expect = buf[i].seq + 1;
+      r.got++;
+    }
+  }
+  prod.join();
+  r.secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+
+  if (q.size() != 0 || q.overflowCount() != r.fullTries) r.order++;
+  return r;
+}
+
+int runChecks() {
+  int fails = 0;
+  const uint32_t N = 2000000;
+
+  const Result a = run<128>(N, false);
+  fails += check(a.got == N && a.order == 0 && a.torn == 0, "2 threads, pop(): orden y contenido");
+  const Result b = run<128>(N, true);
+  fails += check(b.got == N && b.order == 0 && b.torn == 0, "2 threads, pop()+popBatch()");
+  // cola chica: se llena todo el tiempo, overflowCount() = rechazos del productor
+  const Result c = run<4>(N / 4, true);
+  fails += check(c.got == N / 4 && c.order == 0 && c.torn == 0 && c.fullTries > 0,
+                 "cola de 4 siempre llena: overflow contado");
+
+  printf("[spsc]       %.1f M elementos/s (cap 128), %lu rechazos con cap 4\n",
+         (double)N / a.secs / 1e6, (unsigned long)c.fullTries);
+  return fails;
+}
+
+} // namespace qhost
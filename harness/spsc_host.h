@@ -0,0 +1,12 @@
+#pragma once
+
+// ===================== Cola SPSC en host =====================
+// SpscQueue con un productor y un consumidor en threads reales: orden,
+// nada perdido ni duplicado, elementos sin romper y overflow contado.
+
+namespace qhost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+} // namespace qhost
@@ -0,0 +1,104 @@
+#include "stats_host.h"
+#include <stdio.h>
+#include <stdint.h>
+#include <chrono>
+
+#include "wind_stats.h"
+
+namespace whost {
+
+static int check(bool ok, const char* what) {
+  printf("[stats] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+// 10 min a 10 Hz con advance() en cada muestra, como loop()
+static void fill(wstats::WindStats& w, uint32_t end_ms) {
+  for (uint32_t t = end_ms - 600000u + 100u; t <= end_ms; t += 100u) {
+    w.add(t, (uint16_t)(18000 + (t / 100) % 700), (uint16_t)(1200 + (t / 100) % 300));
+    w.advance(t);
+  }
+}
+
+int runChecks() {
+  int fails = 0;
+
+  // 1) muestra 1 ms atrás del último advance: se suma, no vacía las ventanas
+  {
+    static wstats::WindStats w;
+    fill(w, 600000);
+    w.advance(600000);
+    const uint32_t n10 = w.mean(wstats::Avg::M10).n;
+    const uint32_t n2 = w.mean(wstats::Avg::M2).n;
+    const uint32_t n3 = w.mean(wstats::Avg::S3).n;
+    w.add(599999, 18000, 1500);
+    const bool ok = w.mean(wstats::Avg::M10).n == n10 + 1 && w.mean(wstats::Avg::M2).n == n2 + 1 &&
+                    w.mean(wstats::Avg::S3).n == n3 + 1;
+    fails += check(ok, "muestra tardia entra al bucket actual");
+  }
+
+  // 2) ráfaga / calma: la misma muestra tardía cruzando el segundo no borra 10 min
+  {
+    static wstats::WindStats w;
+    fill(w, 600000);
+    w.advance(600000);
+    const wstats::Extremes before = w.gustLull();
+    w.add(599999, 18000, 1500);
+    const wstats::Extremes after = w.gustLull();
+    fails += check(before.valid && after.valid && after.gust_kn >= before.gust_kn &&
+                   after.lull_kn <= before.lull_kn && after.gust_kn - after.lull_kn > 1.0f,
+                   "rafaga/calma con muestra tardia");
+  }
+
+  // 3) salto grande hacia atrás (reinicio de la fuente de tiempo): ventanas desde cero
+  {
+    static wstats::WindStats w;
+    fill(w, 600000);
+    w.add(100000, 18000, 1500);
+    fails += check(w.mean(wstats::Avg::M10).n == 1 &&
+                   w.gustLull().gust_kn == w.gustLull().lull_kn, "salto grande hacia atras reinicia");
+  }
+
+  // 4) 10 min a 250 paquetes/s: 150k muestras en m10, velocidad alta y
+  //    direcciones 40°/50° alternadas (con n uint16 / sumas int32 desbordaba)
+  {
+    static wstats::WindStats w;
+    uint32_t k = 0;
+    for (uint32_t t = 4; t <= 600000u; t += 4u, k++) {
+      w.add(t, (k & 1) ? 5000 : 4000, 65000);
+      w.advance(t);
+    }
+    const wstats::Mean m = w.mean(wstats::Avg::M10);
+    const wstats::Mean m2 = w.mean(wstats::Avg::M2);
+    char what[112];
+    snprintf(what, sizeof(what), "m10 a 250 paq/s: n=%lu, %.2f kn, %.1f grados",
+             (unsigned long)m.n, m.spd_kn, m.dir_deg);
+    fails += check(m.valid && m.n > 140000 && m.spd_kn == 650.0f && m.dir_deg == 45.0f
+                   && m2.n > 29000 && m2.spd_kn == 650.0f && m2.dir_deg == 45.0f, what);
+  }
+
+  return fails;
+}
+
+// ----------------- bench -----------------
+void runBench(uint32_t n) {
+  static wstats::WindStats w;
+  uint32_t acc = 0;
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; i++) {
+    const uint32_t t = i * 20u;                      // 50 paquetes/s
+    w.add(t, (uint16_t)((i * 7919u) % 36000u), (uint16_t)(800 + (i * 31u) % 1200u));
+    w.advance(t);
+    if ((i & 15) == 0) acc += w.mean(wstats::Avg::M10).n;
+  }
+  const auto t1 = std::chrono::steady_clock::now();
+  const double ns = std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+
+  const wstats::Mean m = w.mean(wstats::Avg::M10);
+  printf("[stats] %lu muestras a 50 Hz (%.1f min virtuales)\n", (unsigned long)n, n / 3000.0);
+  printf("[stats] add+advance %6.1f ns/muestra (mean(M10) cada 16)\n", ns);
+  printf("[stats] m10 n=%lu %.2f kn %.1f grados (chk %lu)\n", (unsigned long)m.n, m.spd_kn, m.dir_deg,
+         (unsigned long)(acc & 0xFFFF));
+}
+
+} // namespace whost
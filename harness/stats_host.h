@@ -0,0 +1,18 @@
+#pragma once
+
+#include <stdint.h>
+
+// ===================== Promedios en host =====================
+// wstats::WindStats con muestras que llegan apenas atrás del último
+// advance(now) (onRecv estampa entre drainRx() y millis() en loop()),
+// y la ventana de 10 min llena a tasa alta (v2).
+
+namespace whost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+// ns por muestra de add()+advance() como en loop(), a n muestras
+void runBench(uint32_t n);
+
+} // namespace whost
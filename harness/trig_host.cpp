@@ -0,0 +1,189 @@
+#include "trig_host.h"
+#include <math.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <chrono>
+
+#include "trig_q15.h"
+
+namespace thost {
+
+static int check(bool ok, const char* what) {
+  printf("[trig] %s %s\n", ok ? "OK   " : "FALLA", what);
+  return ok ? 0 : 1;
+}
+
+struct Rng {
+  uint32_t s;
+  uint32_t next() { s ^= s << 13; s ^= s >> 17; s ^= s << 5; return s; }
+};
+
+static constexpr double BAM_RAD = M_PI / 32768.0;
+
+// error de atan2Bam en BAM contra atan2 double (con wrap)
+static double atanErr(int32_t y, int32_t x) {
+  const double want = atan2((double)y, (double)x) / BAM_RAD;
+  return fabs(remainder((double)trig::atan2Bam(y, x) - want, 65536.0));
+}
+
+// flecha como la hacía renderMain() con cosf/sinf (antes de trig_q15)
+static void arrowF(int cx, int cy, float deg, int r, trig::Pt out[3]) {
+  const float a = (deg - 90.0f) * 3.14159265359f / 180.0f;
+  const float tipLen = (float)(r - 1), w = 2.5f;
+  const float ap = a + 1.57079632679f;
+  out[0] = { (int16_t)(cx + (int)(cosf(a) * tipLen)), (int16_t)(cy + (int)(sinf(a) * tipLen)) };
+  out[1] = { (int16_t)(cx + (int)(cosf(ap) * w)), (int16_t)(cy + (int)(sinf(ap) * w)) };
+  out[2] = { (int16_t)(cx - (int)(cosf(ap) * w)), (int16_t)(cy - (int)(sinf(ap) * w)) };
+}
+
+int runChecks() {
+  int fails = 0;
+  char line[96];
+
+  // sin/cos: los 65536 ángulos
+  double errS = 0;
+  for (uint32_t a = 0; a < 65536; a++) {
+    const double es = fabs(trig::sinQ15((trig::angle_t)a) - 32767.0 * sin(a * BAM_RAD));
+    const double ec = fabs(trig::cosQ15((trig::angle_t)a) - 32767.0 * cos(a * BAM_RAD));
+    if (es > errS) errS = es;
+    if (ec > errS) errS = ec;
+  }
+  snprintf(line, sizeof(line), "sin/cos 65536 angulos: error max %.4f LSB <= 1.03", errS);
+  fails += check(errS <= 1.03, line);
+  fails += check(trig::sinQ15(0) == 0 && trig::sinQ15(trig::BAM_90) == 32767
+                 && trig::sinQ15(trig::BAM_180) == 0 && trig::sinQ15(49152) == -32767,
+                 "sin exacto en 0/90/180/270");
+
+  // atan2: círculo de radio 256 (el mínimo de la cota) y vectores al azar
+  // de todo el rango int32
+  double errA = 0;
+  for (uint32_t a = 0; a < 65536; a++) {
+    const int32_t x = (int32_t)lround(256.0 * cos(a * BAM_RAD));
+    const int32_t y = (int32_t)lround(256.0 * sin(a * BAM_RAD));
+    const double e = atanErr(y, x);
+    if (e > errA) errA = e;
+  }
+  Rng rng { 0xA7A2u };
+  for (uint32_t it = 0; it < 2000000; it++) {
+    const int shift = (int)(rng.next() % 24);           // |v| de 2^8 a 2^31
+    const int32_t x = (int32_t)rng.next() >> shift;
+    const int32_t y = (int32_t)rng.next() >> shift;
+    if ((double)x * x + (double)y * y < 256.0 * 256.0) continue;
+    const double e = atanErr(y, x);
+    if (e > errA) errA = e;
+  }
+  snprintf(line, sizeof(line), "atan2Bam |v| >= 256: error max %.4f BAM <= 1", errA);
+  fails += check(errA <= 1.0, line);
+  fails += check(trig::atan2Bam(0, 0) == 0 && trig::atan2Bam(0, 5) == 0
+                 && trig::atan2Bam(5, 0) == trig::BAM_90 && trig::atan2Bam(0, -5) == trig::BAM_180
+                 && trig::atan2Bam(-5, 0) == 49152 && atanErr(INT32_MIN, INT32_MIN) <= 1.0,
+                 "atan2Bam ejes, (0,0) e INT32_MIN");
+
+  // atan2Bam64: vectores int32 corridos hasta 2^31 más arriba dan el mismo ángulo
+  uint32_t bad64 = 0;
+  for (int i = 0; i < 100000; i++) {
+    const int32_t x = (int32_t)rng.next() >> 1, y = (int32_t)rng.next() >> 1;
+    const int sh = (int)(rng.next() % 32);
+    const int d = (int16_t)(trig::atan2Bam64(y * ((int64_t)1 << sh), x * ((int64_t)1 << sh)) - trig::atan2Bam(y, x));
+    if (d > 1 || d < -1) bad64++;
+  }
+  fails += check(bad64 == 0 && trig::atan2Bam64(INT64_MIN / 2, 0) == 49152 && trig::atan2Bam64(0, 0) == 0,
+                 "atan2Bam64 = atan2Bam del vector escalado (+-1 BAM)");
+
+  // conversiones de ida y vuelta
+  uint32_t badConv = 0;
+  for (uint32_t d = 0; d < 3600; d++) {
+    if (trig::toDdeg(trig::fromDdeg(d)) != d) badConv++;
+    if (trig::toDdeg(trig::fromCdeg(d * 10)) != d) badConv++;
+    if (trig::toDdeg(trig::fromDegF(d / 10.0f)) != d) badConv++;
+  }
+  fails += check(badConv == 0, "toDdeg(fromDdeg/fromCdeg/fromDegF) = identidad");
+
+  // flechas de renderMain (r=31) y de un radio menor (r=22) contra cosf/sinf:
+  // iguales en los cardinales, a lo sumo 1 px donde el float trunca x.9999
+  uint32_t diffArrow = 0, badArrow = 0;
+  for (int r = 22; r <= 31; r += 9) {
+    for (uint32_t d = 0; d < 3600; d++) {
+      trig::Pt q[3], f[3];
+      trig::arrow(64, 38, trig::fromDegF(d / 10.0f), (r - 1) * 16, 40, q);
+      arrowF(64, 38, d / 10.0f, r, f);
+      bool diff = false;
+      for (int k = 0; k < 3; k++) {
+        const int ex = abs(q[k].x - f[k].x), ey = abs(q[k].y - f[k].y);
+        if (ex || ey) diff = true;
+        if (ex > 1 || ey > 1 || ((ex || ey) && d % 900 == 0)) badArrow++;
+      }
+      if (diff) diffArrow++;
+    }
+  }
+  snprintf(line, sizeof(line), "flecha vs float: cardinales iguales, resto <= 1 px (%lu de 7200 distintas)",
+           (unsigned long)diffArrow);
+  fails += check(badArrow == 0, line);
+
+  // media circular: VecSum contra la media double de los mismos ángulos
+  double errM = 0;
+  for (uint32_t it = 0; it < 2000; it++) {
+    trig::VecSum v;
+    double s = 0, c = 0;
+    const uint32_t center = rng.next() & 0xFFFF, n = 1 + rng.next() % 600;
+    for (uint32_t k = 0; k < n; k++) {
+      const trig::angle_t a = (trig::angle_t)(center + (int32_t)(rng.next() % 16384) - 8192);
+      v.add(a);
+      s += sin(a * BAM_RAD);
+      c += cos(a * BAM_RAD);
+    }
+    const double e = fabs(remainder((double)v.mean() - atan2(s, c) / BAM_RAD, 65536.0));
+    if (e > errM) errM = e;
+  }
+  snprintf(line, sizeof(line), "VecSum.mean() vs double: error max %.2f BAM (%.3f grados)",
+           errM, errM * 360.0 / 65536.0);
+  fails += check(errM <= 8.0, line);
+  return fails;
+}
+
+// ----------------- bench -----------------
+template <typename T, typename F>
+static double nsPerOp(uint32_t n, T& acc, F fn) {
+  const auto t0 = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < n; i++) acc += fn(i);
+  const auto t1 = std::chrono::steady_clock::now();
+  return std::chrono::duration<double, std::nano>(t1 - t0).count() / n;
+}
+
+void runBench(uint32_t n) {
+  int32_t acc = 0;
+  float accF = 0;
+
+  const double sf = nsPerOp(n, accF, [](uint32_t i) {
+    const float a = (float)(i * 40503u & 0xFFFF) * (6.2831853f / 65536.0f);
+    return sinf(a) + cosf(a);
+  });
+  const double sq = nsPerOp(n, acc, [](uint32_t i) {
+    const trig::angle_t a = (trig::angle_t)(i * 40503u);
+    return (int32_t)trig::sinQ15(a) + trig::cosQ15(a);
+  });
+  const double af = nsPerOp(n, accF, [](uint32_t i) {
+    return atan2f((float)(int32_t)(i * 2654435761u), (float)(int32_t)(i * 40503u + 7));
+  });
+  const double aq = nsPerOp(n, acc, [](uint32_t i) {
+    return (int32_t)trig::atan2Bam((int32_t)(i * 2654435761u), (int32_t)(i * 40503u + 7));
+  });
+  const double rf = nsPerOp(n, acc, [](uint32_t i) {
+    trig::Pt t[3];
+    arrowF(64, 38, (float)(i % 3600) * 0.1f, 31, t);
+    return t[0].x + t[1].y + t[2].x;
+  });
+  const double rq = nsPerOp(n, acc, [](uint32_t i) {
+    trig::Pt t[3];
+    trig::arrow(64, 38, trig::fromDegF((float)(i % 3600) * 0.1f), 30 * 16, 40, t);
+    return t[0].x + t[1].y + t[2].x;
+  });
+
+  printf("[trig] %lu llamadas por variante (ns/llamada)\n", (unsigned long)n);
+  printf("[trig] sin+cos : libm  %6.2f  Q15    %6.2f (x%.1f)\n", sf, sq, sf / sq);
+  printf("[trig] atan2   : libm  %6.2f  BAM    %6.2f (x%.1f)\n", af, aq, af / aq);
+  printf("[trig] flecha  : float %6.2f  entera %6.2f (x%.1f)\n", rf, rq, rf / rq);
+  printf("[trig] (chk %ld)\n", (long)((acc + (int32_t)accF) & 0xFFFF));
+}
+
+} // namespace thost
@@ -0,0 +1,16 @@
+#pragma once
+#include <stdint.h>
+
+// ===================== Trig entera en host =====================
+// sinQ15/cosQ15 y atan2Bam contra libm (cotas de trig_q15.h), conversiones
+// de ángulo y puntas de flecha contra la versión float que reemplazaron.
+
+namespace thost {
+
+// Devuelve cantidad de fallas (0 = OK); imprime una línea por caso
+int runChecks();
+
+// ns por llamada: sinf/cosf/atan2f vs sinQ15/cosQ15/atan2Bam, y flecha completa
+void runBench(uint32_t n);
+
+} // namespace thost
@@ -0,0 +1,106 @@
+#include "buttons.h"
+
+namespace btn {
+
+void Decoder::begin(uint32_t now, uint8_t levels) {
+  for (uint8_t i = 0; i < COUNT; i++) {
+    Key& k = k_[i];
+    const uint32_t longMs = k.longMs;
+    k = Key();
+    k.longMs = longMs;
+    k.raw = k.stable = (levels >> i) & 1;
+    k.longDone = k.stable;              // sostenido desde el arranque: no es un LONG
+    k.tLock = now - DEBOUNCE_MS;
+    k.tDown = now;
+  }
+  qHead_ = qCount_ = 0;
+}
+
+void Decoder::push(Ev type, uint8_t id, uint32_t t, uint16_t rep) {
+  if (qCount_ >= EVENT_QUEUE) {
+    dropped_++;
+    return;
+  }
+  Event& e = q_[(uint8_t)((qHead_ + qCount_) % EVENT_QUEUE)];
+  e.type = type;
+  e.id = id;
+  e.t_ms = t;
+  e.rep = rep;
+  qCount_++;
+}
+
+bool Decoder::next(Event& out) {
+  if (qCount_ == 0) return false;
+  out = q_[qHead_];
+  qHead_ = (uint8_t)((qHead_ + 1) % EVENT_QUEUE);
+  qCount_--;
+  return true;
+}
+
+void Decoder::commit(uint8_t id, uint32_t t) {
+  Key& k = k_[id];
+  k.stable = k.raw;
+  k.tLock = t;
+  if (k.stable) {
+    k.tDown = t;
+    k.rep = 0;
+    k.longDone = false;
+    k.tNextRep = t + REPEAT_DELAY_MS;
+    push(Ev::PRESS, id, t);
+  } else {
+    push(Ev::RELEASE, id, t);
+  }
+}
+
+// Fin del lockout: si el nivel quedó distinto, se acepta en ese instante
+void Decoder::settle(uint8_t id, uint32_t now) {
+  Key& k = k_[id];
+  if (k.raw == k.stable) return;
+  const uint32_t end = k.tLock + DEBOUNCE_MS;
+  if ((int32_t)(now - end) >= 0) commit(id, end);
+}
+
+void Decoder::onEdge(const Edge& e) {
+  if (e.id >= COUNT) return;
+  Key& k = k_[e.id];
+  settle(e.id, e.t_ms);       // lo que quedó pendiente antes de este flanco
+  k.raw = e.level != 0;
+  if (k.raw == k.stable) return;                                  // rebote que volvió
+  if ((int32_t)(e.t_ms - k.tLock) < (int32_t)DEBOUNCE_MS) return;  // dentro del lockout
+  commit(e.id, e.t_ms);
+}
+
+void Decoder::poll(uint32_t now) {
+  for (uint8_t i = 0; i < COUNT; i++) {
+    settle(i, now);
+    Key& k = k_[i];
+    if (!k.stable) continue;
+
+    if (k.longMs && !k.longDone && (int32_t)(now - (k.tDown + k.longMs)) >= 0) {
+      k.longDone = true;
+      push(Ev::LONG, i, k.tDown + k.longMs);
+    }
+
+    // a lo sumo una repetición por poll; si quedó atrás (loop trabado) re-sincroniza
+    if ((repeatMask_ >> i) & 1) {
+      if ((int32_t)(now - k.tNextRep) >= 0) {
+        k.rep++;
+        push(Ev::REPEAT, i, k.tNextRep, k.rep);
+        k.tNextRep += repeatInterval(k.rep);
+        if ((int32_t)(now - k.tNextRep) >= 0) k.tNextRep = now + repeatInterval(k.rep);
+      }
+    } else {
+      // fuera de la máscara el plazo sigue corriendo: al entrar no hay ráfaga
+      if ((int32_t)(now - k.tNextRep) >= 0) k.tNextRep = now + REPEAT_DELAY_MS;
+    }
+  }
+}
+
+uint32_t Decoder::heldMs(uint8_t id, uint32_t now) const {
+  const Key& k = k_[id];
+  if (!k.stable) return 0;
+  const int32_t d = (int32_t)(now - k.tDown);
+  return d < 0 ? 0u : (uint32_t)d;
+}
+
+} // namespace btn
@@ -0,0 +1,101 @@
+#pragma once
+#include <stdint.h>
+
+namespace btn {
+
+// ===================== Botones: flancos -> eventos =====================
+// La ISR de cada pin solo encola un Edge (tiempo + nivel) en una SpscQueue;
+// loop() los pasa por el Decoder, que hace el debounce sobre los timestamps
+// (no sobre cuándo se leyeron) y arma PRESS / RELEASE / LONG / REPEAT.
+// Así la latencia de entrada no depende de cuánto tarde el render.
+//
+// Debounce por lockout: el primer flanco cambia el estado al instante y los
+// de los DEBOUNCE_MS siguientes se ignoran; si al vencer el lockout el nivel
+// quedó distinto, se toma ese (un toque más corto que el lockout no se pierde).
+//
+// Auto-repeat (solo botones de setRepeatMask): primer REPEAT a REPEAT_DELAY_MS
+// y después cada vez más seguido, de REPEAT_START_MS a REPEAT_MIN_MS. 'rep'
+// cuenta las repeticiones para que la UI agrande el paso (accelStep).
+//
+// Sin Arduino: se prueba en host con flancos sintéticos.
+
+static constexpr uint8_t  COUNT = 4;
+static constexpr uint32_t DEBOUNCE_MS = 30;
+static constexpr uint32_t REPEAT_DELAY_MS = 400;
+static constexpr uint32_t REPEAT_START_MS = 150;
+static constexpr uint32_t REPEAT_MIN_MS = 30;
+static constexpr uint32_t REPEAT_RAMP_MS = 10;   // cuánto se acorta cada repetición
+static constexpr uint8_t  EVENT_QUEUE = 16;
+
+// Lo que encola la ISR (level 1 = apretado)
+struct Edge {
+  uint32_t t_ms;
+  uint8_t id;
+  uint8_t level;
+};
+
+enum class Ev : uint8_t { PRESS, RELEASE, LONG, REPEAT };
+
+struct Event {
+  Ev type;
+  uint8_t id;
+  uint32_t t_ms;      // cuándo pasó (flanco / plazo), no cuándo se leyó
+  uint16_t rep;       // REPEAT: 1, 2, 3...
+};
+
+// Multiplicador de paso para valores numéricos: x1, x5 y x10 según cuánto se sostuvo
+static inline uint8_t accelStep(uint16_t rep) {
+  return rep < 10 ? 1 : (rep < 25 ? 5 : 10);
+}
+
+// Intervalo hasta la repetición rep + 1
+static inline uint32_t repeatInterval(uint16_t rep) {
+  const uint32_t cut = (uint32_t)rep * REPEAT_RAMP_MS;
+  return (cut + REPEAT_MIN_MS >= REPEAT_START_MS) ? REPEAT_MIN_MS : REPEAT_START_MS - cut;
+}
+
+class Decoder {
+public:
+  // levels: bit i = botón i apretado al arrancar (no genera PRESS)
+  void begin(uint32_t now, uint8_t levels);
+
+  // Flancos en orden de tiempo; después poll() con el now actual
+  void onEdge(const Edge& e);
+  // Lockouts vencidos, LONG y REPEAT que tocan hasta now
+  void poll(uint32_t now);
+
+  bool next(Event& out);
+
+  void setRepeatMask(uint8_t mask) { repeatMask_ = mask; }
+  void setLongMs(uint8_t id, uint32_t ms) { k_[id].longMs = ms; }   // 0 = sin LONG
+
+  bool down(uint8_t id) const { return k_[id].stable; }
+  bool longFired(uint8_t id) const { return k_[id].longDone; }
+  uint32_t heldMs(uint8_t id, uint32_t now) const;
+  uint32_t dropped() const { return dropped_; }   // eventos perdidos por cola llena
+
+private:
+  struct Key {
+    bool raw = false;        // último nivel visto
+    bool stable = false;     // nivel aceptado
+    bool longDone = false;
+    uint32_t tLock = 0;      // último cambio aceptado (inicio del lockout)
+    uint32_t tDown = 0;
+    uint32_t tNextRep = 0;
+    uint16_t rep = 0;
+    uint32_t longMs = 0;
+  };
+
+  void settle(uint8_t id, uint32_t now);
+  void commit(uint8_t id, uint32_t t);
+  void push(Ev type, uint8_t id, uint32_t t, uint16_t rep = 0);
+
+  Key k_[COUNT];
+  uint8_t repeatMask_ = 0;
+  Event q_[EVENT_QUEUE];
+  uint8_t qHead_ = 0;
+  uint8_t qCount_ = 0;
+  uint32_t dropped_ = 0;
+};
+
+} // namespace btn
@@ -0,0 +1,74 @@
+#include "calib.h"
+#include <math.h>
+
+namespace calib {
+
+Tables::Tables() {
+  compile(AppConfig());
+}
+
+float deviationCdeg(const AppConfig& cfg, float angle_cdeg) {
+  const float step = 36000.0f / CAL_DIR_POINTS;
+  const float pos = angle_cdeg / step;
+  uint8_t k = (uint8_t)pos;
+  if (k >= CAL_DIR_POINTS) k = CAL_DIR_POINTS - 1;
+  const float t = pos - (float)k;
+  const float a = cfg.dir_dev_cdeg[k];
+  const float b = cfg.dir_dev_cdeg[(k + 1) % CAL_DIR_POINTS];
+  return a + (b - a) * t;
+}
+
+float curveCenti(const AppConfig& cfg, float in) {
+  const uint8_t n = cfg.spd_cal_n;
+  if (n < 2) return in;
+  // tramo que contiene 'in'; fuera de la curva, el primero / último extrapolados
+  uint8_t k = 0;
+  while (k + 2 < n && in >= cfg.spd_cal_in[k + 1]) k++;
+  const float x0 = cfg.spd_cal_in[k], x1 = cfg.spd_cal_in[k + 1];
+  const float y0 = cfg.spd_cal_out[k], y1 = cfg.spd_cal_out[k + 1];
+  return y0 + (y1 - y0) * (in - x0) / (x1 - x0);
+}
+
+static int32_t clampI32(double v) {
+  if (v > 2147483647.0) return 2147483647;
+  if (v < -2147483648.0) return (int32_t)-2147483647 - 1;
+  return (int32_t)lround(v);
+}
+
+void Tables::compile(const AppConfig& cfg) {
+  src_ = cfg.speed_src;
+  const double fac = cfg.speed_factor;
+
+  // ---- velocidad: tramos (con speed_factor) ----
+  if (cfg.spd_cal_n < 2) {
+    nseg_ = 1;
+    seg_[0] = Seg { 0, 0, clampI32(fac * 65536.0) };
+    segEnd_[0] = 65536;
+  } else {
+    nseg_ = (uint8_t)(cfg.spd_cal_n - 1);
+    for (uint8_t k = 0; k < nseg_; k++) {
+      const double x0 = cfg.spd_cal_in[k], x1 = cfg.spd_cal_in[k + 1];
+      const double y0 = cfg.spd_cal_out[k], y1 = cfg.spd_cal_out[k + 1];
+      const double slope = (y1 - y0) / (x1 - x0) * fac;
+      // el primero arranca en 0 (extrapolado hacia atrás)
+      const uint16_t start = (k == 0) ? 0 : cfg.spd_cal_in[k];
+      seg_[k] = Seg { start, clampI32((y0 * fac) + slope * ((double)start - x0)), clampI32(slope * 65536.0) };
+      segEnd_[k] = (k + 1 < nseg_) ? cfg.spd_cal_in[k + 1] : 65536u;
+    }
+  }
+  uint8_t s = 0;
+  for (uint32_t b = 0; b < SPD_BUCKETS; b++) {
+    const uint32_t x = b << SPD_SHIFT;
+    while (x >= segEnd_[s]) s++;
+    bucket_[b] = s;
+  }
+
+  // ---- dirección: desvío + offset por grado ----
+  for (uint16_t i = 0; i < DIR_LUT; i++) {
+    const float dev = deviationCdeg(cfg, (float)(i * DIR_STEP_CDEG));
+    dir_[i] = (int16_t)lroundf(dev + (float)cfg.dir_offset_deg * 100.0f);
+  }
+  dir_[DIR_LUT] = dir_[0];
+}
+
+} // namespace calib
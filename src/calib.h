@@ -0,0 +1,82 @@
+#pragma once
+#include <stdint.h>
+#include "config_store.h"
+
+namespace calib {
+
+// ===================== Calibración compilada =====================
+// AppConfig guarda la curva de velocidad (puntos PPS/RPM -> kn) y el desvío
+// de dirección cada 45°; compile() los convierte una vez (al cargar o al
+// editar) en tablas densas, así cada muestra es O(1) y solo enteros:
+//
+//  - velocidad: la entrada se parte en buckets de 64 centésimas; cada bucket
+//    sabe en qué tramo empieza (a lo sumo un punto adentro, por
+//    CAL_MIN_SPACING) y el tramo es y0 + (x - x0) * pendiente Q16, con
+//    speed_factor ya multiplicado. Fuera de la curva se extrapola el primer
+//    / último tramo. Sin curva: recta por el origen con speed_factor.
+//  - dirección: una entrada por grado entero del sensor (desvío interpolado
+//    + dir_offset_deg) e interpolación lineal dentro del grado; como los
+//    puntos caen en grados enteros, es exacta salvo redondeo.
+
+static constexpr uint8_t  SPD_SHIFT = 6;
+static constexpr uint32_t SPD_BUCKETS = 65536u >> SPD_SHIFT;
+static constexpr uint16_t DIR_STEP_CDEG = 100;
+static constexpr uint16_t DIR_LUT = 36000 / DIR_STEP_CDEG;
+static constexpr uint8_t  MAX_SEGS = CAL_SPD_POINTS - 1;
+
+static_assert(CAL_MIN_SPACING >= (1u << SPD_SHIFT), "a lo sumo un punto de la curva por bucket");
+static_assert((int32_t)CAL_DEV_MAX_CDEG + 18000 < 36000, "un solo wrap alcanza en dirCdeg");
+
+class Tables {
+public:
+  Tables();
+
+  void compile(const AppConfig& cfg);
+
+  // Centésimas de nudo (saturadas a 0..65535) para PPS/RPM * 100
+  uint16_t speedCenti(uint16_t in) const {
+    uint8_t s = bucket_[in >> SPD_SHIFT];
+    if (in >= segEnd_[s]) s++;
+    const Seg& g = seg_[s];
+    const int64_t y = (int64_t)g.y0 + (((int64_t)((int32_t)in - (int32_t)g.x0) * g.slopeQ16 + 0x8000) >> 16);
+    return y <= 0 ? 0 : (y >= 65535 ? 65535 : (uint16_t)y);
+  }
+
+  // Ángulo del sensor (centésimas) -> corregido, 0..35999
+  uint16_t dirCdeg(uint16_t angle) const {
+    if (angle >= 36000) angle %= 36000;   // paquete raro: no indexar fuera de la tabla
+    const uint16_t i = angle / DIR_STEP_CDEG;
+    const int32_t f = angle - i * DIR_STEP_CDEG;
+    const int32_t num = dir_[i] * (int32_t)DIR_STEP_CDEG + (dir_[i + 1] - dir_[i]) * f;
+    const int32_t dev = (num + (num >= 0 ? 50 : -50)) / (int32_t)DIR_STEP_CDEG;   // redondeado
+    int32_t v = (int32_t)angle + dev;
+    if (v < 0) v += 36000;
+    else if (v >= 36000) v -= 36000;
+    return (uint16_t)v;
+  }
+
+  uint8_t speedSrc() const { return src_; }   // 0 = PPS, 1 = RPM
+  uint8_t segments() const { return nseg_; }
+
+private:
+  struct Seg {
+    uint16_t x0;
+    int32_t y0;          // kn * 100 en x0
+    int32_t slopeQ16;    // (kn * 100) por centésima de entrada, Q16
+  };
+
+  Seg seg_[MAX_SEGS];
+  uint32_t segEnd_[MAX_SEGS];         // primera entrada del tramo siguiente (último: 65536)
+  uint8_t nseg_ = 0;
+  uint8_t bucket_[SPD_BUCKETS];       // tramo al inicio de cada bucket
+  int16_t dir_[DIR_LUT + 1];          // desvío + offset (cdeg) por grado; [360] = [0]
+  uint8_t src_ = 0;
+};
+
+// Desvío del sensor en 'angle' (cdeg) interpolado entre los puntos de 45°
+float deviationCdeg(const AppConfig& cfg, float angle_cdeg);
+
+// Curva sin factor: kn * 100 para 'in' (PPS/RPM * 100); referencia en float
+float curveCenti(const AppConfig& cfg, float in);
+
+} // namespace calib
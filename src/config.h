@@ -13,9 +13,12 @@ static constexpr uint8_t BTN1_PIN = 19; // BACK
 static constexpr uint8_t BTN2_PIN = 21; // NEXT / +
 static constexpr uint8_t BTN3_PIN = 22; // PREV / -
 static constexpr uint8_t BTN4_PIN = 23; // OK
+static constexpr uint32_t BTN_POLL_MS = 10;    // flancos (ISR) -> eventos, LONG y auto-repeat
 
 // ===================== UI =====================
-static constexpr uint32_t LCD_FPS_MS = 200;    // refresco 5 Hz
+static constexpr uint32_t LCD_FPS_MS = 200;    // refresco 5 Hz mientras cambian los valores
+static constexpr uint32_t LCD_IDLE_MS = 1000;  // sin cambios baja hasta 1 Hz
+static constexpr uint32_t LCD_REFRESH_MS = 10000; // redibuja aunque el fingerprint no cambie
 static constexpr uint32_t NO_DATA_MS = 2000;   // si no hay paquetes en 2s -> NO DATA
 
 // Para evitar falsos toques: mantener OK apretado para entrar a Config
@@ -28,4 +31,11 @@ static constexpr uint8_t ESPNOW_CHANNEL = 1;   // poné el mismo canal que el tr
 static constexpr uint8_t RX2_PIN = 16; // NMEA IN
 static constexpr uint8_t TX2_PIN = 17; // NMEA OUT
 
+// Baud NMEA
+// - NMEA 0183 clásico: 4800
+// - NMEA “rápido” (AIS): 38400
+// - Si es tu propio enlace TTL: podés usar 9600/115200, pero para compatibilidad NMEA: 4800
+static constexpr uint32_t NMEA_BAUD = 4800;
+static constexpr uint32_t NMEA_POLL_MS = 20;   // entrada $PANA + empuje de la salida
+
 
@@ -0,0 +1,210 @@
+#include "config_store.h"
+#include <stddef.h>
+#include <string.h>
+#include "crc16_modbus.h"
+
+void sanitizeConfig(AppConfig& c) {
+  if (c.dir_offset_deg < -180) c.dir_offset_deg = -180;
+  if (c.dir_offset_deg > 180)  c.dir_offset_deg = 180;
+  if (!(c.speed_factor > 0.0001f && c.speed_factor < 1000.0f)) c.speed_factor = 1.0f;
+  c.speed_src = (c.speed_src > 1) ? 0 : c.speed_src;
+  if (c.espnow_channel < 1) c.espnow_channel = 1;
+  if (c.espnow_channel > 13) c.espnow_channel = 13;
+  if (c.avg_display > 3) c.avg_display = 0;
+  if (c.avg_nmea > 3) c.avg_nmea = 0;
+
+  // curva: 2..CAL_SPD_POINTS puntos con entradas crecientes, separadas al
+  // menos CAL_MIN_SPACING; si no, vuelve a lineal
+  bool curveOk = c.spd_cal_n >= 2 && c.spd_cal_n <= CAL_SPD_POINTS;
+  for (uint8_t i = 1; curveOk && i < c.spd_cal_n; i++) {
+    if (c.spd_cal_in[i] < c.spd_cal_in[i - 1] + CAL_MIN_SPACING) curveOk = false;
+  }
+  if (!curveOk) c.spd_cal_n = 0;
+
+  for (uint8_t i = 0; i < CAL_DIR_POINTS; i++) {
+    if (c.dir_dev_cdeg[i] < -CAL_DEV_MAX_CDEG) c.dir_dev_cdeg[i] = -CAL_DEV_MAX_CDEG;
+    if (c.dir_dev_cdeg[i] > CAL_DEV_MAX_CDEG)  c.dir_dev_cdeg[i] = CAL_DEV_MAX_CDEG;
+  }
+}
+
+namespace cfgstore {
+
+static constexpr size_t V1_LEN = offsetof(Payload, avg_display);
+
+static void toPayload(const AppConfig& c, Payload& p) {
+  p.dir_offset_deg = c.dir_offset_deg;
+  p.speed_factor   = c.speed_factor;
+  p.speed_src      = c.speed_src;
+  p.espnow_channel = c.espnow_channel;
+  p.avg_display    = c.avg_display;
+  p.avg_nmea       = c.avg_nmea;
+  p.spd_cal_n      = c.spd_cal_n;
+  memcpy(p.spd_cal_in, c.spd_cal_in, sizeof(p.spd_cal_in));
+  memcpy(p.spd_cal_out, c.spd_cal_out, sizeof(p.spd_cal_out));
+  memcpy(p.dir_dev_cdeg, c.dir_dev_cdeg, sizeof(p.dir_dev_cdeg));
+}
+
+static void fromPayload(const Payload& p, AppConfig& c) {
+  c.dir_offset_deg = p.dir_offset_deg;
+  c.speed_factor   = p.speed_factor;
+  c.speed_src      = p.speed_src;
+  c.espnow_channel = p.espnow_channel;
+  c.avg_display    = p.avg_display;
+  c.avg_nmea       = p.avg_nmea;
+  c.spd_cal_n      = p.spd_cal_n;
+  memcpy(c.spd_cal_in, p.spd_cal_in, sizeof(c.spd_cal_in));
+  memcpy(c.spd_cal_out, p.spd_cal_out, sizeof(c.spd_cal_out));
+  memcpy(c.dir_dev_cdeg, p.dir_dev_cdeg, sizeof(c.dir_dev_cdeg));
+}
+
+// Siempre se escribe la versión actual completa
+static size_t toBlob(const AppConfig& c, uint8_t* raw) {
+  BlobHeader h { BLOB_MAGIC, BLOB_VERSION, (uint8_t)sizeof(Payload) };
+  Payload p;
+  toPayload(c, p);
+  memcpy(raw, &h, sizeof(h));
+  memcpy(raw + sizeof(h), &p, sizeof(p));
+  const size_t n = sizeof(h) + sizeof(p);
+  const uint16_t crc = crc16_modbus(raw, n);
+  memcpy(raw + n, &crc, sizeof(crc));
+  return n + sizeof(crc);
+}
+
+static bool fromBlob(const uint8_t* raw, size_t n, AppConfig& c) {
+  if (n < sizeof(BlobHeader) + sizeof(uint16_t)) return false;
+  BlobHeader h;
+  memcpy(&h, raw, sizeof(h));
+  if (h.magic != BLOB_MAGIC || h.version == 0 || h.len < V1_LEN) return false;
+  if (n != sizeof(h) + h.len + sizeof(uint16_t)) return false;
+
+  uint16_t crc;
+  memcpy(&crc, raw + sizeof(h) + h.len, sizeof(crc));
+  if (crc16_modbus(raw, sizeof(h) + h.len) != crc) return false;
+
+  // defaults para lo que una versión vieja no trae
+  Payload p;
+  toPayload(AppConfig(), p);
+  memcpy(&p, raw + sizeof(h), (h.len < sizeof(p)) ? h.len : sizeof(p));
+  fromPayload(p, c);
+  return true;
+}
+
+static bool sameConfig(const AppConfig& a, const AppConfig& b) {
+  uint8_t ra[BLOB_MAX], rb[BLOB_MAX];
+  const size_t na = toBlob(a, ra);
+  toBlob(b, rb);
+  return memcmp(ra, rb, na) == 0;
+}
+
+// Claves sueltas de la versión anterior (una por campo)
+static const char* const OLD_KEYS[] = { "dir_off", "spd_fac", "spd_src", "esp_ch" };
+
+void ConfigStore::begin(Kv& kv, AppConfig& cfg) {
+  kv_ = &kv;
+  cfg_ = &cfg;
+  cfg = AppConfig();
+
+  bool needWrite = false;
+  kv.begin(NAMESPACE, true);
+
+  // getBytes falla si el blob guardado es más largo que el buffer
+  uint8_t raw[BLOB_MAX + 16];
+  const size_t n = kv.getBytes(BLOB_KEY, raw, sizeof(raw));
+  if (n && fromBlob(raw, n, cfg)) {
+    st_.loadedBlob = true;
+  } else if (kv.isKey(OLD_KEYS[0])) {
+    cfg.dir_offset_deg = kv.getShort("dir_off", 0);
+    cfg.speed_factor   = kv.getFloat("spd_fac", 1.0f);
+    cfg.speed_src      = kv.getUChar("spd_src", 0);
+    cfg.espnow_channel = kv.getUChar("esp_ch", 1);
+    st_.migrated = true;
+    needWrite = true;
+  }
+  kv.end();
+
+  sanitizeConfig(cfg);
+
+  if (needWrite) {
+    // Blob nuevo + borrar claves viejas (una sola vez)
+    uint8_t nb[BLOB_MAX];
+    const size_t len = toBlob(cfg, nb);
+    kv.begin(NAMESPACE, false);
+    if (kv.putBytes(BLOB_KEY, nb, len) == len) {
+      for (const char* k : OLD_KEYS) kv.remove(k);
+      st_.commits++;
+    }
+    kv.end();
+  }
+
+  saved_ = cfg;
+  dirty_ = false;
+  sessionEnded_ = false;
+}
+
+void ConfigStore::markDirty(uint32_t now) {
+  dirty_ = true;
+  lastChangeMs_ = now;
+}
+
+void ConfigStore::beginSession() {
+  if (!cfg_) return;
+  session_ = *cfg_;
+  inSession_ = true;
+}
+
+void ConfigStore::endSession() {
+  dirty_ = true;
+  sessionEnded_ = true;
+  inSession_ = false;
+}
+
+void ConfigStore::revert() {
+  if (!cfg_ || !inSession_) return;
+  *cfg_ = session_;
+  inSession_ = false;
+  sessionEnded_ = false;
+  // sigue pendiente lo que ya difería de lo persistido (el idle commit corre)
+  dirty_ = !sameConfig(*cfg_, saved_);
+}
+
+bool ConfigStore::tick(uint32_t now) {
+  if (!dirty_) return false;
+  if (!sessionEnded_ && (now - lastChangeMs_) < IDLE_COMMIT_MS) return false;
+  const bool ok = commitNow();
+  // falló la escritura: reintento tras otro IDLE_COMMIT_MS, no en cada tick
+  if (dirty_) {
+    sessionEnded_ = false;
+    lastChangeMs_ = now;
+  }
+  return ok;
+}
+
+bool ConfigStore::commitNow() {
+  if (!kv_ || !cfg_) return false;
+
+  if (sameConfig(*cfg_, saved_)) {
+    dirty_ = false;
+    sessionEnded_ = false;
+    st_.skipped++;
+    return false;
+  }
+
+  uint8_t raw[BLOB_MAX];
+  const size_t len = toBlob(*cfg_, raw);
+  kv_->begin(NAMESPACE, false);
+  const bool ok = kv_->putBytes(BLOB_KEY, raw, len) == len;
+  kv_->end();
+
+  // dirty_ se limpia solo si quedó escrito; si no, tick() reintenta
+  if (ok) {
+    saved_ = *cfg_;
+    dirty_ = false;
+    sessionEnded_ = false;
+    st_.commits++;
+  } else {
+    st_.write_errors++;
+  }
+  return ok;
+}
+
+} // namespace cfgstore
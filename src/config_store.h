@@ -0,0 +1,160 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+// ===================== Settings persistentes =====================
+static constexpr uint8_t CAL_SPD_POINTS = 8;    // curva de velocidad por tramos
+static constexpr uint8_t CAL_DIR_POINTS = 8;    // desvío de dirección cada 45°
+static constexpr uint16_t CAL_MIN_SPACING = 64; // entre entradas de la curva (PPS/RPM * 100)
+static constexpr int16_t  CAL_DEV_MAX_CDEG = 3000;
+
+struct AppConfig {
+  int16_t dir_offset_deg = 0;   // -180..180
+  float   speed_factor  = 1.0f; // multiplicador
+  uint8_t speed_src     = 0;    // 0=PPS, 1=RPM
+  uint8_t espnow_channel = 1;  // 1..13
+  uint8_t avg_display   = 0;    // wstats::Avg para MAIN/DIAG (0=inst)
+  uint8_t avg_nmea      = 0;    // wstats::Avg para el MWV relativo
+  // Calibración (ver calib.h); speed_factor y dir_offset_deg se aplican encima
+  uint8_t  spd_cal_n = 0;                         // puntos de la curva (0 = lineal)
+  uint16_t spd_cal_in[CAL_SPD_POINTS] = {};       // PPS/RPM * 100, crecientes
+  uint16_t spd_cal_out[CAL_SPD_POINTS] = {};      // kn * 100
+  int16_t  dir_dev_cdeg[CAL_DIR_POINTS] = {};     // desvío en 0°, 45°, 90°... del sensor
+};
+
+// Rangos válidos (después de cargar / migrar / comandos)
+void sanitizeConfig(AppConfig& c);
+
+namespace cfgstore {
+
+// ===================== Store de configuración =====================
+// AppConfig se guarda como UN blob versionado con CRC16 (clave "cfg"):
+//  - boot: una sola lectura NVS
+//  - cambios: markDirty() y el commit se difiere/coalesce; tick() escribe
+//    recién cuando termina la sesión de edición o tras IDLE_COMMIT_MS sin cambios
+//  - si el contenido serializado no cambió, no se escribe nada
+//  - primera vez: migra las claves sueltas viejas (dir_off/spd_fac/...) y las borra
+
+static constexpr const char* NAMESPACE = "anemo";
+static constexpr const char* BLOB_KEY  = "cfg";
+static constexpr uint16_t BLOB_MAGIC   = 0x4643;   // 'CF'
+static constexpr uint8_t  BLOB_VERSION = 3;
+static constexpr uint32_t IDLE_COMMIT_MS = 3000;
+
+// Payload: los campos nuevos SOLO se agregan al final. Un blob viejo
+// (len más corto) carga lo que trae y el resto queda en default.
+struct __attribute__((packed)) Payload {
+  // v1
+  int16_t dir_offset_deg;
+  float   speed_factor;
+  uint8_t speed_src;
+  uint8_t espnow_channel;
+  // v2
+  uint8_t avg_display;
+  uint8_t avg_nmea;
+  // v3
+  uint8_t  spd_cal_n;
+  uint16_t spd_cal_in[CAL_SPD_POINTS];
+  uint16_t spd_cal_out[CAL_SPD_POINTS];
+  int16_t  dir_dev_cdeg[CAL_DIR_POINTS];
+};
+
+static_assert(sizeof(Payload) <= 255, "Payload no entra en BlobHeader::len");
+
+struct __attribute__((packed)) BlobHeader {
+  uint16_t magic;
+  uint8_t  version;
+  uint8_t  len;        // bytes de payload
+};
+
+// En NVS: header + payload(len) + CRC16-Modbus de lo anterior
+static constexpr size_t BLOB_MAX = sizeof(BlobHeader) + sizeof(Payload) + sizeof(uint16_t);
+
+// Key/value mínimo (Preferences en el equipo, memoria en host)
+class Kv {
+public:
+  virtual ~Kv() {}
+  virtual bool begin(const char* ns, bool readOnly) = 0;
+  virtual void end() = 0;
+  virtual bool isKey(const char* key) = 0;
+  virtual size_t getBytes(const char* key, void* buf, size_t len) = 0;
+  virtual size_t putBytes(const char* key, const void* buf, size_t len) = 0;
+  virtual bool remove(const char* key) = 0;
+  virtual int16_t getShort(const char* key, int16_t def) = 0;
+  virtual float getFloat(const char* key, float def) = 0;
+  virtual uint8_t getUChar(const char* key, uint8_t def) = 0;
+};
+
+struct Stats {
+  uint32_t commits = 0;
+  uint32_t skipped = 0;     // commits pedidos sin cambios reales
+  uint32_t write_errors = 0; // putBytes falló; el cambio sigue pendiente
+  bool migrated = false;    // se migraron claves viejas en este boot
+  bool loadedBlob = false;
+};
+
+class ConfigStore {
+public:
+  // Carga cfg (blob o migración o defaults). cfg queda enlazado al store.
+  void begin(Kv& kv, AppConfig& cfg);
+
+  // Hubo un cambio en cfg (menú, $PANA...): commit diferido por inactividad
+  void markDirty(uint32_t now);
+
+  // Empieza una sesión de edición (menú): foto de cfg para revert()
+  void beginSession();
+
+  // Terminó la sesión de edición: commit en el próximo tick()
+  void endSession();
+
+  // Descarta lo editado en la sesión (vuelve a la foto de beginSession()).
+  // Lo aplicado antes ($PANA...) y todavía sin commit sigue pendiente.
+  void revert();
+
+  // Llamar seguido desde loop(); true si escribió en NVS
+  bool tick(uint32_t now);
+
+  // Commit inmediato (si hay diferencias). Si la escritura falla el cambio
+  // sigue pendiente y tick() lo reintenta.
+  bool commitNow();
+
+  bool pending() const { return dirty_; }
+  const Stats& stats() const { return st_; }
+
+private:
+  Kv* kv_ = nullptr;
+  AppConfig* cfg_ = nullptr;
+  AppConfig saved_;          // último estado persistido
+  AppConfig session_;        // cfg al entrar a la sesión de edición
+  bool inSession_ = false;
+  bool dirty_ = false;
+  bool sessionEnded_ = false;
+  uint32_t lastChangeMs_ = 0;
+  Stats st_;
+};
+
+} // namespace cfgstore
+
+#if defined(ARDUINO)
+#include <Preferences.h>
+
+namespace cfgstore {
+
+class PrefsKv : public Kv {
+public:
+  bool begin(const char* ns, bool readOnly) override { return p_.begin(ns, readOnly); }
+  void end() override { p_.end(); }
+  bool isKey(const char* key) override { return p_.isKey(key); }
+  size_t getBytes(const char* key, void* buf, size_t len) override { return p_.getBytes(key, buf, len); }
+  size_t putBytes(const char* key, const void* buf, size_t len) override { return p_.putBytes(key, buf, len); }
+  bool remove(const char* key) override { return p_.remove(key); }
+  int16_t getShort(const char* key, int16_t def) override { return p_.getShort(key, def); }
+  float getFloat(const char* key, float def) override { return p_.getFloat(key, def); }
+  uint8_t getUChar(const char* key, uint8_t def) override { return p_.getUChar(key, def); }
+
+private:
+  Preferences p_;
+};
+
+} // namespace cfgstore
+#endif
@@ -2,7 +2,99 @@
 #include <stddef.h>
 #include <stdint.h>
 
+// ===================== CRC16-Modbus =====================
+// Poly 0xA001 (reflejado), init 0xFFFF, sin XOR final.
+// Tablas generadas en compile-time (constexpr), viven en flash (.rodata).
+//
+// - crc16_modbus(): API de siempre, ahora por tabla (1 lookup por byte).
+// - crc16::update(): incremental, para ir validando mientras se copia.
+// - crc16::update4(): slicing-by-4 (4 bytes por iteración, 4 tablas = 2 KB).
+// - crc16_modbus_bitwise(): referencia bit a bit (para comparar en host).
+
+namespace crc16 {
+
+static constexpr uint16_t POLY = 0xA001;
+static constexpr uint16_t INIT = 0xFFFF;
+
+struct Tables {
+  uint16_t t[4][256];
+};
+
+constexpr Tables makeTables() {
+  Tables tb {};
+  for (int i = 0; i < 256; i++) {
+    uint16_t crc = (uint16_t)i;
+    for (int b = 0; b < 8; b++) {
+      crc = (crc & 0x0001) ? (uint16_t)((crc >> 1) ^ POLY) : (uint16_t)(crc >> 1);
+    }
+    tb.t[0][i] = crc;
+  }
+  // t[k][i] = t[k-1][i] seguido de un byte 0 mas
+  for (int k = 1; k < 4; k++) {
+    for (int i = 0; i < 256; i++) {
+      const uint16_t prev = tb.t[k - 1][i];
+      tb.t[k][i] = (uint16_t)((prev >> 8) ^ tb.t[0][prev & 0xFF]);
+    }
+  }
+  return tb;
+}
+
+inline constexpr Tables TABLES = makeTables();
+
+static_assert(TABLES.t[0][1] == 0xC0C1, "CRC16 table mal generada");
+static_assert(TABLES.t[0][255] == 0x4040, "CRC16 table mal generada");
+
+// Un byte por iteración
+static inline uint16_t update(uint16_t crc, const uint8_t* data, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    crc = (uint16_t)((crc >> 8) ^ TABLES.t[0][(crc ^ data[i]) & 0xFF]);
+  }
+  return crc;
+}
+
+// Slicing-by-4: 4 lookups independientes por cada 4 bytes, cola byte a byte
+static inline uint16_t update4(uint16_t crc, const uint8_t* data, size_t len) {
+  while (len >= 4) {
+    const uint16_t x = (uint16_t)(crc ^ (data[0] | ((uint16_t)data[1] << 8)));
+    crc = (uint16_t)(TABLES.t[3][x & 0xFF] ^
+                     TABLES.t[2][x >> 8] ^
+                     TABLES.t[1][data[2]] ^
+                     TABLES.t[0][data[3]]);
+    data += 4;
+    len  -= 4;
+  }
+  return update(crc, data, len);
+}
+
+// Copia src->dst y acumula el CRC en la misma pasada
+static inline uint16_t copyUpdate(uint16_t crc, uint8_t* dst, const uint8_t* src, size_t len) {
+  for (size_t i = 0; i < len; i++) {
+    const uint8_t c = src[i];
+    dst[i] = c;
+    crc = (uint16_t)((crc >> 8) ^ TABLES.t[0][(crc ^ c) & 0xFF]);
+  }
+  return crc;
+}
+
+// Acumulador incremental (por si el frame llega en partes)
+class Modbus {
+public:
+  void reset() { crc_ = INIT; }
+  void update(const uint8_t* data, size_t len) { crc_ = crc16::update4(crc_, data, len); }
+  void update(uint8_t c) { crc_ = (uint16_t)((crc_ >> 8) ^ TABLES.t[0][(crc_ ^ c) & 0xFF]); }
+  uint16_t value() const { return crc_; }
+
+private:
+  uint16_t crc_ = INIT;
+};
+
+} // namespace crc16
+
 static inline uint16_t crc16_modbus(const uint8_t* data, size_t len) {
+  return crc16::update4(crc16::INIT, data, len);
+}
+
+static inline uint16_t crc16_modbus_bitwise(const uint8_t* data, size_t len) {
   uint16_t crc = 0xFFFF;
   for (size_t i = 0; i < len; i++) {
     crc ^= (uint16_t)data[i];
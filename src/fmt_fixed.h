@@ -0,0 +1,124 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <math.h>
+
+// ===================== Formateo sin printf =====================
+// Reemplazo chico de snprintf para LCD y NMEA: enteros, hex y punto fijo
+// directo al buffer del llamador, sin heap y sin el printf float de newlib.
+//
+// - fixed(scaled, dec): valor ya escalado (ej. 1234, 2 -> "12.34").
+// - f(v, dec): float, mismo redondeo que "%.Nf" (el valor binario exacto,
+//   empate -> par). v * 10^dec en double es exacto para dec <= 3, así que la
+//   salida es idéntica a snprintf mientras |v| * 10^dec < 2^63.
+// - width/pad como "%5.1f" (pad ' ') o "%05.1f" (pad '0', va después del signo).
+// Como snprintf: nunca escribe más de cap-1 chars y siempre termina en '\0'.
+
+namespace fmt {
+
+class Writer {
+public:
+  Writer(char* buf, size_t cap) : buf_(buf), cap_(cap) { term(); }
+
+  Writer& ch(char c) {
+    if (len_ + 1 < cap_) buf_[len_] = c;
+    len_++;
+    term();
+    return *this;
+  }
+
+  Writer& str(const char* s) {
+    if (s) while (*s) ch(*s++);
+    return *this;
+  }
+
+  Writer& u(uint32_t v, uint8_t width = 0, char pad = ' ') {
+    return num(false, v, 0, width, pad);
+  }
+
+  Writer& i(int32_t v, uint8_t width = 0, char pad = ' ') {
+    const bool neg = v < 0;
+    const uint64_t mag = neg ? (uint64_t)(-(int64_t)v) : (uint64_t)v;
+    return num(neg, mag, 0, width, pad);
+  }
+
+  // Mayúsculas, con ceros a la izquierda hasta 'digits' ("%04X")
+  Writer& hex(uint32_t v, uint8_t digits) {
+    char tmp[8];
+    uint8_t n = 0;
+    do {
+      const uint8_t d = (uint8_t)(v & 0xF);
+      tmp[n++] = (char)(d < 10 ? '0' + d : 'A' + d - 10);
+      v >>= 4;
+    } while (v && n < sizeof(tmp));
+    while (n < digits && n < sizeof(tmp)) tmp[n++] = '0';
+    while (n) ch(tmp[--n]);
+    return *this;
+  }
+
+  Writer& fixed(int32_t scaled, uint8_t decimals, uint8_t width = 0, char pad = ' ') {
+    const bool neg = scaled < 0;
+    const uint64_t mag = neg ? (uint64_t)(-(int64_t)scaled) : (uint64_t)scaled;
+    return num(neg, mag, decimals, width, pad);
+  }
+
+  Writer& f(float v, uint8_t decimals, uint8_t width = 0, char pad = ' ') {
+    if (isnan(v)) return padded("nan", width);
+    if (isinf(v)) return padded(v < 0 ? "-inf" : "inf", width);
+
+    const bool neg = signbit(v);
+    double d = neg ? -(double)v : (double)v;
+    for (uint8_t k = 0; k < decimals; k++) d *= 10.0;
+
+    // redondeo del valor exacto, empate a par (como printf)
+    const double fl = floor(d);
+    uint64_t mag = (uint64_t)fl;
+    const double frac = d - fl;
+    if (frac > 0.5 || (frac == 0.5 && (mag & 1u))) mag++;
+    return num(neg, mag, decimals, width, pad);
+  }
+
+  const char* c_str() const { return buf_; }
+  size_t len() const { return (len_ < cap_) ? len_ : (cap_ ? cap_ - 1 : 0); }
+  bool truncated() const { return cap_ == 0 || len_ >= cap_; }
+
+private:
+  void term() {
+    if (cap_) buf_[(len_ < cap_) ? len_ : cap_ - 1] = '\0';
+  }
+
+  Writer& padded(const char* s, uint8_t width) {
+    size_t n = 0;
+    while (s[n]) n++;
+    for (size_t k = n; k < width; k++) ch(' ');
+    return str(s);
+  }
+
+  Writer& num(bool neg, uint64_t mag, uint8_t decimals, uint8_t width, char pad) {
+    char tmp[24];
+    uint8_t n = 0;
+    do {
+      tmp[n++] = (char)('0' + (uint8_t)(mag % 10u));
+      mag /= 10u;
+      if (n == decimals) tmp[n++] = '.';
+    } while (mag && n < sizeof(tmp));
+    while (decimals && n <= decimals) {            // "0.05": ceros y punto
+      tmp[n] = (n == decimals) ? '.' : '0';
+      n++;
+    }
+    if (decimals && tmp[n - 1] == '.') tmp[n++] = '0';
+
+    const uint8_t total = (uint8_t)(n + (neg ? 1 : 0));
+    if (pad != '0') for (uint8_t k = total; k < width; k++) ch(' ');
+    if (neg) ch('-');
+    if (pad == '0') for (uint8_t k = total; k < width; k++) ch('0');
+    while (n) ch(tmp[--n]);
+    return *this;
+  }
+
+  char* buf_;
+  size_t cap_;
+  size_t len_ = 0;
+};
+
+} // namespace fmt
@@ -0,0 +1,87 @@
+#pragma once
+#include <math.h>
+#include <stdint.h>
+
+namespace fgate {
+
+// ===================== Frames solo si cambian las entradas =====================
+// Cada pantalla reduce lo que muestra (dir/vel cuantizadas como se imprimen,
+// ok, barra de hold, estado del menú, cabeza del historial...) a un
+// fingerprint FNV-1a. Si es igual al del último frame dibujado no se dibuja
+// ni se hace flush. Cada refresh_ms se redibuja igual, por si cambió algo
+// que no entró en el fingerprint.
+//
+// Frame rate adaptativo: period() vuelve a fast_ms apenas algo cambia y se
+// duplica con cada frame sin cambios hasta slow_ms. invalidate() fuerza el
+// próximo (cambio de pantalla, botón).
+
+class Fingerprint {
+public:
+  Fingerprint& u32(uint32_t v) {
+    for (uint8_t i = 0; i < 4; i++, v >>= 8) h_ = (h_ ^ (v & 0xFF)) * 16777619u;
+    return *this;
+  }
+  Fingerprint& i32(int32_t v) { return u32((uint32_t)v); }
+  // Valor como se muestra: v * scale redondeado (10 = un decimal)
+  Fingerprint& q(float v, float scale) { return i32((int32_t)lroundf(v * scale)); }
+  Fingerprint& ptr(const void* p) { return u32((uint32_t)(uintptr_t)p); }
+
+  uint32_t value() const { return h_; }
+
+private:
+  uint32_t h_ = 2166136261u;
+};
+
+struct Config {
+  uint32_t fast_ms = 200;       // mientras los valores se mueven
+  uint32_t slow_ms = 1000;      // techo en reposo
+  uint32_t refresh_ms = 10000;  // redibujo completo aunque no cambie nada
+};
+
+struct Stats {
+  uint32_t frames = 0;    // veces que se evaluó
+  uint32_t drawn = 0;
+  uint32_t skipped = 0;
+  float skipPct() const { return frames ? 100.0f * (float)skipped / (float)frames : 0.0f; }
+};
+
+class Gate {
+public:
+  explicit Gate(const Config& cfg = Config()) : cfg_(cfg), period_(cfg.fast_ms) {}
+
+  // true = dibujar este frame
+  bool check(uint32_t fp, uint32_t now) {
+    st_.frames++;
+    const bool stale = (now - lastDrawMs_) >= cfg_.refresh_ms;
+    if (valid_ && fp == fp_ && !stale) {
+      st_.skipped++;
+      period_ = (period_ * 2 > cfg_.slow_ms) ? cfg_.slow_ms : period_ * 2;
+      return false;
+    }
+    if (!valid_ || fp != fp_) period_ = cfg_.fast_ms;
+    fp_ = fp;
+    valid_ = true;
+    lastDrawMs_ = now;
+    st_.drawn++;
+    return true;
+  }
+
+  void invalidate() {
+    valid_ = false;
+    period_ = cfg_.fast_ms;
+  }
+
+  uint32_t period() const { return period_; }
+  const Stats& stats() const { return st_; }
+  void resetStats() { st_ = Stats(); }
+
+private:
+  Config cfg_;
+  uint32_t fp_ = 0;
+  bool valid_ = false;
+  uint32_t lastDrawMs_ = 0;
+  uint32_t period_;
+  Stats st_;
+};
+
+} // namespace fgate
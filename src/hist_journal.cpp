@@ -0,0 +1,211 @@
+#include "hist_journal.h"
+#include <string.h>
+#include "crc16_modbus.h"
+
+namespace hjournal {
+
+static constexpr size_t CRC_LEN = sizeof(PageHeader) + sizeof(Sample) * SAMPLES_PER_PAGE;
+static constexpr size_t MAGIC_LEN = sizeof(uint16_t);   // PageHeader::magic, primer campo
+
+static bool headerValid(const PageHeader& h) {
+  return h.magic == PAGE_MAGIC && h.n <= SAMPLES_PER_PAGE;
+}
+
+static bool erased(const void* p, size_t n) {
+  const uint8_t* b = (const uint8_t*)p;
+  for (size_t i = 0; i < n; i++) {
+    if (b[i] != 0xFF) return false;
+  }
+  return true;
+}
+
+bool Journal::readHeader(uint32_t page, PageHeader& h) {
+  return flash_->read(page * PAGE_SIZE, &h, sizeof(h));
+}
+
+bool Journal::begin(Flash& flash, bool coldStart) {
+  flash_ = &flash;
+  const uint32_t n = pageCount();
+  if (n < 2 * PAGES_PER_SECTOR) {
+    flash_ = nullptr;
+    return false;
+  }
+
+  // Cabeza = página válida con seq más alto (solo headers: 8 bytes por página)
+  haveHead_ = false;
+  uint32_t best = 0;
+  uint8_t lastBoot = 0;
+  for (uint32_t p = 0; p < n; p++) {
+    PageHeader h;
+    if (!readHeader(p, h) || !headerValid(h)) continue;
+    if (!haveHead_ || h.seq >= best) {
+      best = h.seq;
+      lastBoot = h.boot;
+      head_ = p;
+      haveHead_ = true;
+    }
+  }
+
+  seq_  = haveHead_ ? best + 1 : 0;
+  next_ = haveHead_ ? (head_ + 1) % n : 0;
+  boot_ = haveHead_ ? (uint8_t)(((lastBoot & BOOT_ID_MASK) + 1) % BOOT_IDS) : 0;
+  if (coldStart) boot_ |= BOOT_COLD;
+
+  // Si la siguiente no está borrada entera (sector a medio borrar, página
+  // cortada sin magic), saltamos al próximo sector, que se borra antes de escribir.
+  if (next_ % PAGES_PER_SECTOR != 0 &&
+      (!flash_->read(next_ * PAGE_SIZE, &buf_, sizeof(buf_)) || !erased(&buf_, sizeof(buf_)))) {
+    next_ = ((next_ / PAGES_PER_SECTOR + 1) * PAGES_PER_SECTOR) % n;
+  }
+
+  ready_ = NO_SECTOR;
+  memset(&buf_, 0xFF, sizeof(buf_));
+  buf_.h.n = 0;
+
+  // En frío, una página vacía marca el corte ya: si la corrida se reinicia
+  // antes de llenar una página, la siguiente igual sabe que hubo un apagado
+  if (coldStart) writePage();
+  return true;
+}
+
+bool Journal::writePage() {
+  buf_.h.magic = PAGE_MAGIC;
+  buf_.h.boot  = boot_;
+  buf_.h.seq   = seq_;
+  buf_.crc16   = crc16_modbus((const uint8_t*)&buf_, CRC_LEN);
+  buf_.pad     = 0xFFFF;
+
+  bool ok = true;
+  if (next_ % PAGES_PER_SECTOR == 0) {
+    const uint32_t sec = next_ / PAGES_PER_SECTOR;
+    if (ready_ != sec) {
+      ok = flash_->eraseSector(sec * SECTOR_SIZE);
+      if (ok) { st_.sectors_erased++; st_.inline_erases++; }
+    }
+    ready_ = NO_SECTOR;
+  }
+  // Todo menos el magic, y el magic al final: si se corta la luz a mitad de
+  // camino la página no queda con un header válido y seq a medias
+  const uint8_t* raw = (const uint8_t*)&buf_;
+  if (ok) ok = flash_->write(next_ * PAGE_SIZE + MAGIC_LEN, raw + MAGIC_LEN, sizeof(buf_) - MAGIC_LEN);
+  if (ok) ok = flash_->write(next_ * PAGE_SIZE, raw, MAGIC_LEN);
+
+  if (ok) {
+    st_.pages_written++;
+    head_ = next_;
+    haveHead_ = true;
+  } else {
+    st_.write_errors++;
+  }
+
+  // Aunque falle, avanzamos: no reintentar sobre una página sucia
+  next_ = (next_ + 1) % pageCount();
+  seq_++;
+
+  memset(&buf_, 0xFF, sizeof(buf_));
+  buf_.h.n = 0;
+  return ok;
+}
+
+void Journal::append(uint16_t dir_ddeg, uint16_t spd_centi) {
+  if (!flash_) return;
+  buf_.s[buf_.h.n].dir_ddeg  = dir_ddeg;
+  buf_.s[buf_.h.n].spd_centi = spd_centi;
+  buf_.h.n++;
+  if (buf_.h.n >= SAMPLES_PER_PAGE) writePage();
+}
+
+bool Journal::flush() {
+  if (!flash_ || buf_.h.n == 0) return true;
+  return writePage();
+}
+
+bool Journal::prepare() {
+  if (!flash_) return false;
+  const uint32_t sectors = pageCount() / PAGES_PER_SECTOR;
+  const uint32_t sec = next_ / PAGES_PER_SECTOR;
+
+  // next_ al borde: su sector todavía no tiene nada nuestro; si no, el siguiente
+  const uint32_t want = (next_ % PAGES_PER_SECTOR == 0) ? sec : (sec + 1) % sectors;
+  if (ready_ == want) return false;
+
+  if (!flash_->eraseSector(want * SECTOR_SIZE)) {
+    st_.write_errors++;
+    return false;
+  }
+  st_.sectors_erased++;
+  ready_ = want;
+  return true;
+}
+
+uint32_t Journal::replay(uint32_t maxSamples, SampleFn fn, void* ctx) {
+  if (!flash_ || !haveHead_ || !fn || maxSamples == 0) return 0;
+  const uint32_t n = pageCount();
+
+  PageHeader h;
+  if (!readHeader(head_, h) || !headerValid(h)) return 0;
+
+  // 1) hacia atrás por headers con seq consecutivo hasta juntar maxSamples.
+  //    Una página cortada o un sector salteado en begin() dejan un hueco
+  //    físico en la cadena; se toleran hasta un sector de páginas sin la seq.
+  //    Se corta al pasar a la corrida anterior a una que arrancó en frío.
+  uint8_t run = h.boot;
+  uint32_t expect = h.seq;
+  uint32_t startSeq = h.seq;
+  uint32_t p = head_;
+  uint32_t span = 0;    // páginas físicas desde la más vieja hasta head_
+  uint32_t total = 0;
+  uint32_t gap = 0;
+
+  for (uint32_t step = 0; step < n; step++) {
+    if (readHeader(p, h) && headerValid(h) && h.seq == expect) {
+      if (h.boot != run && (run & BOOT_COLD)) break;
+      run = h.boot;
+      startSeq = expect;
+      span = step + 1;
+      total += h.n;
+      gap = 0;
+      if (total >= maxSamples || expect == 0) break;
+      expect--;
+    } else if (++gap > PAGES_PER_SECTOR) {
+      break;
+    }
+    p = (p + n - 1) % n;
+  }
+
+  // 2) hacia adelante, página completa + CRC; las cortadas se saltean
+  const uint32_t start = (head_ + n - (span - 1)) % n;
+  uint32_t skip = (total > maxSamples) ? total - maxSamples : 0;
+  uint32_t seq = startSeq;
+  uint32_t out = 0;
+  Page pg;
+
+  for (uint32_t i = 0; i < span; i++) {
+    const uint32_t pi = (start + i) % n;
+    if (!flash_->read(pi * PAGE_SIZE, &pg, sizeof(pg))) {
+      st_.bad_pages++;
+      continue;
+    }
+    if (!headerValid(pg.h) || pg.h.seq != seq) {
+      // hueco: borrada (sector salteado) o cortada antes del magic
+      if (!erased(&pg, sizeof(pg))) st_.bad_pages++;
+      continue;
+    }
+    seq++;
+
+    if (crc16_modbus((const uint8_t*)&pg, CRC_LEN) != pg.crc16) {
+      st_.bad_pages++;
+      skip = (skip > pg.h.n) ? skip - pg.h.n : 0;
+      continue;
+    }
+
+    for (uint8_t k = 0; k < pg.h.n; k++) {
+      if (skip) { skip--; continue; }
+      fn(pg.s[k].dir_ddeg, pg.s[k].spd_centi, ctx);
+      out++;
+    }
+  }
+  return out;
+}
+
+} // namespace hjournal
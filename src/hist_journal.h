@@ -0,0 +1,150 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+
+namespace hjournal {
+
+// ===================== Journal de historial en flash =====================
+// Append-only de las muestras de 1 Hz (dir, vel) en páginas de 256 bytes
+// con CRC16. Las páginas se escriben en orden por toda la partición y cada
+// sector se borra una vez por vuelta (wear leveling por rotación). El borrado
+// (decenas de ms) lo hace prepare() por adelantado, un sector antes de
+// llegar; writePage() solo borra si nadie llamó a prepare() a tiempo.
+// Al arrancar se leen solo los headers para ubicar la cabeza y se
+// reproducen las últimas N muestras.
+//
+// Cada página se escribe con el magic al final: una escritura cortada por un
+// brownout deja una página sin magic (o, si el corte fue en el magic, sin
+// CRC válido). El replay la saltea y sigue con las anteriores.
+//
+// No hay reloj de pared: cada página lleva la corrida (arranque) que la
+// escribió y si esa corrida empezó en frío (power-on, apagado de duración
+// desconocida). El replay no cruza hacia atrás el comienzo de una corrida
+// en frío: lo anterior no se puede ubicar en el tiempo.
+
+static constexpr uint32_t SECTOR_SIZE = 4096;
+static constexpr uint32_t PAGE_SIZE = 256;
+static constexpr uint32_t PAGES_PER_SECTOR = SECTOR_SIZE / PAGE_SIZE;
+static constexpr uint8_t  SAMPLES_PER_PAGE = 61;
+static constexpr uint16_t PAGE_MAGIC = 0x4A48;   // 'HJ'
+
+// PageHeader::boot: bits 0..6 = nro de corrida (0..126), bit 7 = en frío.
+// 0x7F no se asigna: es lo que tienen las páginas de antes del campo (0xFF).
+static constexpr uint8_t BOOT_COLD = 0x80;
+static constexpr uint8_t BOOT_ID_MASK = 0x7F;
+static constexpr uint8_t BOOT_IDS = 127;
+
+struct Sample {
+  uint16_t dir_ddeg;
+  uint16_t spd_centi;
+};
+
+struct __attribute__((packed)) PageHeader {
+  uint16_t magic;
+  uint8_t  n;          // muestras válidas en la página
+  uint8_t  boot;       // corrida que la escribió (ver BOOT_COLD)
+  uint32_t seq;        // número de página, creciente
+};
+
+struct __attribute__((packed)) Page {
+  PageHeader h;
+  Sample s[SAMPLES_PER_PAGE];
+  uint16_t crc16;      // CRC16-Modbus de header + muestras
+  uint16_t pad;
+};
+
+static_assert(sizeof(Page) == PAGE_SIZE, "Page debe ocupar una página de flash");
+
+// Flash genérica (partición en el equipo, archivo en host)
+class Flash {
+public:
+  virtual ~Flash() {}
+  virtual uint32_t size() const = 0;                        // múltiplo de SECTOR_SIZE
+  virtual bool read(uint32_t addr, void* dst, size_t n) = 0;
+  virtual bool write(uint32_t addr, const void* src, size_t n) = 0;
+  virtual bool eraseSector(uint32_t addr) = 0;
+};
+
+using SampleFn = void (*)(uint16_t dir_ddeg, uint16_t spd_centi, void* ctx);
+
+struct Stats {
+  uint32_t pages_written = 0;
+  uint32_t sectors_erased = 0;
+  uint32_t inline_erases = 0;   // borrados dentro de append() (prepare() llegó tarde)
+  uint32_t bad_pages = 0;       // CRC malo en replay (escritura cortada)
+  uint32_t write_errors = 0;
+};
+
+class Journal {
+public:
+  // Ubica la cabeza leyendo solo los headers y abre una corrida nueva.
+  // coldStart: el equipo viene de estar apagado (no de un reinicio breve);
+  // escribe una página vacía que marca el corte. false si la flash no sirve.
+  bool begin(Flash& flash, bool coldStart = false);
+
+  // Reproduce hasta maxSamples muestras (las más nuevas), de vieja a nueva,
+  // sin pasar del comienzo de una corrida en frío. Devuelve cuántas entregó.
+  uint32_t replay(uint32_t maxSamples, SampleFn fn, void* ctx);
+
+  // Bufferiza; escribe una página cada SAMPLES_PER_PAGE muestras
+  void append(uint16_t dir_ddeg, uint16_t spd_centi);
+
+  // Escribe la página parcial (ej. antes de un reinicio controlado)
+  bool flush();
+
+  // Borra por adelantado el próximo sector a escribir, si todavía no lo
+  // está. Lento: llamarlo desde una tarea de baja prioridad, no desde
+  // loop(). true si borró algo.
+  bool prepare();
+
+  const Stats& stats() const { return st_; }
+
+private:
+  uint32_t pageCount() const { return flash_ ? flash_->size() / PAGE_SIZE : 0; }
+  bool readHeader(uint32_t page, PageHeader& h);
+  bool writePage();
+
+  Flash* flash_ = nullptr;
+  uint32_t next_ = 0;        // próxima página a escribir
+  uint32_t seq_ = 0;         // seq de la próxima página
+  uint8_t boot_ = 0;         // PageHeader::boot de esta corrida
+  bool haveHead_ = false;
+  uint32_t head_ = 0;        // última página escrita (válida)
+  static constexpr uint32_t NO_SECTOR = 0xFFFFFFFFu;
+  uint32_t ready_ = NO_SECTOR; // sector ya borrado por prepare(), sin escribir
+
+  Page buf_ {};
+  Stats st_;
+};
+
+} // namespace hjournal
+
+#if defined(ARDUINO)
+#include <esp_partition.h>
+
+namespace hjournal {
+
+// Partición de datos cruda (ver partitions.csv)
+class PartitionFlash : public Flash {
+public:
+  bool begin(const char* label) {
+    part_ = esp_partition_find_first(ESP_PARTITION_TYPE_DATA, ESP_PARTITION_SUBTYPE_ANY, label);
+    return part_ != nullptr;
+  }
+  uint32_t size() const override { return part_ ? (part_->size / SECTOR_SIZE) * SECTOR_SIZE : 0; }
+  bool read(uint32_t addr, void* dst, size_t n) override {
+    return esp_partition_read(part_, addr, dst, n) == ESP_OK;
+  }
+  bool write(uint32_t addr, const void* src, size_t n) override {
+    return esp_partition_write(part_, addr, src, n) == ESP_OK;
+  }
+  bool eraseSector(uint32_t addr) override {
+    return esp_partition_erase_range(part_, addr, SECTOR_SIZE) == ESP_OK;
+  }
+
+private:
+  const esp_partition_t* part_ = nullptr;
+};
+
+} // namespace hjournal
+#endif
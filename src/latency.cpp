@@ -0,0 +1,150 @@
+#include "latency.h"
+#include <math.h>
+
+namespace lat {
+
+// ----------------- histogramas -----------------
+void Hist::add(uint32_t ms) {
+  uint8_t i = 0;
+  while (i < BINS - 1 && ms >= EDGES_MS[i]) i++;
+  n[i]++;
+  total++;
+}
+
+uint16_t Hist::pct(uint8_t p) const {
+  if (total == 0) return 0;
+  const uint32_t target = (total * p + 99u) / 100u;
+  uint32_t acc = 0;
+  for (uint8_t i = 0; i < BINS - 1; i++) {
+    acc += n[i];
+    if (acc >= target) return EDGES_MS[i];
+  }
+  return OPEN_BIN;
+}
+
+void BlockHist::roll(uint32_t now_ms) {
+  if (!started) {
+    started = true;
+    t0 = now_ms;
+    return;
+  }
+  const uint32_t dt = now_ms - t0;
+  if (dt < BLOCK_MS) return;
+  // si pasó más de un bloque sin muestras, el último completo está vacío
+  last = (dt < 2 * BLOCK_MS) ? cur : Hist();
+  cur = Hist();
+  t0 = now_ms;
+}
+
+void BlockHist::add(uint32_t now_ms, uint32_t ms) {
+  roll(now_ms);
+  cur.add(ms);
+}
+
+static Pcts pcts(const Hist& h) {
+  Pcts p;
+  p.p50 = h.pct(50);
+  p.p90 = h.pct(90);
+  p.p99 = h.pct(99);
+  p.n = h.total;
+  return p;
+}
+
+// ----------------- reloj del transmisor -----------------
+void ClockSync::reset(uint32_t raw, uint32_t rx_ms) {
+  base_ = raw;
+  have_ = true;
+  head_ = 0;
+  npts_ = 0;
+  winHave_ = false;
+  winStart_ = rx_ms;
+  xref_ = rx_ms;
+  icpt_ = 0.0;
+  slope_ = 0.0;
+}
+
+double ClockSync::fit(uint32_t rx_ms) const {
+  return icpt_ + slope_ * (double)(int32_t)(rx_ms - xref_);
+}
+
+int32_t ClockSync::offsetAt(uint32_t rx_ms) const {
+  if (!have_) return 0;
+  const double y = npts_ ? fit(rx_ms) : (double)winMin_;
+  return (int32_t)(base_ + (uint32_t)(int32_t)lround(y));
+}
+
+// Mínimos cuadrados sobre los mínimos cerrados, x relativo al más nuevo
+// (O(NPTS) cada WIN_MS, no por paquete)
+void ClockSync::closeWindow() {
+  px_[head_] = winMinRx_;
+  py_[head_] = winMin_;
+  head_ = (uint8_t)((head_ + 1) % NPTS);
+  if (npts_ < NPTS) npts_++;
+
+  xref_ = winMinRx_;
+  double sx = 0, sy = 0, sxx = 0, sxy = 0;
+  for (uint8_t i = 0; i < npts_; i++) {
+    const double x = (double)(int32_t)(px_[i] - xref_);
+    const double y = (double)py_[i];
+    sx += x; sy += y; sxx += x * x; sxy += x * y;
+  }
+  const double n = (double)npts_;
+  const double den = n * sxx - sx * sx;
+  if (npts_ >= 2 && den > 0.0) {
+    slope_ = (n * sxy - sx * sy) / den;
+    icpt_  = (sy - slope_ * sx) / n;
+  } else {
+    slope_ = 0.0;
+    icpt_  = (double)winMin_;
+  }
+}
+
+uint32_t ClockSync::add(uint32_t tx_ms, uint32_t rx_ms) {
+  const uint32_t raw = rx_ms - tx_ms;
+  if (!have_) reset(raw, rx_ms);
+
+  int32_t y = (int32_t)(raw - base_);
+
+  // el transmisor reinició (o el reloj saltó): se empieza de nuevo
+  if (npts_ || winHave_) {
+    const double pred = npts_ ? fit(rx_ms) : (double)winMin_;
+    const double resid = (double)y - pred;
+    if (resid > JUMP_MS || resid < -JUMP_MS) {
+      resyncs_++;
+      reset(raw, rx_ms);
+      y = 0;
+    }
+  }
+
+  if (winHave_ && (rx_ms - winStart_) >= WIN_MS) {
+    closeWindow();
+    winHave_ = false;
+    winStart_ = rx_ms;
+  }
+  if (!winHave_ || y < winMin_) {
+    winMin_ = y;
+    winMinRx_ = rx_ms;
+    winHave_ = true;
+  }
+
+  const double est = npts_ ? fit(rx_ms) : (double)winMin_;
+  const double l = (double)y - est;
+  return (l > 0.0) ? (uint32_t)lround(l) : 0u;
+}
+
+// ----------------- resumen -----------------
+Summary summarize(const ClockSync& clk, BlockHist& txRx, BlockHist& rxLcd, uint32_t now_ms) {
+  txRx.roll(now_ms);
+  rxLcd.roll(now_ms);
+
+  Summary s;
+  s.synced = clk.synced();
+  s.offset_ms = clk.offsetAt(now_ms);
+  s.drift_ppm = clk.driftPpm();
+  s.resyncs = clk.resyncs();
+  s.txToRx = pcts(txRx.last);
+  s.rxToLcd = pcts(rxLcd.last);
+  return s;
+}
+
+} // namespace lat
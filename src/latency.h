@@ -0,0 +1,145 @@
+#pragma once
+#include <stdint.h>
+
+namespace lat {
+
+// ===================== Latencia y reloj del transmisor =====================
+// Cada WindPacket trae timestamp_ms (millis() del tope del mástil). La
+// diferencia rx - tx = offset de relojes + demora del camino. Sin relojes
+// sincronizados la demora absoluta no es observable: se estima el offset
+// como el piso de rx - tx (filtro de mínimo por ventana de 2 s) y su deriva
+// con una regresión lineal sobre los últimos 32 mínimos (~64 s).
+// Latencia sensor -> onRecv = (rx - tx) - offset estimado: demora por encima
+// del camino más rápido visto (radio + cola del transmisor).
+//
+// Latencia onRecv -> LCD: desde rx_ms de cada paquete hasta que termina de
+// enviarse el primer frame que lo refleja.
+//
+// Percentiles por histograma de bins fijos, en bloques de 10 s: se reporta
+// el último bloque completo (O(1) por muestra, sin ordenar).
+
+static constexpr uint8_t BINS = 10;
+static constexpr uint16_t EDGES_MS[BINS - 1] = { 2, 5, 10, 20, 50, 100, 200, 500, 1000 };
+static constexpr uint16_t OPEN_BIN = 0xFFFF;     // percentil en el bin abierto (>= 1000)
+static constexpr uint32_t BLOCK_MS = 10000;
+
+struct Hist {
+  uint16_t n[BINS] = {};
+  uint32_t total = 0;
+
+  void add(uint32_t ms);
+  // Borde superior del bin que acumula 'pct' % (0 = sin datos, OPEN_BIN = >= último borde)
+  uint16_t pct(uint8_t p) const;
+};
+
+// Histograma por bloques: 'last' es el último bloque de BLOCK_MS completo
+struct BlockHist {
+  Hist cur;
+  Hist last;
+  uint32_t t0 = 0;
+  bool started = false;
+
+  void add(uint32_t now_ms, uint32_t ms);
+  void roll(uint32_t now_ms);
+};
+
+struct Pcts {
+  uint16_t p50 = 0;
+  uint16_t p90 = 0;
+  uint16_t p99 = 0;
+  uint32_t n = 0;
+};
+
+struct Summary {
+  bool synced = false;       // hay al menos 2 mínimos (offset + deriva)
+  int32_t offset_ms = 0;     // rx - tx estimado ahora (módulo 2^32, con signo)
+  float drift_ppm = 0.0f;    // >0: el reloj local corre más rápido
+  uint32_t resyncs = 0;      // saltos del timestamp (reinicio del transmisor)
+  Pcts txToRx;               // sensor -> onRecv
+  Pcts rxToLcd;              // onRecv -> frame enviado
+  uint32_t pend_drops = 0;   // muestras sin lugar para medir rx -> LCD
+};
+
+// Estimador de offset/deriva (loop, no callback)
+class ClockSync {
+public:
+  static constexpr uint32_t WIN_MS = 2000;
+  static constexpr uint8_t  NPTS = 32;
+  static constexpr int32_t  JUMP_MS = 5000;       // residuo mayor = resync
+
+  // Devuelve la latencia por encima del piso (ms, >= 0)
+  uint32_t add(uint32_t tx_ms, uint32_t rx_ms);
+
+  bool synced() const { return npts_ >= 2; }
+  int32_t offsetAt(uint32_t rx_ms) const;          // rx - tx estimado
+  float driftPpm() const { return (float)(slope_ * 1e6); }
+  uint32_t resyncs() const { return resyncs_; }
+
+private:
+  void reset(uint32_t raw, uint32_t rx_ms);
+  void closeWindow();
+  double fit(uint32_t rx_ms) const;                // offset relativo a base_
+
+  uint32_t base_ = 0;        // rx - tx del primer paquete: todo es relativo a esto
+  bool have_ = false;
+
+  // ventana de mínimo en curso
+  uint32_t winStart_ = 0;
+  int32_t  winMin_ = 0;
+  uint32_t winMinRx_ = 0;
+  bool     winHave_ = false;
+
+  // mínimos cerrados (x = rx_ms, y = offset relativo)
+  uint32_t px_[NPTS] = {};
+  int32_t  py_[NPTS] = {};
+  uint8_t  head_ = 0;
+  uint8_t  npts_ = 0;
+
+  // recta: y = icpt_ + slope_ * (rx - xref_)
+  uint32_t xref_ = 0;
+  double   icpt_ = 0.0;
+  double   slope_ = 0.0;
+
+  uint32_t resyncs_ = 0;
+};
+
+// Resumen del reloj y de los dos histogramas (cierra los bloques vencidos)
+Summary summarize(const ClockSync& clk, BlockHist& txRx, BlockHist& rxLcd, uint32_t now_ms);
+
+// N = muestras pendientes de rx -> LCD; main.cpp usa la capacidad de la cola
+// RX (entre dos frames, hasta LCD_IDLE_MS, llegan menos). Si igual se llena,
+// las que no entran se cuentan en Summary::pend_drops.
+template <uint32_t N>
+class LatencyStats {
+public:
+  // Paquete procesado en loop(): actualiza reloj y latencia sensor -> rx
+  void onSample(uint32_t tx_ms, uint32_t rx_ms, uint32_t now_ms) {
+    txRx_.add(now_ms, clk_.add(tx_ms, rx_ms));
+    if (npend_ < N) pend_[npend_++] = rx_ms;
+    else drops_++;
+  }
+
+  // Frame con datos de viento enviado al LCD: cierra los pendientes
+  void onFrame(uint32_t done_ms) {
+    for (uint32_t i = 0; i < npend_; i++) rxLcd_.add(done_ms, done_ms - pend_[i]);
+    npend_ = 0;
+  }
+  // Frame sin datos de viento (HIST, menú): los pendientes no se miden
+  void dropPending() { npend_ = 0; }
+
+  Summary summary(uint32_t now_ms) {
+    Summary s = summarize(clk_, txRx_, rxLcd_, now_ms);
+    s.pend_drops = drops_;
+    return s;
+  }
+
+private:
+  ClockSync clk_;
+  BlockHist txRx_;
+  BlockHist rxLcd_;
+  uint32_t pend_[N] = {};
+  uint32_t npend_ = 0;
+  uint32_t drops_ = 0;
+};
+
+} // namespace lat
@@ -0,0 +1,62 @@
+#pragma once
+#include <stdint.h>
+#include <string.h>
+
+namespace lcd_flush {
+
+// ===================== Flush por filas de tiles modificadas =====================
+// Guarda una copia (shadow) de lo último enviado al LCD y, en cada flush,
+// compara por fila de tiles (8 px de alto). Filas sucesivas sucias se juntan
+// en un solo rectángulo y se entregan al sink(tileY, tileRows), que en el
+// equipo es u8g2.updateDisplayArea(0, y, TILE_W, rows).
+// No depende de U8g2: el framebuffer es TILE_H filas de TILE_W*8 bytes.
+
+template <uint8_t TILE_W, uint8_t TILE_H>
+class DirtyRows {
+public:
+  static constexpr uint16_t ROW_BYTES = (uint16_t)TILE_W * 8u;
+  static constexpr uint16_t BUF_BYTES = ROW_BYTES * TILE_H;
+
+  // Fuerza a reenviar todo en el próximo flush
+  void invalidate() { valid_ = false; }
+
+  // Devuelve bytes de framebuffer enviados (0 si no cambió nada)
+  template <typename Sink>
+  uint16_t flush(const uint8_t* buf, Sink&& sink) {
+    uint16_t sent = 0;
+    uint8_t runStart = 0, runLen = 0;
+
+    for (uint8_t ty = 0; ty < TILE_H; ty++) {
+      const uint8_t* row = buf + (uint16_t)ty * ROW_BYTES;
+      uint8_t* sh = shadow_ + (uint16_t)ty * ROW_BYTES;
+      const bool dirty = !valid_ || memcmp(row, sh, ROW_BYTES) != 0;
+
+      if (dirty) {
+        memcpy(sh, row, ROW_BYTES);
+        if (runLen == 0) runStart = ty;
+        runLen++;
+      } else if (runLen) {
+        sink(runStart, runLen);
+        sent += (uint16_t)runLen * ROW_BYTES;
+        runLen = 0;
+      }
+    }
+    if (runLen) {
+      sink(runStart, runLen);
+      sent += (uint16_t)runLen * ROW_BYTES;
+    }
+
+    valid_ = true;
+    lastBytes_ = sent;
+    return sent;
+  }
+
+  uint16_t lastBytes() const { return lastBytes_; }
+
+private:
+  uint8_t shadow_[BUF_BYTES] = {};
+  bool valid_ = false;
+  uint16_t lastBytes_ = 0;
+};
+
+} // namespace lcd_flush
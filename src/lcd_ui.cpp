@@ -2,37 +2,43 @@
 #include <U8g2lib.h>
 #include <math.h>
 #include "config.h"
+#include "lcd_flush.h"
+#include "trig_q15.h"
+#include "fmt_fixed.h"
+#include "prof.h"
 
-static U8G2_ST7920_128X64_F_SW_SPI u8g2(
+#ifdef ARDUINO
+static U8G2_ST7920_128X64_F_SW_SPI s_st7920(
   U8G2_R0,
   /* clock=*/ LCD_CLK,
   /* data=*/  LCD_DAT,
   /* CS=*/    LCD_CS,
   /* reset=*/ LCD_RST
 );
+#endif
 
-static inline float deg2rad(float d){ return d * 3.14159265359f / 180.0f; }
+// Display destino de todos los render*; en host, un buffer sin hardware
+static U8G2* s_lcd = nullptr;
 
-namespace {
+// 128x64 = 16x8 tiles; solo se mandan las filas de tiles que cambiaron
+static lcd_flush::DirtyRows<16, 8> s_flush;
 
-constexpr int CX=25, CY=25, R=24;
+static void flushDirty() {
+  PROF_SCOPE(FLUSH);
+  s_flush.flush(s_lcd->getBufferPtr(), [](uint8_t ty, uint8_t rows) {
+    s_lcd->updateDisplayArea(0, ty, 16, rows);
+  });
+}
 
-void drawCompass(float deg, bool valid) {
-  u8g2.drawCircle(CX, CY, R);
-  u8g2.drawVLine(CX, CY-R, 4); u8g2.drawVLine(CX, CY+R-4, 4);
-  u8g2.drawHLine(CX-R, CY, 4); u8g2.drawHLine(CX+R-4, CY, 4);
+namespace {
 
-  if (!valid) {
-    u8g2.drawLine(CX-6, CY-6, CX+6, CY+6);
-    u8g2.drawLine(CX-6, CY+6, CX+6, CY-6);
-    return;
-  }
+constexpr char DEG = (char)176; // '°' en las fuentes _tf de U8g2
 
-  float a = deg2rad(deg - 90.0f);
-  int x2 = CX + (int)(cosf(a) * (R - 3));
-  int y2 = CY + (int)(sinf(a) * (R - 3));
-  u8g2.drawLine(CX, CY, x2, y2);
-  u8g2.drawDisc(CX, CY, 2);
+// Percentil de latencia: "<N" por bin, ">1000" abierto, "--" sin datos
+fmt::Writer& latMs(fmt::Writer& w, uint16_t ms) {
+  if (ms == 0) return w.str("--");
+  if (ms == lat::OPEN_BIN) return w.ch('>').u(lat::EDGES_MS[lat::BINS - 2]);
+  return w.ch('<').u(ms);
 }
 
 const char* menuLabel(int idx) {
@@ -41,6 +47,8 @@ const char* menuLabel(int idx) {
     case 1: return "Factor vel.";
     case 2: return "Fuente vel.";
     case 3: return "ESP-NOW Canal";
+    case 4: return "Prom. pantalla";
+    case 5: return "Prom. NMEA";
 
     default: return "";
   }
@@ -50,22 +58,32 @@ const char* menuLabel(int idx) {
 
 namespace lcd_ui {
 
+void begin(U8G2& display) {
+  s_lcd = &display;
+  s_flush.invalidate();
+  s_lcd->begin();
+  s_lcd->clearBuffer();
+  s_lcd->setFont(u8g2_font_6x12_tf);
+  s_lcd->drawStr(0, 12, "ANEMO RX");
+  s_lcd->drawStr(0, 28, "ST7920 + ESP-NOW");
+  s_lcd->drawStr(0, 44, "Boot...");
+  flushDirty(); // primer flush: shadow vacío -> pantalla completa
+}
+
+#ifdef ARDUINO
 void begin() {
-  u8g2.begin();
-  u8g2.clearBuffer();
-  u8g2.setFont(u8g2_font_6x12_tf);
-  u8g2.drawStr(0, 12, "ANEMO RX");
-  u8g2.drawStr(0, 28, "ST7920 + ESP-NOW");
-  u8g2.drawStr(0, 44, "Boot...");
-  u8g2.sendBuffer();
+  begin(s_st7920);
 }
+#endif
 
 
 
 void renderMain(const WindPacket* p, bool ok, uint32_t /*age_ms*/,
-                float dir_deg_corrected, float speed_value, float holdProgress)
+                float dir_deg_corrected, float speed_value, float holdProgress,
+                const char* avgLabel)
 {
-  u8g2.clearBuffer();
+  PROF_SCOPE(R_MAIN);
+  s_lcd->clearBuffer();
 
   // --- Layout (128x64) ---
   const int cx = 31;
@@ -76,86 +94,73 @@ void renderMain(const WindPacket* p, bool ok, uint32_t /*age_ms*/,
   bool validDir = ok && p && ((p->status & (1u << 1)) != 0);
 
   // ===== Rosa grande =====
-  u8g2.drawCircle(cx, cy, r);
-  u8g2.drawCircle(cx, cy, r - 1);
+  s_lcd->drawCircle(cx, cy, r);
+  s_lcd->drawCircle(cx, cy, r - 1);
 
   // Marcas internas (N/E/S/O)
   const int tickOuter = r - 1;
   const int tickInner = r - 10;
 
-  u8g2.drawLine(cx, cy - tickOuter, cx, cy - tickInner); // N
-  u8g2.drawLine(cx, cy + tickOuter, cx, cy + tickInner); // S
-  u8g2.drawLine(cx - tickOuter, cy, cx - tickInner, cy); // W
-  u8g2.drawLine(cx + tickOuter, cy, cx + tickInner, cy); // E
+  s_lcd->drawLine(cx, cy - tickOuter, cx, cy - tickInner); // N
+  s_lcd->drawLine(cx, cy + tickOuter, cx, cy + tickInner); // S
+  s_lcd->drawLine(cx - tickOuter, cy, cx - tickInner, cy); // W
+  s_lcd->drawLine(cx + tickOuter, cy, cx + tickInner, cy); // E
 
   if (!validDir) {
-    u8g2.drawLine(cx - 12, cy - 12, cx + 12, cy + 12);
-    u8g2.drawLine(cx - 12, cy + 12, cx + 12, cy - 12);
+    s_lcd->drawLine(cx - 12, cy - 12, cx + 12, cy + 12);
+    s_lcd->drawLine(cx - 12, cy + 12, cx + 12, cy - 12);
   } else {
     // ===== Flecha: triángulo largo, relleno, angosto, base en el centro =====
-    float a = deg2rad(dir_deg_corrected - 90.0f);
-
-    // Punta casi en el borde
-    const float tipLen = (float)(r - 1);
-    int xt = cx + (int)(cosf(a) * tipLen);
-    int yt = cy + (int)(sinf(a) * tipLen);
+    // Punta casi en el borde, base en el centro, media base 2.5 px (en 1/16 px)
+    trig::Pt t[3];
+    trig::arrow(cx, cy, trig::fromDegF(dir_deg_corrected), (r - 1) * 16, 40, t);
 
-    // Base exactamente en el centro
-    const float baseLen = 0.0f;
-    int xb = cx + (int)(cosf(a) * baseLen);
-    int yb = cy + (int)(sinf(a) * baseLen);
-
-    // Perpendicular para ancho (más angosto)
-    const float w = 2.5f; // angosto
-    float ap = a + 1.57079632679f;
-
-    int xL = xb + (int)(cosf(ap) * w);
-    int yL = yb + (int)(sinf(ap) * w);
-    int xR = xb - (int)(cosf(ap) * w);
-    int yR = yb - (int)(sinf(ap) * w);
-
-    u8g2.drawTriangle(xt, yt, xL, yL, xR, yR);
+    s_lcd->drawTriangle(t[0].x, t[0].y, t[1].x, t[1].y, t[2].x, t[2].y);
 
     // Centro prolijo
-    u8g2.drawDisc(cx, cy, 2);
+    s_lcd->drawDisc(cx, cy, 2);
   }
 
   // ===== Textos a la derecha =====
   char b[32];
 
-  u8g2.setFont(u8g2_font_6x12_tf);
-  u8g2.drawStr(xText, 14, "DIR");
-  u8g2.drawStr(xText, 40, "SPD");
+  s_lcd->setFont(u8g2_font_6x12_tf);
+  s_lcd->drawStr(xText, 14, "DIR");
+  s_lcd->drawStr(xText, 40, "SPD");
+  if (avgLabel && avgLabel[0]) {
+    s_lcd->setFont(u8g2_font_5x8_tf);
+    s_lcd->drawStr(xText + 24, 40, avgLabel);
+  }
 
-  u8g2.setFont(u8g2_font_7x13B_tf);
-  if (ok && p) snprintf(b, sizeof(b), "%.1f%c", dir_deg_corrected, 176);
-  else        snprintf(b, sizeof(b), "--.-%c", 176);
-  u8g2.drawStr(xText, 28, b);
+  s_lcd->setFont(u8g2_font_7x13B_tf);
+  if (ok && p) fmt::Writer(b, sizeof(b)).f(dir_deg_corrected, 1).ch(DEG);
+  else        fmt::Writer(b, sizeof(b)).str("--.-").ch(DEG);
+  s_lcd->drawStr(xText, 28, b);
 
-  if (ok && p) snprintf(b, sizeof(b), "%.2f", speed_value);
-  else        snprintf(b, sizeof(b), "--.--");
-  u8g2.drawStr(xText, 54, b);
+  if (ok && p) fmt::Writer(b, sizeof(b)).f(speed_value, 2);
+  else        fmt::Writer(b, sizeof(b)).str("--.--");
+  s_lcd->drawStr(xText, 54, b);
 
   // ===== Pie: barra hold o estado =====
-  u8g2.setFont(u8g2_font_5x8_tf);
+  s_lcd->setFont(u8g2_font_5x8_tf);
 
   if (holdProgress >= 0.0f) {
     if (holdProgress > 1.0f) holdProgress = 1.0f;
 
     const int x = 0, y = 56, wBar = 128, hBar = 8;
-    u8g2.drawFrame(x, y, wBar, hBar);
+    s_lcd->drawFrame(x, y, wBar, hBar);
 
     int fill = (int)((wBar - 2) * holdProgress);
     if (fill < 0) fill = 0;
     if (fill > (wBar - 2)) fill = (wBar - 2);
 
-    u8g2.drawBox(x + 1, y + 1, fill, hBar - 2);
+    s_lcd->drawBox(x + 1, y + 1, fill, hBar - 2);
   } else {
-    if (!ok || !p) u8g2.drawStr(0, 63, "NOK");
-    else           u8g2.drawStr(0, 63, "OK");
+    if (!ok || !p) s_lcd->drawStr(0, 63, "NOK");
+    else           s_lcd->drawStr(0, 63, "OK");
   }
 
-  u8g2.sendBuffer();
+  flushDirty();
 }
 
 
@@ -163,296 +168,330 @@ void renderMain(const WindPacket* p, bool ok, uint32_t /*age_ms*/,
 void renderDiag(const WindPacket* p, bool ok, uint32_t age_ms,
                 uint32_t seq, uint16_t status,
                 const char* macStr,
-                uint32_t badLen, uint32_t badMagic, uint32_t badCrc)
+                uint32_t badLen, uint32_t badMagic, uint32_t badCrc,
+                const wstats::Mean& avg, const char* avgLabel,
+                const wstats::Extremes& gustLull,
+                const seqtrk::Summary& link,
+                const lat::Summary& latency)
 {
-  u8g2.clearBuffer();
+  PROF_SCOPE(R_DIAG);
+  s_lcd->clearBuffer();
 
-  u8g2.setFont(u8g2_font_6x12_tf);
-  u8g2.drawStr(0, 12, "Info - Diagnostico");
-  u8g2.drawLine(0,15,128,15);
-  u8g2.setFont(u8g2_font_5x8_tf);
+  // Grilla de 8 px con fuente 5x8: título + 7 líneas
+  s_lcd->setFont(u8g2_font_5x8_tf);
+  s_lcd->drawStr(0, 7, "Info - Diagnostico");
+  s_lcd->drawHLine(0, 8, 128);
   char b[32];
 
-  // Línea 1: link
-  if (!ok || !p) {
-    u8g2.drawStr(0, 24, "LINK: OFFLINE");
-  } else {
-    u8g2.drawStr(0, 24, "LINK: ONLINE");
+  // Línea 1: link + SEQ
+  fmt::Writer(b, sizeof(b)).str((!ok || !p) ? "LINK:OFF" : "LINK:ON ").str("  Seq:").u(seq);
+  s_lcd->drawStr(0, 15, b);
+
+  // Línea 2: ráfaga / calma (media 3 s, últimos 10 min)
+  {
+    fmt::Writer w(b, sizeof(b));
+    if (gustLull.valid) w.str("Raf:").f(gustLull.gust_kn, 2).str(" Calma:").f(gustLull.lull_kn, 2);
+    else                w.str("Raf:-- Calma:--");
+    s_lcd->drawStr(0, 23, b);
   }
 
-  // Línea 2: SEQ
-  snprintf(b, sizeof(b), "Sequence : %lu", (unsigned long)seq);
-  u8g2.drawStr(0, 34, b);
+  // Línea 3: AGE + STATUS
+  fmt::Writer(b, sizeof(b)).str("Age:").u(age_ms).str("ms St:0x").hex(status, 4);
+  s_lcd->drawStr(0, 31, b);
+
+  // Línea 4: promedio seleccionado para pantalla
+  {
+    fmt::Writer w(b, sizeof(b));
+    w.str(avgLabel ? avgLabel : "").ch(' ');
+    if (avg.valid) w.f(avg.spd_kn, 2).str("kn ").f(avg.dir_deg, 1).ch(DEG);
+    else           w.str("--");
+    s_lcd->drawStr(0, 39, b);
+  }
 
-  // Línea 3: AGE
-  snprintf(b, sizeof(b), "Age: %lu ms", (unsigned long)age_ms);
-  u8g2.drawStr(0, 44, b);
+  // Línea 5: pérdida 10 s / 60 s + jitter p90 (60 s)
+  {
+    fmt::Writer w(b, sizeof(b));
+    w.str("Perd ").f(link.w10.lossPct(), 1).ch('/').f(link.w60.lossPct(), 1).str("% J90");
+    const uint16_t j90 = link.w60.jitterPctMs(90);
+    if (j90 == 0)           w.str(":--");
+    else if (j90 == 0xFFFF) w.ch('>').u(seqtrk::JIT_EDGES_MS[seqtrk::JIT_BINS - 2]).str("ms");
+    else                    w.ch('<').u(j90).str("ms");
+    s_lcd->drawStr(0, 47, b);
+  }
 
-  // Línea 4: STATUS
-  snprintf(b, sizeof(b), "Status: 0x%04X", (unsigned)status);
-  u8g2.drawStr(0, 54, b);
+  // Línea 6: latencia p50/p90 sensor -> rx y rx -> LCD (último bloque de 10 s)
+  {
+    fmt::Writer w(b, sizeof(b));
+    w.str("Lat rx ");
+    latMs(w, latency.txToRx.p50).ch('/');
+    latMs(w, latency.txToRx.p90).str(" lcd ");
+    latMs(w, latency.rxToLcd.p50).ch('/');
+    latMs(w, latency.rxToLcd.p90);
+    s_lcd->drawStr(0, 55, b);
+  }
 
-  // Línea 5: MAC (abajo)
+  // Línea 7: MAC (abajo)
   if (macStr && macStr[0]) {
     // “MAC: xx:xx:...”
     char m[32];
-    snprintf(m, sizeof(m), "MAC: %s", macStr);
-    u8g2.drawStr(0, 63, m);
+    fmt::Writer(m, sizeof(m)).str("MAC: ").str(macStr);
+    s_lcd->drawStr(0, 63, m);
   } else {
     // fallback: contadores mínimos
-    snprintf(b, sizeof(b), "badL:%lu badM:%lu badC:%lu",
-             (unsigned long)badLen, (unsigned long)badMagic, (unsigned long)badCrc);
-    u8g2.drawStr(0, 63, b);
+    fmt::Writer(b, sizeof(b)).str("badL:").u(badLen)
+                              .str(" badM:").u(badMagic)
+                              .str(" badC:").u(badCrc);
+    s_lcd->drawStr(0, 63, b);
   }
 
-  u8g2.sendBuffer();
+  flushDirty();
 }
 
-void renderInfo(const WindPacket* p, bool ok, uint32_t age_ms,
-                const SettingsView& cfg,
-                float dir_corr_deg, float spd) {
-  u8g2.clearBuffer();
-  u8g2.setFont(u8g2_font_6x12_tf);
-  u8g2.drawStr(0, 12, "INFO");
-
-  u8g2.setFont(u8g2_font_5x8_tf);
-  char b[44];
-
-  if (!ok || !p) {
-    u8g2.drawStr(0, 26, "SIN DATOS");
-    snprintf(b, sizeof(b), "Offset: %d deg", (int)cfg.dir_offset_deg);
-    u8g2.drawStr(0, 40, b);
-    snprintf(b, sizeof(b), "Factor: x%.3f", cfg.speed_factor);
-    u8g2.drawStr(0, 50, b);
-    snprintf(b, sizeof(b), "Fuente: %s", (cfg.speed_src==0)?"PPS":"RPM");
-    u8g2.drawStr(0, 60, b);
-    u8g2.sendBuffer();
-    return;
+// Segunda página de DIAG: una fila por transmisor (orden de llegada)
+//   * = primario, > = preferido fijado pero sin datos frescos
+void renderPeers(const peers::Row* rows, uint8_t n, bool autoSel, uint32_t fullDrops)
+{
+  PROF_SCOPE(R_DIAG);
+  s_lcd->clearBuffer();
+
+  s_lcd->setFont(u8g2_font_5x8_tf);
+  s_lcd->drawStr(0, 7, "Info - Transmisores");
+  s_lcd->drawStr(108, 7, autoSel ? "auto" : "fijo");
+  s_lcd->drawHLine(0, 8, 128);
+
+  // 25 columnas: marca, MAC (2 últimos bytes), rx, perdidos, errores, edad
+  s_lcd->drawStr(0, 15, " MAC      rx perd err age");
+
+  char b[32];
+  uint8_t line = 0;
+  for (uint8_t i = 0; i < n && line < PEER_ROWS; i++, line++) {
+    const peers::Row& r = rows[i];
+    fmt::Writer w(b, sizeof(b));
+    w.ch(r.primary ? '*' : (r.preferred ? '>' : ' '))
+     .hex(r.mac[4], 2).ch(':').hex(r.mac[5], 2)
+     .u(r.rx, 6).u(r.lost, 5).u(r.errors, 4);
+    if (r.age_ms == peers::NO_AGE) w.str("  --");
+    else if (r.age_ms < 10000)     w.f(r.age_ms / 1000.0f, 1, 4);
+    else if (r.age_ms < 1000000)   w.u(r.age_ms / 1000, 4);
+    else                           w.str(" >1k");
+    s_lcd->drawStr(0, (int)(23 + 8 * line), b);
+  }
+
+  if (n == 0) {
+    s_lcd->drawStr(0, 23, " (sin transmisores)");
+  } else if (fullDrops && line < PEER_ROWS) {
+    fmt::Writer(b, sizeof(b)).str("Tabla llena, desc: ").u(fullDrops);
+    s_lcd->drawStr(0, (int)(23 + 8 * line), b);
   }
 
-  snprintf(b, sizeof(b), "age:%lums  seq:%lu", (unsigned long)age_ms, (unsigned long)p->seq);
-  u8g2.drawStr(0, 26, b);
-  snprintf(b, sizeof(b), "Dir: %.1f%c", dir_corr_deg, 176);
-  u8g2.drawStr(0, 38, b);
-  snprintf(b, sizeof(b), "Spd: %.2f", spd);
-  u8g2.drawStr(0, 50, b);
-  snprintf(b, sizeof(b), "Off:%d  x%.3f %s",
-           (int)cfg.dir_offset_deg, cfg.speed_factor, (cfg.speed_src==0)?"PPS":"RPM");
-  u8g2.drawStr(0, 62, b);
-
-  u8g2.sendBuffer();
+  flushDirty();
 }
 
 void renderMenu(UiMode mode, int menuIndex, const SettingsView& cfg) {
-  u8g2.clearBuffer();
+  PROF_SCOPE(R_MENU);
+  s_lcd->clearBuffer();
 
   // Marco
-  u8g2.drawFrame(0, 0, 128, 64);
+  s_lcd->drawFrame(0, 0, 128, 64);
 
   // Título
-  u8g2.setFont(u8g2_font_7x13B_tf);
-  u8g2.drawStr(6, 14, "CONFIG");
+  s_lcd->setFont(u8g2_font_7x13B_tf);
+  s_lcd->drawStr(6, 14, "CONFIG");
 
   // Subtítulo modo
-  u8g2.setFont(u8g2_font_5x8_tf);
-  u8g2.drawStr(86, 14, (mode == UiMode::EDIT) ? "EDIT" : "MENU");
+  s_lcd->setFont(u8g2_font_5x8_tf);
+  s_lcd->drawStr(86, 14, (mode == UiMode::EDIT) ? "EDIT" : "MENU");
 
   // Item (label)
-  u8g2.setFont(u8g2_font_6x12_tf);
-  u8g2.drawStr(6, 32, menuLabel(menuIndex));
+  s_lcd->setFont(u8g2_font_6x12_tf);
+  s_lcd->drawStr(6, 32, menuLabel(menuIndex));
 
   // Caja de valor
-  u8g2.drawFrame(6, 38, 116, 18);
+  s_lcd->drawFrame(6, 38, 116, 18);
 
   char v[32];
-  if (menuIndex == 0) snprintf(v, sizeof(v), "%d%c", (int)cfg.dir_offset_deg, 176);
-  else if (menuIndex == 1) snprintf(v, sizeof(v), "x%.3f", cfg.speed_factor);
-  else if (menuIndex == 2) snprintf(v, sizeof(v), "%s", (cfg.speed_src==0) ? "PPS" : "RPM");
-  else if (menuIndex == 3) snprintf(v, sizeof(v), "CH %u", (unsigned)cfg.espnow_channel);
-  else snprintf(v, sizeof(v), "-");
-
-  u8g2.setFont(u8g2_font_7x13B_tf);
-  u8g2.drawStr(10, 52, v);
+  fmt::Writer w(v, sizeof(v));
+  if (menuIndex == 0) w.i(cfg.dir_offset_deg).ch(DEG);
+  else if (menuIndex == 1) w.ch('x').f(cfg.speed_factor, 3);
+  else if (menuIndex == 2) w.str((cfg.speed_src==0) ? "PPS" : "RPM");
+  else if (menuIndex == 3) w.str("CH ").u(cfg.espnow_channel);
+  else if (menuIndex == 4) w.str(wstats::avgLabel((wstats::Avg)cfg.avg_display));
+  else if (menuIndex == 5) w.str(wstats::avgLabel((wstats::Avg)cfg.avg_nmea));
+  else w.ch('-');
+
+  s_lcd->setFont(u8g2_font_7x13B_tf);
+  s_lcd->drawStr(10, 52, v);
 
   // Footer: ayuda corta + MAC
-  u8g2.setFont(u8g2_font_5x8_tf);
+  s_lcd->setFont(u8g2_font_5x8_tf);
 
   // Footer: MAC solo en el item de Canal
   if (menuIndex == 3 && cfg.macStr && cfg.macStr[0]) {
     char m[24];
-    snprintf(m, sizeof(m), "MAC %s", cfg.macStr);
-    u8g2.drawStr(6, 63, m);
+    fmt::Writer(m, sizeof(m)).str("MAC ").str(cfg.macStr);
+    s_lcd->drawStr(6, 63, m);
   }
 
   // Ayuda muy corta (arriba del MAC si querés, o alternar)
   if (mode == UiMode::EDIT) {
-    u8g2.drawStr(6, 24, "B2:+  B3:-  OK:GUARDA");
+    s_lcd->drawStr(6, 24, "B2:+  B3:-  OK:GUARDA");
   } else {
-    u8g2.drawStr(6, 24, "B2/B3:ITEM  OK:EDIT");
+    s_lcd->drawStr(6, 24, "B2/B3:ITEM  OK:EDIT");
   }
 
-  u8g2.sendBuffer();
+  flushDirty();
 }
 
-static float wrap180f(float a) {
-  while (a > 180.0f) a -= 360.0f;
-  while (a < -180.0f) a += 360.0f;
-  return a;
-}
+// ----------------- Historial: helpers comunes a todos los tiers -----------------
+// Layout: 128x64
+// Top half: y=16..31 (vel)
+// Bottom half: y=36..62 (dir)
+// Ancho útil 120 px desde x=4 (= hist::COLS)
+namespace {
 
-void renderHist10m(const uint16_t* dir_ddeg,
-                   const uint16_t* spd_centi,
-                   uint16_t head,
-                   bool full)
-{
-  u8g2.clearBuffer();
+constexpr int HIST_X0 = 4;
+constexpr int HIST_W  = 120;
 
-  // Layout: 128x64
-  // Top half: y=14..31 (vel)
-  // Bottom half: y=36..63 (dir)
-  u8g2.drawFrame(0, 0, 128, 64);
+// Marco + título; si no hay datos suficientes muestra el aviso y flushea
+bool histHeader(const char* label, bool enough) {
+  s_lcd->clearBuffer();
+  s_lcd->drawFrame(0, 0, 128, 64);
 
-  u8g2.setFont(u8g2_font_5x8_tf);
-  u8g2.drawStr(2, 8, "10 min");
+  s_lcd->setFont(u8g2_font_5x8_tf);
+  s_lcd->drawStr(2, 8, label);
 
-  const int x0 = 4;
-  const int x1 = 123;               // ancho útil 120px
-  const int w  = x1 - x0 + 1;        // 120
+  if (!enough) {
+    s_lcd->drawStr(4, 30, "Sin datos para historico");
+    flushDirty();
+  }
+  return enough;
+}
 
-  const int topY0 = 16, topY1 = 31;  // velocidad
-  const int botY0 = 36, botY1 = 62;  // dirección
-  const int topH  = topY1 - topY0 + 1;
-  const int botH  = botY1 - botY0 + 1;
+// Sparklines: velocidad (arriba, promedio del bin) y dirección (abajo,
+// delta respecto a la media, [-90..+90] clampeado para que sea legible).
+// Todo entero: delta en BAM con wrap natural de int16.
+struct HistPlot {
+  uint16_t vmin;
+  uint16_t vmax;
+  trig::angle_t meanB;
+  int lastY = -1;
+  int lastY2 = -1;
 
-  // Si no hay datos completos, usamos lo que haya
-  const uint16_t count = full ? 600 : head;
-  if (count < 5) {
-    u8g2.setFont(u8g2_font_5x8_tf);
-    u8g2.drawStr(4, 30, "Sin datos para historico");
-    u8g2.sendBuffer();
-    return;
+  HistPlot(uint16_t lo, uint16_t hi, trig::angle_t mean) : vmin(lo), vmax(hi), meanB(mean) {
+    // Evitar división por cero en autoescala
+    if (vmax <= vmin) vmax = vmin + 1;
+
+    // Líneas separadoras
+    s_lcd->drawHLine(1, 33, 126);
+    s_lcd->drawStr(38, 8, "VEL");
+    s_lcd->drawStr(38, 41, "DIR");
   }
 
-  // Bin: 600s / 120px = 5s por columna
-  const int bin = 5;
-
-  // 1) calcular min/max velocidad para autoescala (sobre lo visible)
-  uint16_t vmin = 65535, vmax = 0;
-
-  // 2) calcular media circular global de dirección (para graficar delta sin saltos)
-  float sumS = 0, sumC = 0;
-
-  // helper: acceder a i-ésimo sample en orden temporal (más viejo->más nuevo)
-  auto sampleIndex = [&](uint16_t i) -> uint16_t {
-    // i: 0 = más viejo, count-1 = más nuevo
-    // head apunta al "próximo a escribir"
-    // el más nuevo está en head-1
-    int base = (int)head - (int)count;
-    int idx = base + (int)i;
-    while (idx < 0) idx += 600;
-    while (idx >= 600) idx -= 600;
-    return (uint16_t)idx;
-  };
-
-  for (uint16_t i = 0; i < count; i++) {
-    uint16_t idx = sampleIndex(i);
-    uint16_t v = spd_centi[idx];
-    if (v < vmin) vmin = v;
-    if (v > vmax) vmax = v;
-
-    float deg = (float)dir_ddeg[idx] * 0.1f;
-    float a = deg * 0.0174532925f;
-    sumC += cosf(a);
-    sumS += sinf(a);
+  int speedY(uint16_t v) const {
+    const int topY1 = 31, topH = 16;
+    const int32_t span = (int32_t)(vmax - vmin);
+    int32_t dv = (int32_t)v - (int32_t)vmin;
+    if (dv < 0) dv = 0;
+    if (dv > span) dv = span;
+    return topY1 - (int)((dv * (topH - 1) + span / 2) / span);
   }
 
-  float meanDeg = atan2f(sumS, sumC) * 57.2957795f;
-  if (meanDeg < 0) meanDeg += 360.0f;
+  void column(int col, uint16_t spd, trig::angle_t dirB) {
+    const int botY1 = 62, botH = 27;
+    const int32_t clampB = trig::BAM_90;
+    const int x = HIST_X0 + col;
 
-  // Evitar división por cero en autoescala
-  if (vmin == 65535) { vmin = 0; vmax = 1; }
-  if (vmax <= vmin) vmax = vmin + 1;
+    const int y = speedY(spd);
+    if (lastY >= 0) s_lcd->drawLine(x - 1, lastY, x, y);
+    lastY = y;
 
-  // Líneas separadoras
-  u8g2.drawHLine(1, 33, 126);
-  u8g2.setFont(u8g2_font_5x8_tf);
-  u8g2.drawStr(38, 8, "VEL");
-  u8g2.drawStr(38, 41, "DIR");
+    int32_t delta = (int16_t)(dirB - meanB);
+    if (delta > clampB) delta = clampB;
+    if (delta < -clampB) delta = -clampB;
 
-  // Sparkline velocidad (arriba)
-  int lastY = -1;
-  for (int col = 0; col < w; col++) {
-    // tomamos el promedio del bin (5s)
-    int start = col * bin;
-    int end   = start + bin;
-    if (end > (int)count) end = (int)count;
-
-    if (start >= (int)count) break;
-
-    uint32_t acc = 0;
-    int n = 0;
-    for (int i = start; i < end; i++) {
-      uint16_t idx = sampleIndex((uint16_t)i);
-      acc += spd_centi[idx];
-      n++;
-    }
-    uint16_t v = (n > 0) ? (uint16_t)(acc / (uint32_t)n) : vmin;
+    const int y2 = botY1 - (int)(((delta + clampB) * (botH - 1) + clampB) / (2 * clampB));
+    if (lastY2 >= 0) s_lcd->drawLine(x - 1, lastY2, x, y2);
+    lastY2 = y2;
+  }
 
-    float t = (float)(v - vmin) / (float)(vmax - vmin);
-    if (t < 0) t = 0; if (t > 1) t = 1;
+  // Etiquetas rápidas (min/max vel y mean dir) + flush
+  void finish() {
+    char buf[32];
+    fmt::Writer(buf, sizeof(buf)).f(vmin / 100.0f, 0).ch('-').f(vmax / 100.0f, 0).str(" kn");
+    s_lcd->drawStr(55, 8, buf);
 
-    int y = topY1 - (int)lroundf(t * (topH - 1));
-    int x = x0 + col;
+    fmt::Writer(buf, sizeof(buf)).str("m=").u(((trig::toDdeg(meanB) + 5) / 10) % 360u).ch(DEG);
+    s_lcd->drawStr(55, 41, buf);
 
-    if (lastY >= 0) u8g2.drawLine(x - 1, lastY, x, y);
-    lastY = y;
+    flushDirty();
   }
+};
 
-  // Sparkline dirección (abajo): delta respecto a meanDeg
-  // Mapeamos delta [-90..+90] a la altura para que sea legible (clamp)
-  const float clampDeg = 90.0f;
-  int lastY2 = -1;
+} // namespace
 
-  for (int col = 0; col < w; col++) {
-    int start = col * bin;
-    int end   = start + bin;
-    if (end > (int)count) end = (int)count;
-    if (start >= (int)count) break;
-
-    // promedio circular del bin
-    float s = 0, c = 0;
-    for (int i = start; i < end; i++) {
-      uint16_t idx = sampleIndex((uint16_t)i);
-      float deg = (float)dir_ddeg[idx] * 0.1f;
-      float a = deg * 0.0174532925f;
-      c += cosf(a);
-      s += sinf(a);
-    }
-    float binDeg = atan2f(s, c) * 57.2957795f;
-    if (binDeg < 0) binDeg += 360.0f;
+void renderHist10m(const hist::History10m& h)
+{
+  PROF_SCOPE(R_HIST);
+  // Si no hay datos completos, usamos lo que haya
+  if (!histHeader("10 min", h.count() >= 5)) return;
+
+  // Columnas de 5 s y totales ya agregados en el append: acá solo O(COLS) de dibujo
+  const uint16_t ncols = h.columnCount();
+  const hist::Totals tot = h.totals();
+
+  // autoescala por min/max (deques monótonas, O(1)) y media circular global
+  HistPlot plot(tot.min_spd, tot.max_spd, trig::atan2Bam(tot.sum_sin, tot.sum_cos));
 
-    float delta = wrap180f(binDeg - meanDeg);
-    if (delta > clampDeg) delta = clampDeg;
-    if (delta < -clampDeg) delta = -clampDeg;
+  for (uint16_t col = 0; col < ncols; col++) {
+    const hist::Column& c = h.column(col);
+    if (c.n == 0) continue;
+    plot.column(col, (uint16_t)(c.sum_spd / c.n), trig::atan2Bam(c.sum_sin, c.sum_cos));
+  }
 
-    float t = (delta + clampDeg) / (2.0f * clampDeg); // 0..1
-    int y = botY1 - (int)lroundf(t * (botH - 1));
-    int x = x0 + col;
+  plot.finish();
+}
 
-    if (lastY2 >= 0) u8g2.drawLine(x - 1, lastY2, x, y);
-    lastY2 = y;
+void renderHistTier(const hist::TierView& v, const char* label)
+{
+  PROF_SCOPE(R_TIER);
+  if (!histHeader(label, v.count >= 2)) return;
+
+  // buckets por columna: el tier lleno ocupa los 120 px
+  const uint16_t per = (uint16_t)((v.len + HIST_W - 1) / HIST_W);
+
+  // pasada 1: totales (O(buckets), sin trig flotante)
+  uint16_t vmin = 0xFFFF, vmax = 0;
+  trig::VecSum all;
+  for (uint16_t i = 0; i < v.count; i++) {
+    const hist::Bucket& b = v.at(i);
+    if (b.min_spd < vmin) vmin = b.min_spd;
+    if (b.max_spd > vmax) vmax = b.max_spd;
+    all.add(trig::fromDdeg(b.dir_ddeg));
   }
 
-  // Etiquetas rápidas (min/max vel y mean dir)
-  char buf[32];
-  u8g2.setFont(u8g2_font_5x8_tf);
-  snprintf(buf, sizeof(buf), "%.0f-%.0f kn", vmin / 100.0f, vmax / 100.0f);
-  u8g2.drawStr(55, 8, buf);
+  HistPlot plot(vmin, vmax, all.mean());
+
+  // pasada 2: una columna cada 'per' buckets; máximo de la columna como punto
+  int col = 0;
+  for (uint16_t i = 0; i < v.count; i += per, col++) {
+    uint32_t sum = 0;
+    uint16_t hi = 0, n = 0;
+    trig::VecSum dir;
+    for (uint16_t k = i; k < v.count && k < i + per; k++, n++) {
+      const hist::Bucket& b = v.at(k);
+      sum += b.mean_spd;
+      if (b.max_spd > hi) hi = b.max_spd;
+      dir.add(trig::fromDdeg(b.dir_ddeg));
+    }
+    plot.column(col, (uint16_t)(sum / n), dir.mean());
+    s_lcd->drawPixel(HIST_X0 + col, plot.speedY(hi));
+  }
 
-  snprintf(buf, sizeof(buf), "m=%.0f%c", meanDeg, 176);
-  u8g2.drawStr(55, 41, buf);
+  plot.finish();
+}
 
-  u8g2.sendBuffer();
+uint16_t lastFlushBytes() {
+  return s_flush.lastBytes();
 }
 
 } // namespace lcd_ui
@@ -2,6 +2,13 @@
 #include <Arduino.h>
 #include <stdint.h>
 #include "wind_packet.h"
+#include "wind_hist.h"
+#include "wind_stats.h"
+#include "seq_track.h"
+#include "latency.h"
+#include "peer_table.h"
+
+class U8G2;
 
 namespace lcd_ui {
 
@@ -11,25 +18,45 @@ struct SettingsView {
   uint8_t speed_src;
   uint8_t espnow_channel;   // 1..13
   const char* macStr;       // "AA:BB:CC:DD:EE:FF"
+  uint8_t avg_display;      // wstats::Avg
+  uint8_t avg_nmea;         // wstats::Avg
 };
 
 enum class UiMode : uint8_t { MAIN, MENU, EDIT };
 
+// Todos los render* dibujan en 'display' (full buffer 128x64, 16x8 tiles).
+// En el equipo es el ST7920 por SW SPI; en host, un U8G2 sin hardware.
+void begin(U8G2& display);
+#ifdef ARDUINO
 void begin();
+#endif
 void renderMain(const WindPacket* p, bool ok, uint32_t age_ms,
                 float dir_deg_corrected, float speed_value,
-                float holdProgress = -1.0f);
+                float holdProgress = -1.0f,
+                const char* avgLabel = nullptr);   // "3s", "2m"... junto a SPD
 
 void renderDiag(const WindPacket* p, bool ok, uint32_t age_ms,
                 uint32_t seq, uint16_t status,
                 const char* macStr,
-                uint32_t badLen, uint32_t badMagic, uint32_t badCrc);
+                uint32_t badLen, uint32_t badMagic, uint32_t badCrc,
+                const wstats::Mean& avg, const char* avgLabel,
+                const wstats::Extremes& gustLull,
+                const seqtrk::Summary& link,
+                const lat::Summary& latency);
+
+// DIAG página 2: hasta PEER_ROWS transmisores con seq, errores y frescura
+static constexpr uint8_t PEER_ROWS = 6;
+void renderPeers(const peers::Row* rows, uint8_t n, bool autoSel, uint32_t fullDrops);
 
 void renderMenu(UiMode mode, int menuIndex, const SettingsView& cfg);
 
-void renderHist10m(const uint16_t* dir_ddeg,
-                   const uint16_t* spd_centi,
-                   uint16_t head, bool full);
+void renderHist10m(const hist::History10m& h);
+
+// Historial de un tier grueso (1 h / 24 h): media, máximo y dirección por columna
+void renderHistTier(const hist::TierView& v, const char* label);
+
+// Bytes de framebuffer enviados al LCD en el último render (filas sucias)
+uint16_t lastFlushBytes();
 
 
 } // namespace lcd_ui
@@ -2,154 +2,152 @@
 #include <WiFi.h>
 #include <esp_WiFi.h>
 #include <esp_now.h>
-#include <Preferences.h>
 
 #include "config.h"
 #include "lcd_ui.h"
 #include "wind_packet.h"
 #include "nmea.h"
+#include "spsc_queue.h"
+#include "wind_hist.h"
+#include "trig_q15.h"
+#include "hist_journal.h"
+#include "config_store.h"
+#include "wind_stats.h"
+#include "seq_track.h"
+#include "latency.h"
+#include "prof.h"
+#include "telemetry.h"
+#include "rx_pipeline.h"
+#include "peer_table.h"
+#include "sched_wheel.h"
+#include "buttons.h"
+#include "frame_gate.h"
+#include "calib.h"
+#include "pipeline.h"
 
 // ===================== Settings persistentes =====================
-struct AppConfig {
-  int16_t dir_offset_deg = 0;   // -180..180
-  float   speed_factor  = 1.0f; // multiplicador
-  uint8_t speed_src     = 0;    // 0=PPS, 1=RPM
-  uint8_t espnow_channel = 1;  // 1..13
-};
-
+// Blob versionado con commit diferido (ver config_store.h)
 static char macStr[18] = {0}; // "AA:BB:CC:DD:EE:FF"
 
-static Preferences prefs;
+static cfgstore::PrefsKv prefsKv;
+static cfgstore::ConfigStore cfgStore;
 static AppConfig cfg;
+static calib::Tables calTables;   // cfg compilada (ver calib.h); dueño: loop()
 
-static void loadSettings() {
-  prefs.begin("anemo", true);
-  cfg.dir_offset_deg = prefs.getShort("dir_off", 0);
-  cfg.speed_factor  = prefs.getFloat("spd_fac", 1.0f);
-  cfg.speed_src     = prefs.getUChar("spd_src", 0);
-  cfg.espnow_channel = prefs.getUChar("esp_ch", 1);
-  if (cfg.espnow_channel < 1) cfg.espnow_channel = 1;
-  if (cfg.espnow_channel > 13) cfg.espnow_channel = 13;
-  prefs.end();
-
-  cfg.dir_offset_deg = constrain(cfg.dir_offset_deg, -180, 180);
-  if (!(cfg.speed_factor > 0.0001f && cfg.speed_factor < 1000.0f)) cfg.speed_factor = 1.0f;
-  cfg.speed_src = (cfg.speed_src > 1) ? 0 : cfg.speed_src;
-}
-
-static void saveSettings() {
-  prefs.begin("anemo", false);
-  prefs.putShort("dir_off", cfg.dir_offset_deg);
-  prefs.putFloat("spd_fac", cfg.speed_factor);
-  prefs.putUChar("spd_src", cfg.speed_src);
-  prefs.putUChar("esp_ch", cfg.espnow_channel);
-  prefs.end();
-}
-
-// ===================== CRC16 Modbus (para validar paquete) =====================
-static uint16_t crc16_modbus(const uint8_t* data, size_t len) {
-  uint16_t crc = 0xFFFF;
-  for (size_t i = 0; i < len; i++) {
-    crc ^= data[i];
-    for (int b = 0; b < 8; b++) {
-      if (crc & 1) crc = (crc >> 1) ^ 0xA001;
-      else         crc >>= 1;
-    }
-  }
-  return crc;
+// Después de cualquier cambio de cfg (carga, menú, $PANA)
+static void calibRebuild() {
+  calTables.compile(cfg);
 }
 
 // ===================== Estado ESPNOW =====================
+// onRecv() (task WiFi) empuja paquetes validados a la cola; loop() los drena.
+struct RxSample {
+  WindPacket pkt;
+  uint32_t rx_ms;
+};
+
+static constexpr uint32_t RX_QUEUE_LEN = 128;  // ~2.5 s a 50 Hz (una trama v2 trae hasta ~55)
+static constexpr size_t   RX_BATCH     = 8;
+
+static SpscQueue<RxSample, RX_QUEUE_LEN> rxQueue;
 static volatile uint32_t rxCount = 0;
-static volatile bool havePkt = false;
-static WindPacket lastPkt {};
-static uint32_t lastRxMs = 0;
+static TaskHandle_t loopTask = nullptr;   // onRecv lo despierta (ulTaskNotifyTake)
+
+// Jobs periódicos de loop() (ver sched_wheel.h)
+static sched::Wheel jobs;
+static uint8_t renderJob = sched::NONE;
+
+// Render: solo si cambian las entradas, período adaptativo (ver frame_gate.h)
+static fgate::Gate frameGate(fgate::Config { LCD_FPS_MS, LCD_IDLE_MS, LCD_REFRESH_MS });
+
+// Último paquete, promedios e historial (ver pipeline.h). Dueño: loop()
+static pipeline::Processor proc(NO_DATA_MS);
+
+// Pérdida / reorden / jitter del primario: se actualiza en onRecv(), loop() lee un resumen
+static seqtrk::LinkStats linkStats;
+// Un transmisor por MAC (seq, errores, frescura); elige el primario
+static peers::Table peerTable;
+static portMUX_TYPE linkMux = portMUX_INITIALIZER_UNLOCKED;   // linkStats + peerTable
 
-static uint32_t lastSeq = 0;
-static bool haveSeq = false;
+// Rechazos para la telemetría binaria (solo si está activa)
+static SpscQueue<telem::RecRej, 16> rejQueue;
 
-static uint32_t cntLost = 0;
 static uint32_t cntBadLen = 0;
 static uint32_t cntBadMagic = 0;
 static uint32_t cntBadCrc = 0;
 
 // ===================== Historial para gráficas ===================== 
-static constexpr int HIST_LEN = 600;
+// En RAM dentro de proc (10 min / 1 h / 24 h, ver wind_hist.h)
 
-static uint16_t hist_dir_ddeg[HIST_LEN]; // 0..3599
-static uint16_t hist_spd_centi[HIST_LEN]; // knots*100
-static uint16_t hist_head = 0;
-static bool hist_full = false;
+// Journal en flash: sobrevive reinicios/brownouts (partición "histlog")
+static hjournal::PartitionFlash histFlash;
+static hjournal::Journal histJournal;
+static constexpr uint32_t HIST_RESTORE_S = 24UL * 3600UL;   // cubre el tier de 24 h
 
-static uint32_t lastHistMs = 0;
+// El journal vive en su propia tarea: escribir y sobre todo borrar un sector
+// de flash (decenas de ms) no frena loop(). jobHist -> histQueue -> histTaskFn.
+static SpscQueue<hjournal::Sample, 16> histQueue;
+static TaskHandle_t histTask = nullptr;
 
 // ===================== Botones touch =====================
-struct Btn {
-  uint8_t pin = 0;
-  bool stable = false;      // estado estable
-  bool lastStable = false;  // estado estable anterior
-  uint32_t tDeb = 0;
-};
-
-static Btn b[4];
-static uint8_t btnPressMask = 0; // flancos LOW->HIGH
-static uint8_t btnDownMask  = 0; // estado estable (down=1)
-
-static inline bool press(uint8_t i) { return (btnPressMask & (1u << i)) != 0; }
-static inline bool down(uint8_t i)  { return (btnDownMask  & (1u << i)) != 0; }
+// Activos en HIGH (INPUT_PULLDOWN). Las ISR solo encolan el flanco con su
+// tiempo; debounce, LONG y auto-repeat los arma btn::Decoder en loop().
+static const uint8_t BTN_PINS[btn::COUNT] = { BTN1_PIN, BTN2_PIN, BTN3_PIN, BTN4_PIN };
+
+// Productor único: las ISR de GPIO corren de a una en el core que las registró
+static SpscQueue<btn::Edge, 32> edgeQueue;
+static btn::Decoder keys;
+
+// Evento que está procesando uiNav()
+static uint8_t btnPressMask = 0; // PRESS o REPEAT
+static uint8_t btnLongMask  = 0;
+static uint8_t btnStep      = 1; // multiplicador del REPEAT (accelStep)
+
+static inline bool press(uint8_t i)     { return (btnPressMask & (1u << i)) != 0; }
+static inline bool longPress(uint8_t i) { return (btnLongMask  & (1u << i)) != 0; }
+static inline bool down(uint8_t i)      { return keys.down(i); }
+
+static void IRAM_ATTR onBtnEdge(uint8_t i) {
+  btn::Edge e;
+  e.t_ms = millis();
+  e.id = i;
+  e.level = (uint8_t)digitalRead(BTN_PINS[i]);
+  edgeQueue.push(e); // si está llena cuenta overflow
+}
+static void IRAM_ATTR isrB1() { onBtnEdge(0); }
+static void IRAM_ATTR isrB2() { onBtnEdge(1); }
+static void IRAM_ATTR isrB3() { onBtnEdge(2); }
+static void IRAM_ATTR isrB4() { onBtnEdge(3); }
 
 static void buttonsBegin() {
-  const uint8_t pins[4] = { BTN1_PIN, BTN2_PIN, BTN3_PIN, BTN4_PIN };
-  for (int i = 0; i < 4; i++) {
-    b[i].pin = pins[i];
-    pinMode(b[i].pin, INPUT_PULLDOWN);
-    b[i].stable = digitalRead(b[i].pin);
-    b[i].lastStable = b[i].stable;
-    b[i].tDeb = millis();
+  void (*const isr[btn::COUNT])() = { isrB1, isrB2, isrB3, isrB4 };
+  uint8_t levels = 0;
+  for (uint8_t i = 0; i < btn::COUNT; i++) {
+    pinMode(BTN_PINS[i], INPUT_PULLDOWN);
+    if (digitalRead(BTN_PINS[i])) levels |= (uint8_t)(1u << i);
+  }
+  keys.setLongMs(3, MENU_HOLD_MS); // B4 sostenido -> Config
+  keys.begin(millis(), levels);
+  for (uint8_t i = 0; i < btn::COUNT; i++) {
+    attachInterrupt(digitalPinToInterrupt(BTN_PINS[i]), isr[i], CHANGE);
   }
 }
 
-static void buttonsPoll() {
-  const uint32_t now = millis();
-  const uint32_t DB = 60;
-
-  btnPressMask = 0;
-  btnDownMask = 0;
-
-  for (int i = 0; i < 4; i++) {
-    bool raw = digitalRead(b[i].pin);
-
-    if (raw != b[i].stable) {
-      if ((now - b[i].tDeb) >= DB) {
-        b[i].lastStable = b[i].stable;
-        b[i].stable = raw;
-        b[i].tDeb = now;
-
-        // flanco LOW->HIGH
-        if (b[i].lastStable == false && b[i].stable == true) {
-          btnPressMask |= (1u << i);
-        }
-      }
-    } else {
-      b[i].tDeb = now; // estable: resetea ventana
-    }
-
-    if (b[i].stable) btnDownMask |= (1u << i);
-  }
+// Flancos de la ISR -> decoder (el orden de la cola es el orden de tiempo)
+static void buttonsPoll(uint32_t now) {
+  btn::Edge e;
+  while (edgeQueue.pop(e)) keys.onEdge(e);
+  keys.poll(now);
 }
 
 // ===================== UI: pantallas y menú =====================
-enum class Screen : uint8_t { MAIN, DIAG, HIST };
+enum class Screen : uint8_t { MAIN, DIAG, DIAG_PEERS, HIST, HIST_1H, HIST_24H };
 static Screen screen = Screen::MAIN;
 
 static bool inConfig = false;
 static lcd_ui::UiMode uiMode = lcd_ui::UiMode::MENU;
 static int menuIndex = 0;
-static constexpr int MENU_COUNT = 4;
-
-// Hold OK para entrar a CONFIG
-static bool okHoldArmed = false;
-static uint32_t okHoldStartMs = 0;
+static constexpr int MENU_COUNT = 6;
 
 static void enterConfig() {
   inConfig = true;
@@ -164,67 +162,119 @@ static void exitConfigToMain() {
 
 static void toggleScreen() {
   if (screen == Screen::MAIN) screen = Screen::DIAG;
-  else if (screen == Screen::DIAG) screen = Screen::HIST;
+  else if (screen == Screen::DIAG) screen = Screen::DIAG_PEERS;
+  else if (screen == Screen::DIAG_PEERS) screen = Screen::HIST;
+  else if (screen == Screen::HIST) screen = Screen::HIST_1H;
+  else if (screen == Screen::HIST_1H) screen = Screen::HIST_24H;
   else screen = Screen::MAIN;
 }
 
 // ===================== ESPNOW callback =====================
-static void onRecv(const uint8_t* mac, const uint8_t* data, int len) {
-  (void)mac;
+static void pushReject(uint8_t reason, int len, uint32_t seq, uint32_t rxMs) {
+  if (!telem::enabled()) return;
+  telem::RecRej rr;
+  rr.rx_ms  = rxMs;
+  rr.reason = reason;
+  rr.len    = (len < 0) ? 0 : (len > 255 ? 255 : (uint8_t)len);
+  rr.seq    = seq;
+  rejQueue.push(rr);
+}
 
-  
+static void onRecv(const uint8_t* mac, const uint8_t* data, int len) {
   rxCount++;
 
-  if (len != (int)sizeof(WindPacket)) {
-    cntBadLen++;
-    return;
+  // v1 (1 muestra) o v2 (N muestras delta): se valida la trama entera
+  rxpipe::FrameReader frame;
+  const rxpipe::Verdict v = frame.open(data, len);
+  if (v != rxpipe::Verdict::OK) {
+    // solo se atribuye a transmisores conocidos: basura de una MAC nueva no ocupa la tabla
+    const peers::Err e = (v == rxpipe::Verdict::BAD_LEN)   ? peers::Err::LEN
+                       : (v == rxpipe::Verdict::BAD_MAGIC) ? peers::Err::MAGIC : peers::Err::CRC;
+    portENTER_CRITICAL(&linkMux);
+    const uint8_t id = peerTable.find(mac);
+    if (id != peers::NONE) peerTable.onError(id, e);
+    portEXIT_CRITICAL(&linkMux);
   }
 
-  WindPacket pkt;
-  memcpy(&pkt, data, sizeof(pkt));
-
-  if (pkt.magic != WIND_MAGIC || pkt.version != WIND_VER) {
-    cntBadMagic++;
-    return;
+  switch (v) {
+    case rxpipe::Verdict::BAD_LEN:
+      cntBadLen++;
+      pushReject(telem::REJ_LEN, len, 0, millis());
+      return;
+    case rxpipe::Verdict::BAD_MAGIC:
+      cntBadMagic++;
+      pushReject(telem::REJ_MAGIC, len, frame.seq(), millis());
+      return;
+    case rxpipe::Verdict::BAD_CRC:
+      cntBadCrc++;
+      pushReject(telem::REJ_CRC, len, frame.seq(), millis());
+      return;
+    default:
+      break;
   }
 
-  // CRC de todo menos el campo crc16
-  const uint16_t calc = crc16_modbus((const uint8_t*)&pkt, sizeof(WindPacket) - sizeof(pkt.crc16));
-  if (calc != pkt.crc16) {
-    cntBadCrc++;
-    return;
-  }
+  // tabla por MAC (O(1), sin reservar) y lost / late / dup del primario
+  const uint32_t rxMs = millis();
+  portENTER_CRITICAL(&linkMux);
+  const uint8_t id = peerTable.findOrAdd(mac);
+  portEXIT_CRITICAL(&linkMux);
+  if (id == peers::NONE) return;
 
-  // lost por seq
-  if (haveSeq) {
-    const uint32_t expect = lastSeq + 1;
-    if (pkt.seq != expect) {
-      if (pkt.seq > expect) cntLost += (pkt.seq - expect);
-      else cntLost++; // wrap o reorder raro, cuenta 1
+  // cada muestra sigue el camino de un paquete v1 (un lock corto por muestra)
+  WindPacket pkt;
+  bool queued = false;
+  bool arrival = false;   // alguna muestra nueva del primario: una llegada para el jitter
+  while (frame.next(pkt)) {
+    seqtrk::Kind k = seqtrk::Kind::FIRST;
+    portENTER_CRITICAL(&linkMux);
+    peerTable.onPacket(id, pkt, rxMs);
+    const bool primary = (id == peerTable.primary());
+    if (primary) k = linkStats.onPacket(pkt.seq, rxMs);
+    portEXIT_CRITICAL(&linkMux);
+    // los demás transmisores solo actualizan su fila
+    if (!primary) continue;
+    if (k != seqtrk::Kind::DUP && k != seqtrk::Kind::OLD) arrival = true;
+
+    // solo avanza el pipeline con paquetes nuevos en orden (proc.last() no retrocede)
+    if (k == seqtrk::Kind::DUP || k == seqtrk::Kind::OLD || k == seqtrk::Kind::LATE) {
+      pushReject(k == seqtrk::Kind::DUP ? telem::REJ_DUP
+               : k == seqtrk::Kind::OLD ? telem::REJ_OLD : telem::REJ_LATE, len, pkt.seq, rxMs);
+      continue;
     }
+
+    RxSample rs;
+    rs.pkt = pkt;
+    rs.rx_ms = rxMs;
+    rxQueue.push(rs); // si está llena cuenta overflow
+    queued = true;
   }
-  lastSeq = pkt.seq;
-  haveSeq = true;
 
-  lastPkt = pkt;
-  lastRxMs = millis();
-  havePkt = true;
+  if (arrival) {
+    portENTER_CRITICAL(&linkMux);
+    linkStats.onArrival(rxMs);
+    portEXIT_CRITICAL(&linkMux);
+  }
+  if (queued && loopTask) xTaskNotifyGive(loopTask);
 }
 
 
+// Los logs de texto de canal / ESP-NOW se callan con la telemetría binaria
+// encendida ('b'): espnowRestart() puede venir de $PANA,CH en cualquier momento.
 static void printChannel(const char* tag) {
+  if (telem::enabled()) return;
   uint8_t ch; wifi_second_chan_t sch;
   esp_err_t e = esp_wifi_get_channel(&ch, &sch);
   Serial.printf("[%s] get_channel err=%d ch=%u\n", tag, (int)e, ch);
 }
 
 static void forceChannel(uint8_t ch) {
+  const bool log = !telem::enabled();
   WiFi.mode(WIFI_STA);
   delay(150);
 
   // Asegurar que el driver WiFi esté iniciado
   esp_err_t s = esp_wifi_start();
-  Serial.printf("[WiFi] start=%d\n", (int)s);
+  if (log) Serial.printf("[WiFi] start=%d\n", (int)s);
 
   // (opcional) apagar power save
   esp_wifi_set_ps(WIFI_PS_NONE);
@@ -234,19 +284,19 @@ static void forceChannel(uint8_t ch) {
   esp_err_t e2 = esp_wifi_set_channel(ch, WIFI_SECOND_CHAN_NONE);
   esp_err_t e3 = esp_wifi_set_promiscuous(false);
 
-  Serial.printf("[CH] prom_on=%d set_ch=%d prom_off=%d (want %u)\n",
+  if (log) Serial.printf("[CH] prom_on=%d set_ch=%d prom_off=%d (want %u)\n",
                 (int)e1, (int)e2, (int)e3, ch);
 
   uint8_t nowCh; wifi_second_chan_t sch;
   esp_err_t g = esp_wifi_get_channel(&nowCh, &sch);
-  Serial.printf("[CH] get_channel=%d ch=%u\n", (int)g, nowCh);
+  if (log) Serial.printf("[CH] get_channel=%d ch=%u\n", (int)g, nowCh);
 }
 
 static void espnowBegin() {
   Serial.printf("[WiFi] STA MAC=%s\n", WiFi.macAddress().c_str());
   printChannel("BEFORE");
 
-  forceChannel(1);   // <-- ACA queda canal 1 sí o sí (o te muestra el error)
+  forceChannel(cfg.espnow_channel);
 
   esp_err_t e = esp_now_init();
   Serial.printf("[ESP-NOW] init=%d\n", (int)e);
@@ -258,87 +308,220 @@ static void espnowBegin() {
 
 
 
-// ===================== Setup/Loop =====================
-void setup() {
- 
-  Serial.begin(115200);
- 
-  // Elegí el baud NMEA
-  // - NMEA 0183 clásico: 4800
-  // - NMEA “rápido” (AIS): 38400
-  // - Si es tu propio enlace TTL: podés usar 9600/115200, pero para compatibilidad NMEA: 4800
-  Serial2.begin(4800, SERIAL_8N1, RX2_PIN, TX2_PIN);
-  delay(200);
+// Reaplicar canal en vivo
+static void espnowRestart() {
+  esp_now_deinit();
+  forceChannel(cfg.espnow_channel);
 
+  esp_err_t e = esp_now_init();
+  if (e == ESP_OK) esp_now_register_recv_cb(onRecv);
+  if (telem::enabled()) return;
+  Serial.printf("[ESP-NOW] reinit=%d ch=%u\n", (int)e, cfg.espnow_channel);
+  if (e == ESP_OK) Serial.println("[ESP-NOW] recv_cb registered OK");
+}
 
-  loadSettings();
-  buttonsBegin();
-  lcd_ui::begin();
+// ===================== NMEA IN: comandos propietarios =====================
+// $PANA,CH,1*hh    -> canal ESP-NOW (1..13)
+// $PANA,OFF,-12*hh -> offset de proa (-180..180)
+// $PANA,FAC,1.23*hh -> factor de velocidad
+// $PANA,SRC,2*hh   -> transmisor primario fijo (orden en DIAG, 0 = auto)
+// $PANA,SCAL,0,0,5.0,4.6,20.0,19.1*hh -> curva PPS/RPM -> kn (2..8 pares, sin pares = lineal)
+// $PANA,DDEV,3,-4.5*hh -> desvío del sensor en 3*45° (0..7, +-30°); DDEV,CLR los borra
+
+// Pares (entrada, kn) de SCAL; false si no es una curva válida
+static bool parseCurve(const nmea::Sentence& st, AppConfig& c) {
+  const uint8_t nv = (uint8_t)(st.nfields - 1);
+  if (nv % 2 || nv / 2 > CAL_SPD_POINTS || nv == 2) return false;
+  c.spd_cal_n = nv / 2;
+  for (uint8_t i = 0; i < c.spd_cal_n; i++) {
+    char* end = nullptr;
+    const float x = strtof(st.field[1 + 2 * i], &end);
+    if (end == st.field[1 + 2 * i] || !(x >= 0.0f && x < 655.0f)) return false;
+    const float y = strtof(st.field[2 + 2 * i], &end);
+    if (end == st.field[2 + 2 * i] || !(y >= 0.0f && y < 655.0f)) return false;
+    c.spd_cal_in[i]  = (uint16_t)lroundf(x * 100.0f);
+    c.spd_cal_out[i] = (uint16_t)lroundf(y * 100.0f);
+  }
+  const uint8_t n = c.spd_cal_n;
+  sanitizeConfig(c);
+  return c.spd_cal_n == n;   // sanitize la anula si no es creciente / está muy junta
+}
 
-  // WiFi/Channel/ESPNOW
-  Serial.printf("[WiFi] STA MAC=%s\n", WiFi.macAddress().c_str());
-  forceChannel(cfg.espnow_channel);
+static void onPana(const nmea::Sentence& st, void*) {
+  if (st.nfields < 1) return;
+  const char* cmd = st.field[0];
+  const char* arg = (st.nfields > 1) ? st.field[1] : "";
+  if (st.nfields < 2 && strcmp(cmd, "SCAL") != 0) return;
+  char* end = nullptr;
+
+  if (strcmp(cmd, "CH") == 0) {
+    const long ch = strtol(arg, &end, 10);
+    if (end == arg || ch < 1 || ch > 13) return;
+    cfg.espnow_channel = (uint8_t)ch;
+    cfgStore.markDirty(millis());
+    espnowRestart();
+  } else if (strcmp(cmd, "OFF") == 0) {
+    const long off = strtol(arg, &end, 10);
+    if (end == arg || off < -180 || off > 180) return;
+    cfg.dir_offset_deg = (int16_t)off;
+    cfgStore.markDirty(millis());
+  } else if (strcmp(cmd, "SRC") == 0) {
+    const long n = strtol(arg, &end, 10);
+    if (end == arg || n < 0 || n > peers::MAX_PEERS) return;
+    portENTER_CRITICAL(&linkMux);
+    peerTable.setPreferred(n == 0 ? peers::NONE : (uint8_t)(n - 1));
+    portEXIT_CRITICAL(&linkMux);
+  } else if (strcmp(cmd, "FAC") == 0) {
+    const float f = strtof(arg, &end);
+    if (end == arg || !(f > 0.0001f && f < 1000.0f)) return;
+    cfg.speed_factor = f;
+    cfgStore.markDirty(millis());
+  } else if (strcmp(cmd, "SCAL") == 0) {
+    AppConfig c = cfg;
+    if (!parseCurve(st, c)) return;
+    cfg = c;
+    cfgStore.markDirty(millis());
+  } else if (strcmp(cmd, "DDEV") == 0) {
+    if (strcmp(arg, "CLR") == 0) {
+      for (int16_t& d : cfg.dir_dev_cdeg) d = 0;
+    } else {
+      const long k = strtol(arg, &end, 10);
+      if (end == arg || k < 0 || k >= CAL_DIR_POINTS || st.nfields < 3) return;
+      const float dev = strtof(st.field[2], &end);
+      if (end == st.field[2] || !(fabsf(dev) * 100.0f <= CAL_DEV_MAX_CDEG)) return;
+      cfg.dir_dev_cdeg[k] = (int16_t)lroundf(dev * 100.0f);
+    }
+    cfgStore.markDirty(millis());
+  } else {
+    return;
+  }
+  calibRebuild();
+  if (!telem::enabled()) Serial.printf("[NMEA IN] PANA %s=%s\n", cmd, arg);
+}
 
+// ===================== Procesamiento de muestras (loop) =====================
+// Todas las muestras de la cola pasan por acá, no solo la última antes del render.
+static lat::LatencyStats<RX_QUEUE_LEN> latStats;    // sensor -> rx -> LCD
+
+static void processSample(const RxSample& rs) {
+  const WindPacket& p = rs.pkt;
+  const rxpipe::Derived dv = proc.onSample(p, rs.rx_ms, calTables);
+  latStats.onSample(p.timestamp_ms, rs.rx_ms, rs.rx_ms);
+
+  if (telem::enabled()) {
+    telem::RecPkt tr;
+    tr.rx_ms = rs.rx_ms;
+    tr.pkt = p;
+    tr.dir_cdeg = dv.dir_cdeg;
+    tr.spd_centi = dv.spd_centi;
+    telem::pushPkt(tr);
+  }
+}
 
-  esp_err_t e = esp_now_init();
-  Serial.printf("[ESP-NOW] init=%d\n", (int)e);
-  if (e == ESP_OK) {
-    esp_now_register_recv_cb(onRecv);
-    Serial.println("[ESP-NOW] recv_cb registered OK");
+// Resumen de enlace para UI/log (el callback escribe en otra task)
+static seqtrk::Summary linkSummary(uint32_t now) {
+  portENTER_CRITICAL(&linkMux);
+  linkStats.advance(now);
+  const seqtrk::Summary s = linkStats.summary();
+  portEXIT_CRITICAL(&linkMux);
+  return s;
+}
+
+// Copia de las filas de la tabla para UI/log
+static uint8_t peerSnapshot(uint32_t now, peers::Row* rows) {
+  portENTER_CRITICAL(&linkMux);
+  const uint8_t n = peerTable.rows(rows, peers::MAX_PEERS, now);
+  portEXIT_CRITICAL(&linkMux);
+  return n;
+}
+
+// auto -> 1ro -> 2do ... -> auto
+static void cyclePreferred() {
+  portENTER_CRITICAL(&linkMux);
+  const uint8_t cur = peerTable.preferred();
+  peerTable.setPreferred(cur == peers::NONE ? 0 : (uint8_t)(cur + 1));   // fuera de rango = auto
+  portEXIT_CRITICAL(&linkMux);
+}
+
+// Failover: si el primario se calla (NO_DATA_MS) pasa al transmisor fresco
+// más reciente; vuelve al preferido apenas tenga datos
+static void peerFailover(uint32_t now) {
+  uint8_t mac[6];
+  portENTER_CRITICAL(&linkMux);
+  const bool switched = peerTable.update(now, NO_DATA_MS);
+  if (switched) {
+    linkStats = seqtrk::LinkStats();   // otra secuencia: ventanas desde cero
+    memcpy(mac, peerTable.peer(peerTable.primary()).mac, sizeof(mac));
   }
+  portEXIT_CRITICAL(&linkMux);
 
-  String mac = WiFi.macAddress();
-  snprintf(macStr, sizeof(macStr), "%s", mac.c_str());
+  if (switched && !telem::enabled()) {
+    Serial.printf("[PEER] primario -> %02X:%02X:%02X:%02X:%02X:%02X\n",
+                  mac[0], mac[1], mac[2], mac[3], mac[4], mac[5]);
+  }
+}
 
-  nmea::Config nc;
-  nc.enabled_out = true;
-  nc.enabled_in  = false;   // lo activamos cuando quieras
-  nc.out_period_ms = 1000;  // 1 Hz
-  nc.talker = "WI";
-  nmea::begin(Serial2, nc);
+static void drainRx() {
+  RxSample batch[RX_BATCH];
+  size_t n;
+  while ((n = rxQueue.popBatch(batch, RX_BATCH)) > 0) {
+    for (size_t i = 0; i < n; i++) processSample(batch[i]);
+  }
 
+  telem::RecRej rr;
+  while (rejQueue.pop(rr)) telem::pushRej(rr);
 }
 
-void loop() {
-  const uint32_t now = millis();
-  static uint32_t lastLogMs = 0;
-  static uint32_t lastRxCount = 0;
-  static bool lastOk = false;
-  static float lastDirCorrDeg = 0.0f;
-  static float lastSpdKn      = 0.0f;
-  static bool  lastOkForNmea  = false;
-  
-  buttonsPoll();
-
-  // ---- Estado datos ----
-  bool ok = havePkt;
-  uint32_t age = ok ? (now - lastRxMs) : 0;
-  if (!ok || age > NO_DATA_MS) ok = false;
-
-  // ---- OK hold para entrar config (con lockout hasta soltar) ----
-  if (!inConfig) {
-    if (down(3)) { // B4
-      if (!okHoldArmed) {
-        okHoldArmed = true;
-        okHoldStartMs = now;
-      } else {
-        if ((now - okHoldStartMs) >= MENU_HOLD_MS) {
-          enterConfig();
-          okHoldArmed = false; // lockout: no re-entra hasta soltar
-        }
-      }
-    } else {
-      okHoldArmed = false;
-    }
-  } else {
-    okHoldArmed = false;
+static void histTaskFn(void*) {
+  for (;;) {
+    ulTaskNotifyTake(pdTRUE, portMAX_DELAY);
+    hjournal::Sample s;
+    while (histQueue.pop(s)) histJournal.append(s.dir_ddeg, s.spd_centi);
+    // deja borrado el sector siguiente mucho antes de llegar a él
+    histJournal.prepare();
+  }
+}
+
+static void histRestore() {
+  // Sin reloj de pared: después de un power-on no se sabe cuánto estuvo
+  // apagado, y el journal no devuelve lo de antes (se vería como reciente).
+  // Reinicios breves (software, watchdog, panic, brownout) sí se restauran.
+  const esp_reset_reason_t why = esp_reset_reason();
+  const bool cold = (why == ESP_RST_POWERON || why == ESP_RST_UNKNOWN);
+  if (!histFlash.begin("histlog") || !histJournal.begin(histFlash, cold)) {
+    Serial.println("[HIST] journal no disponible");
+    return;
+  }
+
+  const uint32_t t0 = millis();
+  const uint32_t n = histJournal.replay(HIST_RESTORE_S, [](uint16_t dir, uint16_t spd, void*) {
+    proc.history().append(dir, spd);
+  }, nullptr);
+
+  Serial.printf("[HIST] restore %lu muestras en %lums (reset=%d%s, paginas malas=%lu)\n",
+                (unsigned long)n, (unsigned long)(millis() - t0), (int)why, cold ? " en frio" : "",
+                (unsigned long)histJournal.stats().bad_pages);
+
+  // core 0 (loop corre en el 1), misma prioridad que loopTask
+  xTaskCreatePinnedToCore(histTaskFn, "hist", 3072, nullptr, 1, &histTask, 0);
+}
+
+// ===================== Navegación (botones -> pantallas / menú) =====================
+// Se llama una vez por evento de botón (ver jobButtons)
+static void uiNav() {
+  // ---- OK sostenido (LONG de B4) para entrar config; uno por apretada ----
+  if (!inConfig && longPress(3)) {
+    enterConfig();
   }
 
   // ---- Navegación ----
   if (!inConfig) {
-    if (press(0) || press(1)) { // B1 o B2 alterna MAIN/DIAG
+    if (press(0) || press(1)) { // B1 o B2 rota MAIN/DIAG/HIST...
       toggleScreen();
     }
+    if (press(2) && screen == Screen::DIAG_PEERS) { // B3: primario fijo / auto
+      cyclePreferred();
+    }
   } else {
     // CONFIG: MENU o EDIT
     if (uiMode == lcd_ui::UiMode::MENU) {
@@ -352,35 +535,26 @@ void loop() {
         menuIndex = (menuIndex + MENU_COUNT - 1) % MENU_COUNT;
       }
       if (press(3)) { // OK -> editar
+        cfgStore.beginSession();
         uiMode = lcd_ui::UiMode::EDIT;
       }
     } else { // EDIT
-      if (press(0)) { // B1 volver sin guardar
+      if (press(0)) { // B1 volver sin guardar (descarta lo de esta edición)
+        cfgStore.revert();
         uiMode = lcd_ui::UiMode::MENU;
       }
-      if (press(3)) { // OK guardar y volver
-        saveSettings();
-        if (menuIndex == 3) {
-          // Reaplicar canal en vivo
-          esp_now_deinit();
-          forceChannel(cfg.espnow_channel);
-
-          esp_err_t e = esp_now_init();
-          Serial.printf("[ESP-NOW] reinit=%d ch=%u\n", (int)e, cfg.espnow_channel);
-          if (e == ESP_OK) {
-            esp_now_register_recv_cb(onRecv);
-            Serial.println("[ESP-NOW] recv_cb registered OK");
-          }
-        }
+      if (press(3)) { // OK guardar y volver (commit al cerrar la sesión)
+        cfgStore.endSession();
+        if (menuIndex == 3) espnowRestart();
         uiMode = lcd_ui::UiMode::MENU;
       }
 
       if (menuIndex == 0) { // Offset proa
-        if (press(1)) cfg.dir_offset_deg = min<int16_t>(180, cfg.dir_offset_deg + 1);
-        if (press(2)) cfg.dir_offset_deg = max<int16_t>(-180, cfg.dir_offset_deg - 1);
+        if (press(1)) cfg.dir_offset_deg = (int16_t)min(180, cfg.dir_offset_deg + btnStep);
+        if (press(2)) cfg.dir_offset_deg = (int16_t)max(-180, cfg.dir_offset_deg - btnStep);
       } else if (menuIndex == 1) { // Factor vel.
-        if (press(1)) cfg.speed_factor += 0.01f;
-        if (press(2)) cfg.speed_factor = max(0.01f, cfg.speed_factor - 0.01f);
+        if (press(1)) cfg.speed_factor += 0.01f * btnStep;
+        if (press(2)) cfg.speed_factor = max(0.01f, cfg.speed_factor - 0.01f * btnStep);
       } else if (menuIndex == 2) { // Fuente vel.
         if (press(1) || press(2)) cfg.speed_src = (cfg.speed_src == 0) ? 1 : 0;
       }
@@ -388,124 +562,364 @@ void loop() {
         if (press(1)) cfg.espnow_channel = min<uint8_t>(13, cfg.espnow_channel + 1);
         if (press(2)) cfg.espnow_channel = max<uint8_t>(1,  cfg.espnow_channel - 1);
       }
+      else if (menuIndex == 4 || menuIndex == 5) { // Promedio pantalla / NMEA
+        uint8_t& a = (menuIndex == 4) ? cfg.avg_display : cfg.avg_nmea;
+        const uint8_t n = (uint8_t)wstats::Avg::COUNT;
+        if (press(1)) a = (uint8_t)((a + 1) % n);
+        if (press(2)) a = (uint8_t)((a + n - 1) % n);
+      }
     }
   }
+}
 
-  // ---- Render (5 Hz) ----
-  static uint32_t lastUiMs = 0;
-  if ((now - lastUiMs) >= LCD_FPS_MS) {
-    lastUiMs = now;
-
-    // Cálculos
-    const WindPacket* p = (ok) ? &lastPkt : nullptr;
-   
-    lastOkForNmea = ok; // default, se setea true si el paquete es OK y se procesa para NMEA
-
-    float dirRawDeg = 0.0f;
-    float dirCorrDeg = 0.0f;
-    float pps = 0.0f;
-    float rpm = 0.0f;
-    float spd = 0.0f;
-
-    if (p) {
-      dirRawDeg  = (float)p->raw_angle * 360.0f / 4096.0f;
-      dirCorrDeg = (float)p->angle_cdeg / 100.0f;
-
-      // aplica offset (convención simple)
-      dirCorrDeg += (float)cfg.dir_offset_deg;
-      while (dirCorrDeg < 0)   dirCorrDeg += 360.0f;
-      while (dirCorrDeg >= 360.0f) dirCorrDeg -= 360.0f;
-
-      pps = (float)p->pps_centi / 100.0f;
-      rpm = (float)p->rpm_centi / 100.0f;
-
-      float base = (cfg.speed_src == 0) ? pps : rpm;
-      spd = base * cfg.speed_factor;
-      
-      if (ok && p) {
-        lastDirCorrDeg = dirCorrDeg;
-        lastSpdKn      = spd;
-      }
-      
-      lastDirCorrDeg = dirCorrDeg;
-      lastSpdKn      = spd;
-      // ---- HIST 10 min (1 Hz) ----
-      if ((now - lastHistMs) >= 1000) {
-        lastHistMs = now;
+// Estadísticas de los jobs: runs, overruns (períodos salteados) y peor atraso
+static void printJobs() {
+  for (uint8_t id = 0; id < sched::MAX_JOBS; id++) {
+    if (!jobs.active(id)) continue;
+    const sched::JobStats& st = jobs.stats(id);
+    Serial.printf("[JOB] %-8s %5lums runs=%lu ovr=%lu skip=%lu late=%lums\n", jobs.name(id),
+                  (unsigned long)jobs.period(id), (unsigned long)st.runs, (unsigned long)st.overruns,
+                  (unsigned long)st.skipped, (unsigned long)st.maxLateMs);
+  }
+}
+
+// Calibración vigente: puntos guardados y qué sale de las tablas
+static void printCalib() {
+  Serial.printf("[CAL] src=%s factor=%.3f offset=%d tramos=%u\n", cfg.speed_src ? "RPM" : "PPS",
+                cfg.speed_factor, (int)cfg.dir_offset_deg, (unsigned)calTables.segments());
+  for (uint8_t i = 0; i < cfg.spd_cal_n; i++) {
+    Serial.printf("[CAL] %6.2f -> %6.2f kn (tabla %6.2f)\n", cfg.spd_cal_in[i] / 100.0f,
+                  cfg.spd_cal_out[i] / 100.0f, calTables.speedCenti(cfg.spd_cal_in[i]) / 100.0f);
+  }
+  for (uint8_t k = 0; k < CAL_DIR_POINTS; k++) {
+    const uint16_t a = (uint16_t)(k * 4500);
+    Serial.printf("[CAL] %3u deg desvio %+5.1f -> %6.2f\n", (unsigned)(k * 45),
+                  cfg.dir_dev_cdeg[k] / 100.0f, calTables.dirCdeg(a) / 100.0f);
+  }
+}
 
-        uint16_t d = (uint16_t)lroundf(dirCorrDeg * 10.0f); // 0..3599
-        if (d >= 3600) d %= 3600;
+// Consola USB: comandos de una letra para diagnóstico
+static void consolePoll() {
+  while (Serial.available() > 0) {
+    const int c = Serial.read();
+    // los reportes de texto romperían el stream binario
+    if (c == 'p' && !telem::enabled()) prof::report(Serial);
+    else if (c == 'r') { prof::reset(); jobs.resetStats(); frameGate.resetStats(); }
+    else if (c == 's' && !telem::enabled()) printJobs();
+    else if (c == 'c' && !telem::enabled()) printCalib();
+    else if (c == 'b') telem::setEnabled(true);    // binario (COBS), sin log de texto
+    else if (c == 't') telem::setEnabled(false);   // vuelve al texto
+  }
+}
 
-        uint16_t s = (uint16_t)lroundf(spd * 100.0f);       // kn*100
+// ===================== Jobs (loop) =====================
+// Cada tarea periódica es un job independiente del timer wheel: los plazos
+// no dependen de que otro job haya corrido y loop() duerme hasta el próximo.
 
-        hist_dir_ddeg[hist_head]  = d;
-        hist_spd_centi[hist_head] = s;
+// Items de EDIT numéricos: B2/B3 sostenidos repiten (offset, factor, canal)
+static uint8_t repeatMask() {
+  if (!inConfig || uiMode != lcd_ui::UiMode::EDIT) return 0;
+  if (menuIndex == 0 || menuIndex == 1 || menuIndex == 3) return 0x06;
+  return 0;
+}
 
-        hist_head = (hist_head + 1) % HIST_LEN;
-        if (hist_head == 0) hist_full = true;
-      }
-    } else {
-      lastOkForNmea = ok; // cuando p=null, ok es false, queda bien
-    }
-    
+static void jobButtons(uint32_t now, void*) {
+  {
+    PROF_SCOPE(BUTTONS);
+    keys.setRepeatMask(repeatMask());
+    buttonsPoll(now);
+  }
+  PROF_SCOPE(NAV);
+  btn::Event ev;
+  bool any = false;
+  while (keys.next(ev)) {
+    any = true;
+    const uint8_t bit = (uint8_t)(1u << ev.id);
+    btnPressMask = (ev.type == btn::Ev::PRESS || ev.type == btn::Ev::REPEAT) ? bit : 0;
+    btnLongMask  = (ev.type == btn::Ev::LONG) ? bit : 0;
+    btnStep      = (ev.type == btn::Ev::REPEAT) ? btn::accelStep(ev.rep) : 1;
+    uiNav();
+  }
+  btnPressMask = btnLongMask = 0;
+
+  // el menú edita cfg en vivo (y revert la restaura)
+  if (any && inConfig) calibRebuild();
 
+  // respuesta inmediata en pantalla, sin esperar el período (quizás lento) del render
+  if (any) jobs.kick(renderJob, now);
+}
 
+// HIST 10 min (1 Hz, media de todas las muestras del segundo)
+static void jobHist(uint32_t, void*) {
+  PROF_SCOPE(HIST);
+  uint16_t d, s;
+  if (!proc.closeSecond(d, s)) return;
+  histQueue.push(hjournal::Sample{d, s}); // si está llena cuenta overflow
+  if (histTask) xTaskNotifyGive(histTask);
+}
 
-    // hold progress (solo MAIN, solo mientras está armado)
-    float holdProgress = -1.0f;
-    if (!inConfig && screen == Screen::MAIN && okHoldArmed && down(3)) {
-      holdProgress = (float)(now - okHoldStartMs) / (float)MENU_HOLD_MS;
-      if (holdProgress < 0.0f) holdProgress = 0.0f;
-      if (holdProgress > 1.0f) holdProgress = 1.0f;
-    }
+// Fingerprint de lo que va a mostrar la pantalla actual (ver frame_gate.h);
+// false = igual al último frame dibujado, no hace falta redibujar
+static bool frameChanged(uint32_t now, bool ok, const WindPacket* p,
+                         float dirDeg, float spdKn, float holdProgress) {
+  fgate::Fingerprint f;
+  f.u32((uint32_t)screen).u32(inConfig ? 1 : 0);
+
+  if (inConfig) {
+    f.u32((uint32_t)uiMode).i32(menuIndex).i32(cfg.dir_offset_deg).q(cfg.speed_factor, 100.0f)
+     .u32(cfg.speed_src).u32(cfg.espnow_channel).u32(cfg.avg_display).u32(cfg.avg_nmea);
+  } else if (screen == Screen::MAIN) {
+    const bool shown = ok && p;
+    f.u32(shown ? 1 : 0).u32(cfg.avg_display);
+    if (shown) f.u32((p->status >> 1) & 1).q(dirDeg, 10.0f).q(spdKn, 100.0f);
+    // barra de hold en pixels (126 de ancho útil)
+    f.i32(holdProgress >= 0.0f ? (int32_t)(126.0f * holdProgress) : -1);
+  } else if (screen == Screen::HIST) {
+    f.u32(proc.history().h10m().head()).u32(proc.history().h10m().count());
+  } else if (screen == Screen::HIST_1H || screen == Screen::HIST_24H) {
+    const hist::TierView v = (screen == Screen::HIST_1H) ? proc.history().h1h() : proc.history().h24h();
+    f.u32(v.head).u32(v.count);
+  } else {
+    // DIAG: contadores y edades que cambian con cada paquete, siempre se dibuja
+    f.u32(now / LCD_FPS_MS);
+  }
+  return frameGate.check(f.value(), now);
+}
 
-    // vista cfg para UI
-    lcd_ui::SettingsView viewCfg;
-    viewCfg.dir_offset_deg = cfg.dir_offset_deg;
-    viewCfg.speed_factor   = cfg.speed_factor;
-    viewCfg.speed_src      = cfg.speed_src;
-    viewCfg.espnow_channel = cfg.espnow_channel;
-    viewCfg.macStr         = macStr;
-
-
-    if (inConfig) {
-      lcd_ui::renderMenu(uiMode, menuIndex, viewCfg);
-    } else if (screen == Screen::MAIN) {
-      lcd_ui::renderMain(p, ok, age, dirCorrDeg, spd, holdProgress);
-    } else if (screen == Screen::HIST) {
-      lcd_ui::renderHist10m(hist_dir_ddeg, hist_spd_centi, hist_head, hist_full);
-    } else {
-      uint32_t seq = (ok && p) ? p->seq : 0;
-      uint16_t st  = (ok && p) ? p->status : 0;
-      lcd_ui::renderDiag(p, ok, age, seq, st, macStr, cntBadLen, cntBadMagic, cntBadCrc);
+static void jobRender(uint32_t now, void*) {
+  {
+    // promedios deslizantes: vacía buckets viejos aunque no lleguen paquetes
+    PROF_SCOPE(STATS);
+    proc.stats().advance(now);
+  }
+  PROF_SCOPE(RENDER);
+
+  uint32_t age;
+  const bool ok = proc.fresh(now, age);
+  const WindPacket* p = (ok) ? &proc.last() : nullptr;
+  const wstats::Avg avgSel = (wstats::Avg)cfg.avg_display;
+  const wstats::Mean avg = proc.stats().mean(avgSel);
+  const float dirCorrDeg = (p && avg.valid) ? avg.dir_deg : 0.0f;
+  const float spd        = (p && avg.valid) ? avg.spd_kn  : 0.0f;
+
+  // hold progress (solo MAIN, solo mientras está armado)
+  float holdProgress = -1.0f;
+  if (!inConfig && screen == Screen::MAIN && down(3) && !keys.longFired(3)) {
+    holdProgress = (float)keys.heldMs(3, now) / (float)MENU_HOLD_MS;
+    if (holdProgress < 0.0f) holdProgress = 0.0f;
+    if (holdProgress > 1.0f) holdProgress = 1.0f;
+  }
+
+  // vista cfg para UI
+  lcd_ui::SettingsView viewCfg;
+  viewCfg.dir_offset_deg = cfg.dir_offset_deg;
+  viewCfg.speed_factor   = cfg.speed_factor;
+  viewCfg.speed_src      = cfg.speed_src;
+  viewCfg.espnow_channel = cfg.espnow_channel;
+  viewCfg.macStr         = macStr;
+  viewCfg.avg_display    = cfg.avg_display;
+  viewCfg.avg_nmea       = cfg.avg_nmea;
+
+
+  if (!frameChanged(now, ok, p, dirCorrDeg, spd, holdProgress)) {
+    // misma imagen que la del LCD: cuenta como mostrada para rx -> LCD
+  } else if (inConfig) {
+    lcd_ui::renderMenu(uiMode, menuIndex, viewCfg);
+  } else if (screen == Screen::MAIN) {
+    lcd_ui::renderMain(p, ok, age, dirCorrDeg, spd, holdProgress,
+                       (avgSel == wstats::Avg::INST) ? nullptr : wstats::avgLabel(avgSel));
+  } else if (screen == Screen::DIAG_PEERS) {
+    peers::Row rows[peers::MAX_PEERS];
+    const uint8_t n = peerSnapshot(now, rows);
+    lcd_ui::renderPeers(rows, n, peerTable.preferred() == peers::NONE, peerTable.fullDrops());
+  } else if (screen == Screen::HIST) {
+    lcd_ui::renderHist10m(proc.history().h10m());
+  } else if (screen == Screen::HIST_1H) {
+    lcd_ui::renderHistTier(proc.history().h1h(), "1 h");
+  } else if (screen == Screen::HIST_24H) {
+    lcd_ui::renderHistTier(proc.history().h24h(), "24 h");
+  } else {
+    uint32_t seq = (ok && p) ? p->seq : 0;
+    uint16_t st  = (ok && p) ? p->status : 0;
+    lcd_ui::renderDiag(p, ok, age, seq, st, macStr, cntBadLen, cntBadMagic, cntBadCrc,
+                       avg, wstats::avgLabel(avgSel), proc.stats().gustLull(),
+                       linkSummary(now), latStats.summary(now));
+  }
+
+  // rx -> LCD: solo cuentan los frames que muestran el viento
+  if (!inConfig && (screen == Screen::MAIN || screen == Screen::DIAG)) latStats.onFrame(millis());
+  else latStats.dropPending();
+
+  jobs.setPeriod(renderJob, frameGate.period());
+}
+
+// NMEA: entrada $PANA y salida. Cada sentencia sigue con su propio plazo
+// dentro de nmea::tickOut; el job solo fija cada cuánto se revisa/empuja.
+// MWV relativo con el promedio elegido; el suavizado es siempre el de 2 min
+static void jobNmea(uint32_t now, void*) {
+  {
+    PROF_SCOPE(NMEA_IN);
+    nmea::pollIn();
+  }
+  PROF_SCOPE(NMEA_OUT);
+  nmea::tickOut(proc.nmeaOut(now, (wstats::Avg)cfg.avg_nmea));
+}
+
+// Config: commit coalescido (fuera de los handlers de botones)
+static void jobCfg(uint32_t now, void*) {
+  PROF_SCOPE(CFG);
+  cfgStore.tick(now);
+}
+
+static void jobPeers(uint32_t now, void*) {
+  peerFailover(now);
+}
+
+static void jobConsole(uint32_t, void*) {
+  consolePoll();
+}
+
+// el log de texto se calla en modo binario (mismo puerto)
+static void jobLog(uint32_t now, void*) {
+  static uint32_t lastRxCount = 0;
+  static bool lastOk = false;
+  if (telem::enabled()) return;
+  PROF_SCOPE(LOG);
+
+  uint32_t c = rxCount; // lectura “rápida”
+  uint32_t d = c - lastRxCount;
+  lastRxCount = c;
+
+  uint32_t age;
+  const bool okNow = proc.fresh(now, age);
+
+  const seqtrk::Summary ls = linkSummary(now);
+
+  Serial.printf("[ESPNOW] +%lu pkt/s  ok=%d  age=%lums  seq=%lu  lost=%lu  badCrc=%lu badLen=%lu badMagic=%lu qOvf=%lu lcd=%uB\n",
+                (unsigned long)d,
+                okNow ? 1 : 0,
+                okNow ? (unsigned long)age : 0UL,
+                proc.have() ? (unsigned long)proc.last().seq : 0UL,
+                (unsigned long)ls.tot.lost,
+                (unsigned long)cntBadCrc,
+                (unsigned long)cntBadLen,
+                (unsigned long)cntBadMagic,
+                (unsigned long)rxQueue.overflowCount(),
+                (unsigned)lcd_ui::lastFlushBytes());
+
+  const fgate::Stats& fs = frameGate.stats();
+  Serial.printf("[LCD] frames=%lu dibujados=%lu skip=%.0f%% T=%lums\n",
+                (unsigned long)fs.frames, (unsigned long)fs.drawn, fs.skipPct(),
+                (unsigned long)frameGate.period());
+
+  const seqtrk::WinStats& w = ls.w60;
+  Serial.printf("[SEQ] loss10=%.1f%% loss60=%.1f%%  late=%lu dup=%lu old=%lu wrap=%lu rst=%lu  jit=%ums  d60=[%lu %lu %lu %lu %lu %lu %lu %lu]\n",
+                ls.w10.lossPct(), w.lossPct(),
+                (unsigned long)ls.tot.late, (unsigned long)ls.tot.dup,
+                (unsigned long)ls.tot.old, (unsigned long)ls.tot.wrap,
+                (unsigned long)ls.tot.reset, (unsigned)ls.jitter_ms,
+                (unsigned long)w.hist[0], (unsigned long)w.hist[1], (unsigned long)w.hist[2],
+                (unsigned long)w.hist[3], (unsigned long)w.hist[4], (unsigned long)w.hist[5],
+                (unsigned long)w.hist[6], (unsigned long)w.hist[7]);
+
+  const lat::Summary lt = latStats.summary(now);
+  Serial.printf("[LAT] sync=%d off=%ldms drift=%.1fppm rs=%lu  tx>rx p50/90/99=%u/%u/%u  rx>lcd p50/90/99=%u/%u/%u ms (n=%lu/%lu drop=%lu)\n",
+                lt.synced ? 1 : 0, (long)lt.offset_ms, lt.drift_ppm, (unsigned long)lt.resyncs,
+                (unsigned)lt.txToRx.p50, (unsigned)lt.txToRx.p90, (unsigned)lt.txToRx.p99,
+                (unsigned)lt.rxToLcd.p50, (unsigned)lt.rxToLcd.p90, (unsigned)lt.rxToLcd.p99,
+                (unsigned long)lt.txToRx.n, (unsigned long)lt.rxToLcd.n, (unsigned long)lt.pend_drops);
+
+  // una línea por transmisor solo si hay más de uno (o se descartan MACs)
+  peers::Row rows[peers::MAX_PEERS];
+  const uint8_t np = peerSnapshot(now, rows);
+  if (np > 1 || peerTable.fullDrops()) {
+    for (uint8_t i = 0; i < np; i++) {
+      const peers::Row& r = rows[i];
+      Serial.printf("[PEER] %c%02X:%02X:%02X:%02X:%02X:%02X rx=%lu lost=%lu err=%lu age=%ldms\n",
+                    r.primary ? '*' : ' ', r.mac[0], r.mac[1], r.mac[2], r.mac[3], r.mac[4], r.mac[5],
+                    (unsigned long)r.rx, (unsigned long)r.lost, (unsigned long)r.errors,
+                    r.age_ms == peers::NO_AGE ? -1L : (long)r.age_ms);
+    }
+    if (peerTable.evictions() || peerTable.fullDrops()) {
+      Serial.printf("[PEER] tabla llena, desalojados=%lu descartados=%lu\n",
+                    (unsigned long)peerTable.evictions(), (unsigned long)peerTable.fullDrops());
     }
+  }
 
+  if (okNow != lastOk) {
+    Serial.printf("[LINK] %s\n", okNow ? "ONLINE" : "OFFLINE");
+    lastOk = okNow;
   }
+}
+
+// Fases corridas para que los jobs de 1 s no caigan en el mismo tick que render
+static void jobsBegin(uint32_t now) {
+  jobs.every(now, BTN_POLL_MS,  jobButtons, nullptr, "buttons");
+  renderJob = jobs.every(now, LCD_FPS_MS, jobRender, nullptr, "render", 5);
+  jobs.every(now, NMEA_POLL_MS, jobNmea,    nullptr, "nmea", 2);
+  jobs.every(now, 100,          jobCfg,     nullptr, "cfg", 7);
+  jobs.every(now, 100,          jobPeers,   nullptr, "peers", 3);
+  jobs.every(now, 50,           jobConsole, nullptr, "console", 1);
+  jobs.every(now, 1000,         jobHist,    nullptr, "hist", 1000);
+  jobs.every(now, 1000,         jobLog,     nullptr, "log", 1011);
+}
+
+// ===================== Setup/Loop =====================
+void setup() {
+ 
+  Serial.begin(115200);
+  telem::begin(Serial);
+ 
+  // Baud NMEA: ver NMEA_BAUD en config.h
+  Serial2.begin(NMEA_BAUD, SERIAL_8N1, RX2_PIN, TX2_PIN);
+  delay(200);
 
-  if (millis() - lastLogMs >= 1000) {
-    lastLogMs = millis();
 
-    uint32_t c = rxCount; // lectura “rápida”
-    uint32_t d = c - lastRxCount;
-    lastRxCount = c;
+  cfgStore.begin(prefsKv, cfg);
+  Serial.printf("[CFG] blob=%d migrado=%d\n",
+                cfgStore.stats().loadedBlob ? 1 : 0, cfgStore.stats().migrated ? 1 : 0);
+  calibRebuild();
+  buttonsBegin();
+  lcd_ui::begin();
+  histRestore();
+
+  // WiFi/Channel/ESPNOW
+  espnowBegin();
+
+  String mac = WiFi.macAddress();
+  snprintf(macStr, sizeof(macStr), "%s", mac.c_str());
 
-    bool okNow = havePkt && ((millis() - lastRxMs) <= NO_DATA_MS);
+  nmea::Config nc;
+  nc.enabled_out = true;
+  nc.enabled_in  = true;    // comandos $PANA
+  nc.out_period_ms = 1000;  // 1 Hz
+  nc.talker = "WI";
+  nc.baud = NMEA_BAUD;
+  nc.smooth_period_ms = 0;    // MWV suavizado (media de 2 min, talker II), apagado por defecto
+  nc.xdr_period_ms = 5000;    // batería del tope cada 5 s
+  nmea::begin(Serial2, nc);
+  nmea::onSentence("P", "ANA", onPana);
 
-    Serial.printf("[ESPNOW] +%lu pkt/s  ok=%d  age=%lums  seq=%lu  lost=%lu  badCrc=%lu badLen=%lu badMagic=%lu\n",
-                  (unsigned long)d,
-                  okNow ? 1 : 0,
-                  okNow ? (unsigned long)(millis() - lastRxMs) : 0UL,
-                  havePkt ? (unsigned long)lastPkt.seq : 0UL,
-                  (unsigned long)cntLost,
-                  (unsigned long)cntBadCrc,
-                  (unsigned long)cntBadLen,
-                  (unsigned long)cntBadMagic);
+  loopTask = xTaskGetCurrentTaskHandle();
+  jobsBegin(millis());
+}
 
-    if (okNow != lastOk) {
-      Serial.printf("[LINK] %s\n", okNow ? "ONLINE" : "OFFLINE");
-      lastOk = okNow;
+void loop() {
+  uint32_t wait;
+  {
+    PROF_SCOPE(LOOP);   // solo trabajo: la espera de abajo queda afuera
+    {
+      PROF_SCOPE(DRAIN);
+      drainRx(); // antes de tomar now: ningún rx_ms queda en el futuro
     }
+    const uint32_t now = millis();
 
-    nmea::tickOut(lastDirCorrDeg, lastSpdKn, lastOkForNmea);
+    // ---- Telemetría binaria: lo que acepte el UART, nunca bloquea ----
+    telem::pump();
+
+    wait = jobs.run(now);
   }
+
+  // duerme hasta el próximo plazo; onRecv despierta antes si llegan paquetes
+  if (wait > 0) ulTaskNotifyTake(pdTRUE, pdMS_TO_TICKS(wait));
 }
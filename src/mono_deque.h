@@ -0,0 +1,64 @@
+#pragma once
+#include <stdint.h>
+
+// ===================== Extremos en ventana deslizante =====================
+// Deque monótona de capacidad fija: máximo (MAX=true) o mínimo de los
+// valores cuya clave está dentro de la ventana. Cada valor entra y sale una
+// sola vez -> O(1) amortizado por muestra, value() es O(1).
+//
+// La clave es un contador uint16 que crece con el tiempo (segundo, nro de
+// columna...) y puede dar la vuelta: se compara por diferencia con signo,
+// así que la ventana tiene que ser < 32768 claves. Con claves crecientes la
+// deque nunca tiene más entradas que claves distintas en la ventana:
+// CAP = largo de la ventana alcanza.
+
+template <uint16_t CAP, bool MAX>
+class MonoDeque {
+  static_assert(CAP >= 1 && CAP < 32768, "MonoDeque: CAP fuera de rango");
+
+public:
+  static constexpr uint16_t capacity() { return CAP; }
+
+  // Las claves deben llegar en orden no decreciente
+  void push(uint16_t key, uint16_t v) {
+    // saca de atrás lo que ya no puede ser extremo
+    while (n_ && !beats(back().v, v)) n_--;
+    if (n_ == CAP) {                  // ventana mal dimensionada: pierde el más viejo
+      head_ = (uint16_t)((head_ + 1) % CAP);
+      n_--;
+    }
+    buf_[(head_ + n_) % CAP] = Entry { key, v };
+    n_++;
+  }
+
+  // Descarta las entradas con clave anterior a oldestKey
+  void expire(uint16_t oldestKey) {
+    while (n_ && (int16_t)(buf_[head_].key - oldestKey) < 0) {
+      head_ = (uint16_t)((head_ + 1) % CAP);
+      n_--;
+    }
+  }
+
+  bool empty() const { return n_ == 0; }
+  uint16_t size() const { return n_; }
+  uint16_t value() const { return buf_[head_].v; }   // solo si !empty()
+  uint16_t key() const { return buf_[head_].key; }
+
+  void clear() { head_ = 0; n_ = 0; }
+
+private:
+  struct Entry {
+    uint16_t key;
+    uint16_t v;
+  };
+
+  // a (más viejo) sigue siendo candidato frente a b (más nuevo) solo si es
+  // estrictamente mejor; en empate gana el nuevo, que dura más en la ventana
+  static bool beats(uint16_t a, uint16_t b) { return MAX ? (a > b) : (a < b); }
+
+  const Entry& back() const { return buf_[(head_ + n_ - 1) % CAP]; }
+
+  Entry buf_[CAP] = {};
+  uint16_t head_ = 0;
+  uint16_t n_ = 0;
+};
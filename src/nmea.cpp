@@ -1,4 +1,5 @@
 #include "nmea.h"
+#include "fmt_fixed.h"
 #include <string.h>
 #include <math.h>
 
@@ -6,7 +7,57 @@ namespace nmea {
 
 static Stream* s_io = nullptr;
 static Config s_cfg;
-static uint32_t s_last_out_ms = 0;
+
+// ----------------- OUT: cola TX no bloqueante -----------------
+// Ring de bytes ya formateados; pumpOut() escribe lo que acepte la UART.
+static constexpr uint16_t TX_LEN = 256;   // potencia de 2
+static uint8_t  s_tx[TX_LEN];
+static uint16_t s_tx_head = 0;            // próximo a escribir
+static uint16_t s_tx_tail = 0;            // próximo a enviar
+static uint32_t s_tx_sent = 0;
+static uint32_t s_tx_dropped = 0;
+
+// Tipos de sentencia con período propio
+enum OutKind : uint8_t { OUT_MWV = 0, OUT_MWV_SMOOTH, OUT_XDR, OUT_KINDS };
+static constexpr uint16_t OUT_EST_BYTES = 32;   // tamaño típico de una sentencia
+static uint32_t s_period_ms[OUT_KINDS] = {};
+static uint32_t s_next_ms[OUT_KINDS] = {};
+
+static uint16_t txUsed() { return (uint16_t)(s_tx_head - s_tx_tail); }
+static uint16_t txFree() { return (uint16_t)(TX_LEN - txUsed()); }
+
+// Encola la línea entera o nada (nunca medias sentencias)
+static bool txPush(const char* line, size_t n) {
+  if (n > txFree()) {
+    s_tx_dropped++;
+    return false;
+  }
+  for (size_t i = 0; i < n; i++) {
+    s_tx[(uint16_t)(s_tx_head + i) & (TX_LEN - 1)] = (uint8_t)line[i];
+  }
+  s_tx_head = (uint16_t)(s_tx_head + n);
+  return true;
+}
+
+// Reparte los bytes/s del enlace (8N1 = 10 bits por byte, 80% de margen)
+// entre las sentencias activas; si no entran, estira todos los períodos.
+static void planOut() {
+  const uint32_t want[OUT_KINDS] = { s_cfg.out_period_ms, s_cfg.smooth_period_ms, s_cfg.xdr_period_ms };
+  const uint32_t budget = (s_cfg.baud / 10u) * 8u / 10u;   // bytes/s
+
+  uint32_t need = 0;   // bytes/s pedidos
+  for (int k = 0; k < OUT_KINDS; k++) {
+    if (want[k]) need += (OUT_EST_BYTES * 1000u + want[k] - 1) / want[k];
+  }
+
+  const uint32_t now = millis();
+  for (int k = 0; k < OUT_KINDS; k++) {
+    uint32_t p = want[k];
+    if (p && budget && need > budget) p = (uint32_t)(((uint64_t)p * need + budget - 1) / budget);
+    s_period_ms[k] = p;
+    s_next_ms[k] = now + p;
+  }
+}
 
 // ----------------- checksum -----------------
 uint8_t checksumBody(const char* body) {
@@ -16,23 +67,37 @@ uint8_t checksumBody(const char* body) {
   return cs;
 }
 
+static int hexVal(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  return -1;
+}
+
 bool validateLine(const char* line) {
-  // Linea tipo: $.....*HH
+  // Linea tipo: $.....*HH  (una pasada, sin sscanf)
   if (!line || line[0] != '$') return false;
-  const char* star = strchr(line, '*');
-  if (!star || (star - line) < 2) return false;
 
   uint8_t cs = 0;
-  for (const char* p = line + 1; p < star; ++p) cs ^= (uint8_t)(*p);
+  const char* p = line + 1;
+  for (; *p && *p != '*'; ++p) cs ^= (uint8_t)(*p);
+  if (*p != '*' || p == line + 1) return false;
 
-  unsigned got = 0;
-  if (sscanf(star + 1, "%2x", &got) != 1) return false;
-  return cs == (uint8_t)got;
+  const int hi = hexVal(p[1]);
+  const int lo = (hi >= 0) ? hexVal(p[2]) : -1;
+  if (lo < 0) return false;
+  return cs == (uint8_t)((hi << 4) | lo);
 }
 
-static void printMWV(float dir_deg, float speed_kn, bool valid) {
-  if (!s_io) return;
+// Cierra la sentencia: "*HH\r\n" con checksum del body (sin '$')
+static size_t finishLine(char* line, fmt::Writer& w) {
+  uint8_t cs = checksumBody(line + 1);
+  w.ch('*').hex(cs, 2).str("\r\n");
+  return w.len();
+}
 
+static size_t formatMWV(char* line, size_t cap, const char* talker,
+                        float dir_deg, float speed_kn, bool valid) {
   // Normalizar dirección
   while (dir_deg < 0) dir_deg += 360.0f;
   while (dir_deg >= 360.0f) dir_deg -= 360.0f;
@@ -41,99 +106,234 @@ static void printMWV(float dir_deg, float speed_kn, bool valid) {
   if (!isfinite(dir_deg)) dir_deg = 0;
   if (!isfinite(speed_kn) || speed_kn < 0) speed_kn = 0;
 
-  char body[64];
-  snprintf(body, sizeof(body),
-           "%sMWV,%03d,R,%.1f,N,%c",
-           s_cfg.talker ? s_cfg.talker : "WI",
-           (int)lroundf(dir_deg),
-           speed_kn,
-           valid ? 'A' : 'V');
-
-  uint8_t cs = checksumBody(body);
+  fmt::Writer w(line, cap);
+  w.ch('$')
+   .str(talker ? talker : "WI")
+   .str("MWV,").i((int32_t)lroundf(dir_deg), 3, '0')
+   .str(",R,").f(speed_kn, 1)
+   .str(",N,").ch(valid ? 'A' : 'V');
 
-  char line[96];
-  snprintf(line, sizeof(line), "$%s*%02X\r\n", body, cs);
-
-  // 1) Enviar a NMEA (Serial2)
-  s_io->print(line);
-
-  // 2) Debug opcional por USB (para ver EXACTO qué se arma)
-  //    Descomentá 1 minuto:
-  // Serial.print("[NMEA OUT] ");
-  // Serial.print(line);
+  // Debug opcional por USB (para ver EXACTO qué se arma):
+  // Serial.print("[NMEA OUT] "); Serial.print(line);
+  return finishLine(line, w);
+}
 
-  // 3) Auto-check del checksum (si falla, lo sabés al instante)
-  // if (!validateLine(line)) {
-  //   Serial.print("[NMEA OUT] INVALID LINE: ");
-  //   Serial.print(line);
-  // }
+// $--XDR,U,12.34,V,BATT  (tensión en volts, 2 decimales)
+static size_t formatXDR(char* line, size_t cap, uint16_t vbat_mV) {
+  fmt::Writer w(line, cap);
+  w.ch('$')
+   .str(s_cfg.talker ? s_cfg.talker : "WI")
+   .str("XDR,U,").fixed((vbat_mV + 5) / 10, 2)
+   .str(",V,BATT");
+  return finishLine(line, w);
 }
 
+// ----------------- IN: parser incremental -----------------
+void Parser::start() {
+  n_ = 0;
+  nf_ = 0;
+  cs_ = 0;
+  got_ = 0;
+  st_ = BODY;
+}
 
-// ----------------- IN: lectura de lineas -----------------
-static bool readLine(char* buf, size_t buflen) {
-  static size_t n = 0;
-  if (!s_io) return false;
+bool Parser::feed(char c) {
+  // '$' / '!' siempre arranca una sentencia nueva (resincroniza)
+  if (c == '$' || c == '!') {
+    start();
+    return false;
+  }
 
-  while (s_io->available()) {
-    char c = (char)s_io->read();
-    if (c == '\r') continue;
+  switch (st_) {
+    case IDLE:
+      return false;
 
-    if (c == '\n') {
-      buf[n] = 0;
-      n = 0;
-      return true;
-    }
+    case BODY:
+      if (c == '*') {
+        buf_[n_] = 0;
+        st_ = CS_HI;
+        return false;
+      }
+      if (c == '\r' || c == '\n') {   // sin checksum: se descarta
+        st_ = IDLE;
+        return false;
+      }
+      if (n_ + 1 >= LINE_MAX) {
+        overflow_++;
+        st_ = IDLE;
+        return false;
+      }
+      cs_ ^= (uint8_t)c;
+      if (c == ',') {
+        buf_[n_++] = 0;
+        if (nf_ < MAX_FIELDS) fieldAt_[nf_++] = n_;
+      } else {
+        buf_[n_++] = c;
+      }
+      return false;
 
-    if (n + 1 < buflen) {
-      buf[n++] = c;
-    } else {
-      // overflow -> descartar
-      n = 0;
+    case CS_HI:
+    case CS_LO: {
+      const int v = hexVal(c);
+      if (v < 0) {
+        badCs_++;
+        st_ = IDLE;
+        return false;
+      }
+      got_ = (uint8_t)((got_ << 4) | v);
+      if (st_ == CS_HI) {
+        st_ = CS_LO;
+        return false;
+      }
+      st_ = IDLE;
+      if (got_ != cs_) {
+        badCs_++;
+        return false;
+      }
+      return finish();
     }
   }
   return false;
 }
 
-static void handleLine(const char* line) {
-  // Por ahora: solo valida y deja “hook” para comandos propietarios
-  if (!validateLine(line)) return;
+bool Parser::finish() {
+  // Dirección = primer token: "WIMWV" o propietaria "PANA"
+  const char* addr = buf_;
+  const size_t alen = strlen(addr);
+  if (alen < 2) return false;
 
-  // Ejemplo futuro de comando propietario:
-  // $PANA,CH,1*hh   -> set channel
-  // $PANA,OFF,-12*hh -> offset
-  // $PANA,FAC,1.23*hh -> factor
-  if (strncmp(line, "$PANA,", 6) == 0) {
-    // acá después lo conectamos con tu config/prefs
-    // por ahora solo log
-    if (s_io) s_io->printf("[NMEA IN] %s\r\n", line);
+  const size_t tlen = (addr[0] == 'P') ? 1 : 2;
+  memcpy(s_.talker, addr, tlen);
+  s_.talker[tlen] = 0;
+
+  size_t ilen = alen - tlen;
+  if (ilen > sizeof(s_.id) - 1) ilen = sizeof(s_.id) - 1;
+  memcpy(s_.id, addr + tlen, ilen);
+  s_.id[ilen] = 0;
+
+  s_.nfields = nf_;
+  for (uint8_t i = 0; i < nf_; i++) s_.field[i] = buf_ + fieldAt_[i];
+
+  ok_++;
+  return true;
+}
+
+// ----------------- IN: despacho -----------------
+struct HandlerSlot {
+  char talker[3];     // "" = cualquiera
+  char id[6];
+  Handler fn;
+  void* ctx;
+};
+
+static Parser s_parser;
+static HandlerSlot s_handlers[MAX_HANDLERS];
+static uint8_t s_nhandlers = 0;
+static uint32_t s_unhandled = 0;
+
+static void dispatch(const Sentence& st) {
+  bool any = false;
+  for (uint8_t i = 0; i < s_nhandlers; i++) {
+    const HandlerSlot& h = s_handlers[i];
+    if (h.talker[0] && strcmp(h.talker, st.talker) != 0) continue;
+    if (strcmp(h.id, st.id) != 0) continue;
+    h.fn(st, h.ctx);
+    any = true;
   }
+  if (!any) s_unhandled++;
+}
+
+bool onSentence(const char* talker, const char* id, Handler h, void* ctx) {
+  if (!h || !id || s_nhandlers >= MAX_HANDLERS) return false;
+  if (strlen(id) >= sizeof(HandlerSlot::id)) return false;
+  if (talker && strlen(talker) >= sizeof(HandlerSlot::talker)) return false;
+
+  HandlerSlot& slot = s_handlers[s_nhandlers++];
+  strcpy(slot.talker, talker ? talker : "");
+  strcpy(slot.id, id);
+  slot.fn = h;
+  slot.ctx = ctx;
+  return true;
 }
 
 // ----------------- API pública -----------------
 void begin(Stream& io, const Config& cfg) {
   s_io = &io;
   s_cfg = cfg;
-  s_last_out_ms = millis();
+  s_tx_head = s_tx_tail = 0;
+  planOut();
+}
+
+void pumpOut() {
+  if (!s_io) return;
+
+  int room = s_io->availableForWrite();
+  while (room > 0 && txUsed() > 0) {
+    // tramo contiguo hasta el fin del ring
+    const uint16_t t = s_tx_tail & (TX_LEN - 1);
+    uint16_t n = txUsed();
+    if (n > TX_LEN - t) n = (uint16_t)(TX_LEN - t);
+    if (n > (uint16_t)room) n = (uint16_t)room;
+
+    const size_t w = s_io->write(&s_tx[t], n);
+    if (w == 0) break;
+    s_tx_tail = (uint16_t)(s_tx_tail + w);
+    s_tx_sent += (uint32_t)w;
+    room -= (int)w;
+  }
 }
 
-void tickOut(float dir_deg, float speed_kn, bool valid) {
+void tickOut(const OutData& d) {
   if (!s_cfg.enabled_out || !s_io) return;
 
   const uint32_t now = millis();
-  if ((now - s_last_out_ms) < s_cfg.out_period_ms) return;
-  s_last_out_ms = now;
+  char line[96];
 
-  printMWV(dir_deg, speed_kn, valid);
+  for (int k = 0; k < OUT_KINDS; k++) {
+    const uint32_t p = s_period_ms[k];
+    if (!p || (int32_t)(now - s_next_ms[k]) < 0) continue;
+
+    // plazo sin deriva; si quedamos muy atrás (loop trabado), re-sincroniza
+    s_next_ms[k] += p;
+    if ((int32_t)(now - s_next_ms[k]) >= 0) s_next_ms[k] = now + p;
+
+    size_t n = 0;
+    if (k == OUT_MWV) {
+      n = formatMWV(line, sizeof(line), s_cfg.talker, d.dir_deg, d.speed_kn, d.valid);
+    } else if (k == OUT_MWV_SMOOTH) {
+      const char* t = s_cfg.smooth_talker ? s_cfg.smooth_talker : s_cfg.talker;
+      n = formatMWV(line, sizeof(line), t, d.dir_smooth_deg, d.speed_smooth_kn, d.smooth_valid);
+    } else if (k == OUT_XDR) {
+      if (d.vbat_mV == 0) continue;
+      n = formatXDR(line, sizeof(line), d.vbat_mV);
+    }
+    txPush(line, n);
+  }
+
+  pumpOut();
+}
+
+OutStats outStats() {
+  OutStats st;
+  st.sent_bytes = s_tx_sent;
+  st.dropped = s_tx_dropped;
+  st.queued = txUsed();
+  for (int k = 0; k < OUT_KINDS; k++) st.period_ms[k] = s_period_ms[k];
+  return st;
 }
 
 void pollIn() {
   if (!s_cfg.enabled_in || !s_io) return;
 
-  char line[96];
-  if (readLine(line, sizeof(line))) {
-    handleLine(line);
+  // drena todo lo disponible; cada sentencia se despacha apenas cierra
+  while (s_io->available() > 0) {
+    const int c = s_io->read();
+    if (c < 0) break;
+    if (s_parser.feed((char)c)) dispatch(s_parser.sentence());
   }
 }
 
+uint32_t inUnhandled() { return s_unhandled; }
+const Parser& inParser() { return s_parser; }
+
 } // namespace nmea
@@ -8,19 +8,110 @@ namespace nmea {
 struct Config {
   bool enabled_out = true;
   bool enabled_in  = false;   // por ahora apagado si querés
-  uint32_t out_period_ms = 1000; // 1 Hz
+  uint32_t out_period_ms = 1000; // MWV relativo, 1 Hz
   const char* talker = "WI";  // "WI" recomendado
+
+  // Salida planificada dentro del presupuesto del enlace (0 = apagado)
+  uint32_t baud = 4800;              // para calcular bytes/s disponibles
+  uint32_t smooth_period_ms = 0;     // MWV con valores suavizados
+  const char* smooth_talker = "II";  // talker del MWV suavizado: distinto de
+                                     // talker para que el receptor no mezcle
+                                     // las dos series (nullptr = talker)
+  uint32_t xdr_period_ms = 0;        // XDR tensión de batería (vbat_mV)
+};
+
+// Valores para las sentencias de salida
+struct OutData {
+  float dir_deg = 0.0f;          // MWV relativo (instantáneo)
+  float speed_kn = 0.0f;
+  bool  valid = false;
+
+  float dir_smooth_deg = 0.0f;   // MWV suavizado
+  float speed_smooth_kn = 0.0f;
+  bool  smooth_valid = false;    // 'A'/'V' propio: la media puede seguir
+                                 // válida con el instantáneo caído y al revés
+
+  uint16_t vbat_mV = 0;          // 0 = sin dato, no se manda XDR
+};
+
+// Contadores de la cola de salida
+struct OutStats {
+  uint32_t sent_bytes = 0;
+  uint32_t dropped = 0;         // sentencias descartadas por cola llena
+  uint16_t queued = 0;          // bytes pendientes ahora
+  uint32_t period_ms[3] = {};   // períodos efectivos MWV / suavizado / XDR
 };
 
 // Inicializa el módulo con un Stream (Serial/Serial2/etc.)
 void begin(Stream& io, const Config& cfg = Config());
 
-// Enviar MWV periódicamente (OUT). Llamar desde loop().
-void tickOut(float dir_deg, float speed_kn, bool valid);
+// Arma las sentencias que vencieron y empuja bytes sin bloquear
+// (solo lo que entra en availableForWrite()). Llamar en cada loop().
+void tickOut(const OutData& d);
+
+// Solo empuja bytes pendientes (sin armar sentencias nuevas)
+void pumpOut();
+
+OutStats outStats();
+
+// ----------------- IN -----------------
+static constexpr uint8_t LINE_MAX   = 96;   // NMEA dice 82, dejamos margen
+static constexpr uint8_t MAX_FIELDS = 24;
+
+// Sentencia ya validada; los campos apuntan al buffer del parser
+// (válidos hasta el próximo byte que se le pase).
+struct Sentence {
+  char talker[3];            // "WI", "GP"... o "P" en propietarias
+  char id[6];                // "MWV", "ANA"...
+  uint8_t nfields;           // campos después de la dirección
+  const char* field[MAX_FIELDS];
+};
+
+// Parser incremental byte a byte: checksum al vuelo y campos separados
+// en el lugar (',' -> '\0'), sin copiar ni reescanear la línea.
+class Parser {
+public:
+  // true cuando se completa una sentencia con checksum correcto
+  bool feed(char c);
+  const Sentence& sentence() const { return s_; }
+
+  uint32_t okCount() const { return ok_; }
+  uint32_t badChecksum() const { return badCs_; }
+  uint32_t overflows() const { return overflow_; }
+
+private:
+  enum State : uint8_t { IDLE, BODY, CS_HI, CS_LO };
+
+  void start();
+  bool finish();
+
+  char buf_[LINE_MAX];
+  uint8_t fieldAt_[MAX_FIELDS];   // offset de cada campo en buf_
+  uint8_t n_ = 0;
+  uint8_t nf_ = 0;
+  uint8_t cs_ = 0;
+  uint8_t got_ = 0;
+  State st_ = IDLE;
+  Sentence s_ {};
+
+  uint32_t ok_ = 0;
+  uint32_t badCs_ = 0;
+  uint32_t overflow_ = 0;
+};
+
+// Handler por talker + id. talker nullptr = cualquier talker.
+using Handler = void (*)(const Sentence& s, void* ctx);
+static constexpr uint8_t MAX_HANDLERS = 8;
+bool onSentence(const char* talker, const char* id, Handler h, void* ctx = nullptr);
 
 // Leer y procesar NMEA entrante (IN). Llamar desde loop() si enabled_in=true.
+// Consume todos los bytes disponibles y despacha cada sentencia válida.
 void pollIn();
 
+// Sentencias despachadas a ningún handler / a alguno
+uint32_t inUnhandled();
+const Parser& inParser();
+
 // Helpers por si los querés usar afuera
 uint8_t checksumBody(const char* body);
 bool validateLine(const char* line);
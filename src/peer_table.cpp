@@ -0,0 +1,146 @@
+#include "peer_table.h"
+#include <string.h>
+
+namespace peers {
+
+Table::Table() {
+  memset(slot_, NONE, sizeof(slot_));
+}
+
+// Los 3 bytes altos son del fabricante (casi siempre iguales entre topes):
+// mezcla solo los 3 bajos
+uint8_t Table::hash(const uint8_t mac[6]) {
+  uint32_t h = ((uint32_t)mac[3] << 16) | ((uint32_t)mac[4] << 8) | mac[5];
+  h *= 2654435761u;
+  return (uint8_t)(h >> 28) & (SLOTS - 1);
+}
+
+uint8_t Table::find(const uint8_t mac[6]) const {
+  uint8_t s = hash(mac);
+  for (uint8_t i = 0; i < SLOTS; i++, s = (uint8_t)((s + 1) & (SLOTS - 1))) {
+    const uint8_t id = slot_[s];
+    if (id == NONE) return NONE;
+    if (memcmp(peers_[id].mac, mac, 6) == 0) return id;
+  }
+  return NONE;
+}
+
+// Candidato a desalojar: ni primario ni preferido; primero los que nunca
+// mandaron un paquete válido, después el de último paquete más antiguo
+uint8_t Table::stalest() const {
+  uint8_t best = NONE;
+  for (uint8_t id = 0; id < count_; id++) {
+    if (id == primary_ || id == preferred_) continue;
+    const Peer& p = peers_[id];
+    if (best == NONE) { best = id; continue; }
+    const Peer& b = peers_[best];
+    if (b.havePkt && (!p.havePkt || (int32_t)(p.lastRxMs - b.lastRxMs) < 0)) best = id;
+  }
+  return best;
+}
+
+void Table::rebuildSlots() {
+  memset(slot_, NONE, sizeof(slot_));
+  for (uint8_t id = 0; id < count_; id++) {
+    uint8_t s = hash(peers_[id].mac);
+    while (slot_[s] != NONE) s = (uint8_t)((s + 1) & (SLOTS - 1));
+    slot_[s] = id;
+  }
+}
+
+uint8_t Table::findOrAdd(const uint8_t mac[6]) {
+  uint8_t s = hash(mac);
+  for (uint8_t i = 0; i < SLOTS; i++, s = (uint8_t)((s + 1) & (SLOTS - 1))) {
+    const uint8_t id = slot_[s];
+    if (id == NONE) break;
+    if (memcmp(peers_[id].mac, mac, 6) == 0) return id;
+  }
+  if (count_ >= MAX_PEERS) {
+    const uint8_t id = stalest();
+    if (id == NONE) {
+      fullDrops_++;
+      return NONE;
+    }
+    peers_[id] = Peer();
+    memcpy(peers_[id].mac, mac, 6);
+    rebuildSlots();
+    evictions_++;
+    return id;
+  }
+  // s quedó en el primer slot libre (carga <= 50%: siempre hay uno)
+  const uint8_t id = count_++;
+  peers_[id] = Peer();
+  memcpy(peers_[id].mac, mac, 6);
+  slot_[s] = id;
+  return id;
+}
+
+seqtrk::Kind Table::onPacket(uint8_t id, const WindPacket& p, uint32_t now_ms) {
+  Peer& e = peers_[id];
+  uint32_t gap = 0, adv = 0;
+  const seqtrk::Kind k = e.win.accept(p.seq, gap, adv);
+  e.seq.count(k, gap);
+
+  // último paquete solo con seq nuevos (no retrocede con tardíos/dups)
+  if (k != seqtrk::Kind::DUP && k != seqtrk::Kind::OLD && k != seqtrk::Kind::LATE) {
+    e.last = p;
+  }
+  if (k != seqtrk::Kind::DUP && k != seqtrk::Kind::OLD) {
+    e.lastRxMs = now_ms;
+    e.havePkt = true;
+  }
+  if (primary_ == NONE) primary_ = id;
+  return k;
+}
+
+void Table::onError(uint8_t id, Err e) {
+  Peer& p = peers_[id];
+  if (e == Err::LEN) p.badLen++;
+  else if (e == Err::MAGIC) p.badMagic++;
+  else p.badCrc++;
+}
+
+bool Table::fresh(uint8_t id, uint32_t now_ms, uint32_t stale_ms) const {
+  if (id >= count_ || !peers_[id].havePkt) return false;
+  // rx del callback puede ser apenas posterior al 'now' de loop()
+  const int32_t age = (int32_t)(now_ms - peers_[id].lastRxMs);
+  return age <= (int32_t)stale_ms;
+}
+
+bool Table::update(uint32_t now_ms, uint32_t stale_ms) {
+  uint8_t target = primary_;
+
+  if (preferred_ != NONE && fresh(preferred_, now_ms, stale_ms)) {
+    target = preferred_;
+  } else if (!fresh(primary_, now_ms, stale_ms)) {
+    // failover: el más reciente de los frescos (si no hay, queda el actual)
+    for (uint8_t id = 0; id < count_; id++) {
+      if (!fresh(id, now_ms, stale_ms)) continue;
+      if (target == primary_ || (int32_t)(peers_[id].lastRxMs - peers_[target].lastRxMs) > 0) target = id;
+    }
+  }
+
+  if (target == primary_) return false;
+  primary_ = target;
+  switches_++;
+  return true;
+}
+
+uint8_t Table::rows(Row* out, uint8_t cap, uint32_t now_ms) const {
+  uint8_t n = 0;
+  for (uint8_t id = 0; id < count_ && n < cap; id++, n++) {
+    const Peer& p = peers_[id];
+    Row& r = out[n];
+    memcpy(r.mac, p.mac, 6);
+    r.rx = p.seq.rx;
+    r.lost = p.seq.lost;
+    r.errors = p.errors();
+    const int32_t age = (int32_t)(now_ms - p.lastRxMs);
+    r.age_ms = !p.havePkt ? NO_AGE : (age < 0 ? 0u : (uint32_t)age);
+    r.primary = (id == primary_);
+    r.preferred = (id == preferred_);
+  }
+  return n;
+}
+
+} // namespace peers
@@ -0,0 +1,106 @@
+#pragma once
+#include <stdint.h>
+#include "wind_packet.h"
+#include "seq_track.h"
+
+namespace peers {
+
+// ===================== Tabla de transmisores por MAC =====================
+// Cada tope (o el de un barco vecino en el mismo canal) tiene su propia
+// ventana de seq, contadores de error, último paquete y frescura; solo el
+// primario alimenta el pipeline.
+//
+// Open addressing con sondeo lineal: SLOTS (potencia de 2) índices a un
+// arreglo denso de MAX_PEERS entradas, carga <= 50% -> O(1) esperado.
+// Con la tabla llena, una MAC nueva reemplaza al transmisor más viejo (el de
+// último paquete más antiguo) que no sea el primario ni el preferido; los
+// slots se reconstruyen (son 16), así no hacen falta tombstones. Solo si no
+// hay a quién desalojar se cuenta en fullDrops() y se ignora. Todo estático:
+// el callback de ESP-NOW no reserva memoria.
+//
+// No es thread-safe: el callback y loop() lo usan bajo el mismo portMUX.
+
+static constexpr uint8_t MAX_PEERS = 8;
+static constexpr uint8_t SLOTS = 16;
+static constexpr uint8_t NONE = 0xFF;
+
+enum class Err : uint8_t { LEN, MAGIC, CRC };
+
+struct Peer {
+  uint8_t mac[6] = {};
+  seqtrk::SeqWindow win;
+  seqtrk::Counters seq;
+  uint32_t badLen = 0;
+  uint32_t badMagic = 0;
+  uint32_t badCrc = 0;
+  WindPacket last {};
+  uint32_t lastRxMs = 0;
+  bool havePkt = false;
+
+  uint32_t errors() const { return badLen + badMagic + badCrc; }
+};
+
+// Fila para UI/log (copia chica tomada bajo el lock)
+struct Row {
+  uint8_t mac[6];
+  uint32_t rx;
+  uint32_t lost;
+  uint32_t errors;
+  uint32_t age_ms;          // NO_AGE si nunca llegó un paquete válido
+  bool primary;
+  bool preferred;
+};
+static constexpr uint32_t NO_AGE = 0xFFFFFFFFu;
+
+class Table {
+public:
+  Table();
+
+  // id (orden de llegada salvo desalojos, 0..MAX_PEERS-1) o NONE
+  uint8_t find(const uint8_t mac[6]) const;
+  // Alta si no existe. Con la tabla llena desaloja al más viejo (su id pasa
+  // a la MAC nueva); NONE (y cuenta) si no hay ninguno desalojable.
+  uint8_t findOrAdd(const uint8_t mac[6]);
+
+  // Paquete válido de 'id': ventana de seq propia, último paquete, frescura.
+  // Si todavía no hay primario, 'id' pasa a serlo.
+  seqtrk::Kind onPacket(uint8_t id, const WindPacket& p, uint32_t now_ms);
+  void onError(uint8_t id, Err e);
+
+  // Primario: el preferido si está fresco; si no, se mantiene el actual
+  // mientras esté fresco; si no, el más reciente de los frescos.
+  // Devuelve true si cambió.
+  bool update(uint32_t now_ms, uint32_t stale_ms);
+  uint8_t primary() const { return primary_; }
+
+  // NONE = automático
+  void setPreferred(uint8_t id) { preferred_ = (id < count_) ? id : NONE; }
+  uint8_t preferred() const { return preferred_; }
+
+  uint8_t count() const { return count_; }
+  const Peer& peer(uint8_t id) const { return peers_[id]; }
+  bool fresh(uint8_t id, uint32_t now_ms, uint32_t stale_ms) const;
+
+  uint32_t fullDrops() const { return fullDrops_; }
+  uint32_t evictions() const { return evictions_; }
+  uint32_t switches() const { return switches_; }
+
+  // Hasta 'cap' filas en orden de llegada
+  uint8_t rows(Row* out, uint8_t cap, uint32_t now_ms) const;
+
+private:
+  static uint8_t hash(const uint8_t mac[6]);
+  uint8_t stalest() const;
+  void rebuildSlots();
+
+  Peer peers_[MAX_PEERS];
+  uint8_t slot_[SLOTS];
+  uint8_t count_ = 0;
+  uint8_t primary_ = NONE;
+  uint8_t preferred_ = NONE;
+  uint32_t fullDrops_ = 0;
+  uint32_t evictions_ = 0;
+  uint32_t switches_ = 0;
+};
+
+} // namespace peers
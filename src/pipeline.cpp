@@ -0,0 +1,55 @@
+#include "pipeline.h"
+#include <math.h>
+
+namespace pipeline {
+
+rxpipe::Derived Processor::onSample(const WindPacket& p, uint32_t rx_ms, const calib::Tables& cal) {
+  const rxpipe::Derived dv = rxpipe::derive(p, cal);
+
+  last_   = p;
+  lastRx_ = rx_ms;
+  have_   = true;
+  stats_.add(rx_ms, dv.dir_cdeg, dv.spd_centi);
+
+  secDir_.add(trig::fromCdeg(dv.dir_cdeg));
+  secSpd_ += dv.spd_kn;
+  return dv;
+}
+
+bool Processor::closeSecond(uint16_t& dir_ddeg, uint16_t& spd_centi) {
+  if (secDir_.n == 0) return false;
+
+  dir_ddeg = trig::toDdeg(secDir_.mean());                 // 0..3599
+  const long s = lroundf(secSpd_ / (float)secDir_.n * 100.0f);
+  spd_centi = (uint16_t)(s > 65535 ? 65535 : s);           // kn*100 saturado
+
+  secDir_ = trig::VecSum();
+  secSpd_ = 0.0f;
+  hist_.append(dir_ddeg, spd_centi);
+  return true;
+}
+
+nmea::OutData Processor::nmeaOut(uint32_t now, wstats::Avg rel) {
+  stats_.advance(now);
+  uint32_t age;
+  const bool ok = fresh(now, age);
+  const wstats::Mean r  = stats_.mean(rel);
+  const wstats::Mean m2 = stats_.mean(wstats::Avg::M2);
+
+  nmea::OutData od;
+  od.dir_deg  = (ok && r.valid) ? r.dir_deg : 0.0f;
+  od.speed_kn = (ok && r.valid) ? r.spd_kn  : 0.0f;
+  od.valid    = ok && r.valid;
+  od.dir_smooth_deg  = m2.dir_deg;
+  od.speed_smooth_kn = m2.spd_kn;
+  od.smooth_valid    = m2.valid;
+  od.vbat_mV  = ok ? last_.vbat_mV : 0;
+  return od;
+}
+
+bool Processor::fresh(uint32_t now, uint32_t& age) const {
+  age = have_ ? (now - lastRx_) : 0;
+  return have_ && age <= noDataMs_;
+}
+
+} // namespace pipeline
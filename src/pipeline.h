@@ -0,0 +1,60 @@
+#pragma once
+#include <stdint.h>
+#include "wind_packet.h"
+#include "rx_pipeline.h"
+#include "wind_stats.h"
+#include "wind_hist.h"
+#include "nmea.h"
+
+namespace pipeline {
+
+// ===================== Procesamiento de muestras (sin ESP) =====================
+// Lo que loop() hace con cada muestra aceptada del primario (processSample),
+// una vez por segundo (jobHist) y en cada tick de NMEA (jobNmea). La cola,
+// la telemetría, el journal y el LCD quedan en main.cpp; harness/replay usa
+// esta misma clase, así que los goldens cubren el código del equipo.
+
+class Processor {
+public:
+  // noDataMs: sin paquetes por más de esto los datos dejan de estar frescos
+  explicit Processor(uint32_t noDataMs) : noDataMs_(noDataMs) {}
+
+  // Una muestra nueva en orden (sin DUP/OLD/LATE): calibración, promedios
+  // deslizantes y acumulado del segundo. Devuelve lo derivado.
+  rxpipe::Derived onSample(const WindPacket& p, uint32_t rx_ms, const calib::Tables& cal);
+
+  // Cierra el segundo: media vectorial de dir y escalar de vel al historial.
+  // false si no llegó nada; si no, la muestra agregada (para el journal).
+  bool closeSecond(uint16_t& dir_ddeg, uint16_t& spd_centi);
+
+  // Ventanas al día y valores de salida: MWV relativo con el promedio 'rel'
+  // (solo con datos frescos), suavizado siempre con la media de 2 min
+  nmea::OutData nmeaOut(uint32_t now, wstats::Avg rel);
+
+  // Hay datos de hace menos de noDataMs; age = ms desde el último (0 sin datos)
+  bool fresh(uint32_t now, uint32_t& age) const;
+
+  bool have() const { return have_; }
+  const WindPacket& last() const { return last_; }
+
+  wstats::WindStats& stats() { return stats_; }
+  const wstats::WindStats& stats() const { return stats_; }
+  hist::WindHistory& history() { return hist_; }
+  const hist::WindHistory& history() const { return hist_; }
+
+private:
+  uint32_t noDataMs_;
+
+  wstats::WindStats stats_;   // inst / 3 s / 2 min / 10 min (UI + NMEA)
+  hist::WindHistory hist_;    // 10 min a 1 s, 1 h a 10 s y 24 h a 2 min
+
+  // Acumulado del segundo en curso (HIST)
+  trig::VecSum secDir_;
+  float secSpd_ = 0.0f;
+
+  bool have_ = false;
+  WindPacket last_ {};
+  uint32_t lastRx_ = 0;
+};
+
+} // namespace pipeline
@@ -0,0 +1,85 @@
+#include "prof.h"
+
+#if PROF_ENABLE
+
+#include <Arduino.h>      // Print (en host lo provee el shim del entorno nativo)
+#if !defined(ARDUINO)
+#include <chrono>
+#endif
+
+namespace prof {
+
+static constexpr uint8_t NBUCKETS = 32;   // bucket k: dt < 2^k ticks
+
+struct StageHist {
+  uint32_t n[NBUCKETS];
+  uint32_t count;
+  uint32_t max;
+};
+
+static StageHist s_h[STAGE_COUNT];
+
+const char* stageName(Stage s) {
+  static const char* const NAMES[STAGE_COUNT] = {
+    "loop", "drain", "buttons", "nmeaIn", "nav", "stats", "hist",
+    "render", " rMain", " rDiag", " rMenu", " rHist", " rTier", " flush",
+    "nmeaOut", "cfg", "log",
+  };
+  return (s < STAGE_COUNT) ? NAMES[s] : "?";
+}
+
+#if defined(ARDUINO)
+uint32_t ticks() { return ESP.getCycleCount(); }
+static uint32_t ticksPerUs() { return ESP.getCpuFreqMHz(); }
+#else
+uint32_t ticks() {
+  using namespace std::chrono;
+  return (uint32_t)duration_cast<nanoseconds>(steady_clock::now().time_since_epoch()).count();
+}
+static uint32_t ticksPerUs() { return 1000; }
+#endif
+
+void record(Stage s, uint32_t dt) {
+  StageHist& h = s_h[s];
+  const uint8_t k = dt ? (uint8_t)(32 - __builtin_clz(dt)) : 0;   // bits de dt (0..32)
+  h.n[(k < NBUCKETS) ? k : NBUCKETS - 1]++;
+  h.count++;
+  if (dt > h.max) h.max = dt;
+}
+
+// Borde superior del bucket donde cae el percentil p
+static uint32_t pctTicks(const StageHist& h, uint8_t p) {
+  if (h.count == 0) return 0;
+  const uint32_t target = (uint32_t)(((uint64_t)h.count * p + 99u) / 100u);
+  uint32_t acc = 0;
+  for (uint8_t k = 0; k < NBUCKETS; k++) {
+    acc += h.n[k];
+    if (acc >= target) {
+      const uint32_t edge = (1u << k) - 1u;
+      return (edge < h.max) ? edge : h.max;
+    }
+  }
+  return h.max;
+}
+
+void report(Print& out) {
+  const uint32_t tpu = ticksPerUs();
+  out.printf("[PROF] %-8s %8s %8s %8s %8s  (us)\n", "etapa", "n", "p50", "p99", "max");
+  for (uint8_t i = 0; i < STAGE_COUNT; i++) {
+    const StageHist& h = s_h[i];
+    if (h.count == 0) continue;
+    out.printf("[PROF] %-8s %8lu %8lu %8lu %8lu\n", stageName((Stage)i),
+               (unsigned long)h.count,
+               (unsigned long)(pctTicks(h, 50) / tpu),
+               (unsigned long)(pctTicks(h, 99) / tpu),
+               (unsigned long)(h.max / tpu));
+  }
+}
+
+void reset() {
+  for (uint8_t i = 0; i < STAGE_COUNT; i++) s_h[i] = StageHist();
+}
+
+} // namespace prof
+
+#endif
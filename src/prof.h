@@ -0,0 +1,78 @@
+#pragma once
+#include <stdint.h>
+
+// ===================== Profiler por etapas =====================
+// Timers con scope: PROF_SCOPE(ETAPA) mide desde la declaración hasta el
+// fin del bloque. En el equipo usa el contador de ciclos de la CPU
+// (ESP.getCycleCount); en host std::chrono. Cada etapa acumula un
+// histograma log2 de 32 buckets (p50/p99 = borde superior del bucket),
+// máximo exacto y cantidad: O(1) por medición, sin heap.
+//
+// Con PROF_ENABLE=0 los macros y funciones no generan código.
+// Reporte por consola (Serial): 'p' imprime y sigue, 'r' resetea.
+
+#ifndef PROF_ENABLE
+#define PROF_ENABLE 0
+#endif
+
+class Print;
+
+namespace prof {
+
+enum Stage : uint8_t {
+  LOOP,          // loop() sin la espera de ulTaskNotifyTake
+  DRAIN,         // drainRx + procesamiento de muestras
+  BUTTONS,
+  NMEA_IN,
+  NAV,           // navegación / menú
+  STATS,         // promedios deslizantes
+  HIST,          // append 1 Hz + journal
+  RENDER,        // bloque de render completo (incluye FLUSH)
+  R_MAIN,
+  R_DIAG,
+  R_MENU,
+  R_HIST,
+  R_TIER,
+  FLUSH,         // envío de filas sucias al LCD
+  NMEA_OUT,
+  CFG,
+  LOG,           // printf de 1 s
+  STAGE_COUNT
+};
+
+#if PROF_ENABLE
+
+const char* stageName(Stage s);
+
+uint32_t ticks();
+void record(Stage s, uint32_t dt);
+
+class Scope {
+public:
+  explicit Scope(Stage s) : s_(s), t0_(ticks()) {}
+  ~Scope() { record(s_, ticks() - t0_); }
+  Scope(const Scope&) = delete;
+  Scope& operator=(const Scope&) = delete;
+
+private:
+  Stage s_;
+  uint32_t t0_;
+};
+
+void report(Print& out);   // p50 / p99 / max en µs por etapa
+void reset();
+
+#define PROF_CAT2(a, b) a##b
+#define PROF_CAT(a, b) PROF_CAT2(a, b)
+#define PROF_SCOPE(st) prof::Scope PROF_CAT(prof_scope_, __LINE__)(prof::st)
+
+#else
+
+inline void report(Print&) {}
+inline void reset() {}
+
+#define PROF_SCOPE(st) ((void)0)
+
+#endif
+
+} // namespace prof
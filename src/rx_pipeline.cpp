@@ -0,0 +1,102 @@
+#include "rx_pipeline.h"
+#include <string.h>
+#include "crc16_modbus.h"
+
+namespace rxpipe {
+
+Verdict validate(const uint8_t* data, int len, WindPacket& out) {
+  if (len != (int)sizeof(WindPacket)) return Verdict::BAD_LEN;
+
+  const size_t crcLen = sizeof(WindPacket) - sizeof(out.crc16);
+  const uint16_t calc = crc16::copyUpdate(crc16::INIT, (uint8_t*)&out, data, crcLen);
+  memcpy(&out.crc16, data + crcLen, sizeof(out.crc16));
+
+  if (out.magic != WIND_MAGIC || out.version != WIND_VER) return Verdict::BAD_MAGIC;
+  if (calc != out.crc16) return Verdict::BAD_CRC;
+  return Verdict::OK;
+}
+
+Verdict FrameReader::open(const uint8_t* data, int len) {
+  count_ = idx_ = 0;
+  cur_ = WindPacket();
+  if (len < 4) return Verdict::BAD_LEN;
+
+  uint16_t magic, version;
+  memcpy(&magic, data, 2);
+  memcpy(&version, data + 2, 2);
+
+  if (magic != WIND_MAGIC || version != WIND_VER2) {
+    // v1 (o basura: validate() decide largo / magic / CRC como siempre)
+    const Verdict v = validate(data, len, cur_);
+    if (v == Verdict::OK) count_ = 1;
+    return v;
+  }
+
+  if (len < (int)wpv2::MIN_LEN || len > (int)ESPNOW_MAX_LEN) return Verdict::BAD_LEN;
+
+  WindPacketV2Hdr h;
+  memcpy(&h, data, sizeof(h));
+  cur_.seq = h.seq;
+
+  const size_t body = (size_t)len - 2;
+  const uint16_t crc = (uint16_t)(data[body] | (data[body + 1] << 8));
+  if (crc16::update4(crc16::INIT, data, body) != crc) return Verdict::BAD_CRC;
+
+  // estructura: exactamente (count-1) x 4 varints hasta el CRC
+  if (h.count == 0) return Verdict::BAD_LEN;
+  const uint8_t* p = data + sizeof(h);
+  const uint8_t* end = data + body;
+  for (uint16_t k = 0; k < (uint16_t)(h.count - 1) * 4u; k++) {
+    int32_t d;
+    if (!wpv2::getVarint(p, end, d)) return Verdict::BAD_LEN;
+  }
+  if (p != end) return Verdict::BAD_LEN;
+
+  cur_.magic = WIND_MAGIC;
+  cur_.version = WIND_VER;
+  cur_.timestamp_ms = h.timestamp_ms;
+  cur_.raw_angle = h.raw_angle;
+  cur_.angle_cdeg = h.angle_cdeg;
+  cur_.pps_centi = h.pps_centi;
+  cur_.rpm_centi = h.rpm_centi;
+  cur_.vbat_mV = h.vbat_mV;
+  cur_.status = h.status;
+  cur_.i2c_err_count = h.i2c_err_count;
+
+  p_ = data + sizeof(h);
+  end_ = end;
+  ts0_ = h.timestamp_ms;
+  period_ = h.period_ms;
+  count_ = h.count;
+  return Verdict::OK;
+}
+
+bool FrameReader::next(WindPacket& out) {
+  if (idx_ >= count_) return false;
+
+  if (idx_ > 0) {
+    // estructura ya verificada en open()
+    int32_t d[4] = {};
+    for (uint8_t k = 0; k < 4; k++) wpv2::getVarint(p_, end_, d[k]);
+    cur_.raw_angle  = wpv2::wrapAdd(cur_.raw_angle, d[0], wpv2::RAW_MOD);
+    cur_.angle_cdeg = wpv2::wrapAdd(cur_.angle_cdeg, d[1], wpv2::CDEG_MOD);
+    cur_.pps_centi  = (uint16_t)(cur_.pps_centi + d[2]);
+    cur_.rpm_centi  = (uint16_t)(cur_.rpm_centi + d[3]);
+    cur_.seq++;
+    cur_.timestamp_ms = ts0_ + (uint32_t)idx_ * period_;
+  }
+
+  out = cur_;
+  idx_++;
+  return true;
+}
+
+Derived derive(const WindPacket& p, const calib::Tables& cal) {
+  Derived d;
+  d.dir_cdeg = cal.dirCdeg(p.angle_cdeg);
+  d.spd_centi = cal.speedCenti(cal.speedSrc() == 0 ? p.pps_centi : p.rpm_centi);
+  d.spd_kn = (float)d.spd_centi * 0.01f;
+  return d;
+}
+
+} // namespace rxpipe
@@ -0,0 +1,50 @@
+#pragma once
+#include <stdint.h>
+#include "wind_packet.h"
+#include "wind_packet_v2.h"
+#include "calib.h"
+
+namespace rxpipe {
+
+// ===================== Camino de un paquete (sin Arduino) =====================
+// Lo que hacen onRecv() y processSample() con cada trama, separado de
+// ESP-NOW / millis() para poder reproducirlo en host (harness/).
+
+enum class Verdict : uint8_t { OK, BAD_LEN, BAD_MAGIC, BAD_CRC };
+
+// Copia + CRC de todo menos el campo crc16 en una sola pasada (solo v1)
+Verdict validate(const uint8_t* data, int len, WindPacket& out);
+
+// Trama v1 o v2: open() valida la trama entera (largo, magic/versión, CRC y
+// en v2 que los deltas llenen justo hasta el CRC); next() entrega cada
+// muestra como un WindPacket v1 (crc16 = 0, ya validada). Sin reservar
+// memoria; 'data' tiene que seguir vivo mientras se lee.
+class FrameReader {
+public:
+  Verdict open(const uint8_t* data, int len);
+  bool next(WindPacket& out);
+
+  uint8_t count() const { return count_; }
+  uint32_t seq() const { return cur_.seq; }   // muestra 0 (para rechazos)
+
+private:
+  WindPacket cur_ {};
+  const uint8_t* p_ = nullptr;
+  const uint8_t* end_ = nullptr;
+  uint32_t ts0_ = 0;
+  uint16_t period_ = 0;
+  uint8_t count_ = 0;
+  uint8_t idx_ = 0;
+};
+
+// Calibración (desvío + offset de proa, curva de velocidad x factor)
+// aplicada al paquete con las tablas ya compiladas: solo enteros
+struct Derived {
+  uint16_t dir_cdeg;     // 0..35999, corregida
+  float    spd_kn;       // spd_centi / 100
+  uint16_t spd_centi;    // kn * 100 saturado
+};
+
+Derived derive(const WindPacket& p, const calib::Tables& cal);
+
+} // namespace rxpipe
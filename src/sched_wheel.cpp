@@ -0,0 +1,176 @@
+#include "sched_wheel.h"
+#include <string.h>
+
+namespace sched {
+
+Wheel::Wheel() {
+  memset(head_, NONE, sizeof(head_));
+}
+
+// Slot del deadline; si ya pasó, el del tick actual (run() lo revisita)
+void Wheel::link(uint8_t id) {
+  Job& j = jobs_[id];
+  uint32_t t = j.deadline / TICK_MS;
+  if ((int32_t)(t - tick_) < 0) t = tick_;
+  j.slot = (uint8_t)(t & (WHEEL - 1));
+  j.next = head_[j.slot];
+  head_[j.slot] = id;
+  j.linked = true;
+}
+
+void Wheel::unlink(uint8_t id) {
+  if (!jobs_[id].linked) return;
+  jobs_[id].linked = false;
+  uint8_t* p = &head_[jobs_[id].slot];
+  while (*p != NONE) {
+    if (*p == id) {
+      *p = jobs_[id].next;
+      jobs_[id].next = NONE;
+      return;
+    }
+    p = &jobs_[*p].next;
+  }
+}
+
+uint8_t Wheel::add(uint32_t now, uint32_t delay_ms, uint32_t period_ms, Fn fn, void* ctx,
+                   const char* name) {
+  if (!started_) {
+    started_ = true;
+    tick_ = now / TICK_MS;
+  }
+  for (uint8_t id = 0; id < MAX_JOBS; id++) {
+    Job& j = jobs_[id];
+    if (j.used) continue;
+    j = Job();
+    j.fn = fn;
+    j.ctx = ctx;
+    j.name = name;
+    j.deadline = now + delay_ms;
+    j.period = period_ms;
+    j.used = true;
+    link(id);
+    return id;
+  }
+  return NONE;
+}
+
+uint8_t Wheel::every(uint32_t now, uint32_t period_ms, Fn fn, void* ctx, const char* name,
+                     uint32_t phase_ms) {
+  if (period_ms == 0) return NONE;
+  return add(now, phase_ms, period_ms, fn, ctx, name);
+}
+
+uint8_t Wheel::after(uint32_t now, uint32_t delay_ms, Fn fn, void* ctx, const char* name) {
+  return add(now, delay_ms, 0, fn, ctx, name);
+}
+
+void Wheel::cancel(uint8_t id) {
+  if (!active(id)) return;
+  unlink(id);
+  jobs_[id].used = false;
+}
+
+void Wheel::setPeriod(uint8_t id, uint32_t period_ms) {
+  if (!active(id) || jobs_[id].period == 0 || period_ms == 0) return;
+  Job& j = jobs_[id];
+  if (period_ms == j.period) return;
+  unlink(id);
+  j.deadline = j.deadline - j.period + period_ms;
+  j.period = period_ms;
+  link(id);
+}
+
+void Wheel::kick(uint8_t id, uint32_t now) {
+  if (!active(id)) return;
+  unlink(id);
+  jobs_[id].deadline = now;
+  link(id);
+}
+
+void Wheel::resetStats() {
+  for (uint8_t id = 0; id < MAX_JOBS; id++) jobs_[id].st = JobStats();
+}
+
+uint32_t Wheel::run(uint32_t now) {
+  if (!started_) return MAX_WAIT_MS;
+
+  // 1) sacar de la rueda lo vencido en los slots de los ticks que pasaron
+  uint8_t due[MAX_JOBS];
+  uint8_t n = 0;
+  const uint32_t nowTick = now / TICK_MS;
+  uint32_t steps = nowTick - tick_ + 1;
+  if ((int32_t)(nowTick - tick_) < 0) steps = 1;
+  if (steps > WHEEL) steps = WHEEL;
+
+  for (uint32_t s = 0; s < steps; s++) {
+    uint8_t* p = &head_[(tick_ + s) & (WHEEL - 1)];
+    while (*p != NONE) {
+      const uint8_t id = *p;
+      Job& j = jobs_[id];
+      if ((int32_t)(now - j.deadline) >= 0) {
+        *p = j.next;          // unlink
+        j.next = NONE;
+        j.linked = false;
+        due[n++] = id;
+      } else {
+        p = &j.next;          // otra vuelta de la rueda / más adelante en el tick
+      }
+    }
+  }
+  if ((int32_t)(nowTick - tick_) > 0) tick_ = nowTick;
+
+  // 2) en orden de deadline (n <= MAX_JOBS: inserción)
+  for (uint8_t i = 1; i < n; i++) {
+    const uint8_t id = due[i];
+    uint8_t k = i;
+    while (k > 0 && (int32_t)(jobs_[due[k - 1]].deadline - jobs_[id].deadline) > 0) {
+      due[k] = due[k - 1];
+      k--;
+    }
+    due[k] = id;
+  }
+
+  // 3) correr y reprogramar
+  for (uint8_t i = 0; i < n; i++) {
+    const uint8_t id = due[i];
+    Job& j = jobs_[id];
+    if (!j.used) continue;                 // cancelado por un job anterior
+    unlink(id);                            // re-agendado (kick) por un job anterior
+    if ((int32_t)(now - j.deadline) < 0) {
+      link(id);                            // ... para más adelante: todavía no toca
+      continue;
+    }
+
+    const uint32_t late = now - j.deadline;
+    if (late > j.st.maxLateMs) j.st.maxLateMs = late;
+    j.st.runs++;
+
+    if (j.period == 0) {
+      j.used = false;                      // one-shot: libre antes de correr (puede re-agendarse)
+      j.fn(now, j.ctx);
+      continue;
+    }
+
+    j.deadline += j.period;
+    if ((int32_t)(now - j.deadline) >= 0) {
+      const uint32_t k = (now - j.deadline) / j.period + 1;
+      j.st.overruns++;
+      j.st.skipped += k;
+      j.deadline += k * j.period;
+    }
+    link(id);
+    j.fn(now, j.ctx);
+  }
+
+  // 4) cuánto falta para el próximo
+  uint32_t wait = MAX_WAIT_MS;
+  for (uint8_t id = 0; id < MAX_JOBS; id++) {
+    if (!jobs_[id].used) continue;
+    const int32_t d = (int32_t)(jobs_[id].deadline - now);
+    if (d <= 0) return 0;
+    if ((uint32_t)d < wait) wait = (uint32_t)d;
+  }
+  return wait;
+}
+
+} // namespace sched
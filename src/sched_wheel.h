@@ -0,0 +1,89 @@
+#pragma once
+#include <stdint.h>
+
+namespace sched {
+
+// ===================== Timer wheel cooperativo =====================
+// Jobs periódicos y one-shot con capacidad fija, para loop(): run(now) corre
+// lo vencido y devuelve cuánto se puede dormir hasta el próximo deadline.
+//
+// Rueda hasheada de WHEEL slots de TICK_MS: cada job cuelga (lista enlazada
+// por índice) del slot de su deadline; run() solo visita los slots de los
+// ticks que pasaron, así el costo no crece con jobs lejanos. Los que están
+// a más de una vuelta se quedan en su slot hasta que el deadline venza.
+//
+// Deadlines sin deriva: el próximo es deadline + período, no now + período.
+// Si un job corre tarde por más de un período no se "pone al día" corriendo
+// varias veces: saltea los períodos perdidos (overrun) y conserva la fase.
+//
+// No es thread-safe: solo desde loop(). Sin Arduino (se prueba en host).
+
+using Fn = void (*)(uint32_t now, void* ctx);
+
+static constexpr uint8_t  MAX_JOBS = 16;
+static constexpr uint8_t  WHEEL = 64;           // potencia de 2
+static constexpr uint32_t TICK_MS = 4;          // 256 ms por vuelta
+static constexpr uint32_t MAX_WAIT_MS = 1000;   // tope de lo que devuelve run()
+static constexpr uint8_t  NONE = 0xFF;
+
+struct JobStats {
+  uint32_t runs = 0;
+  uint32_t overruns = 0;    // corridas tarde por >= 1 período
+  uint32_t skipped = 0;     // períodos salteados por esas demoras
+  uint32_t maxLateMs = 0;   // peor atraso respecto del deadline
+};
+
+class Wheel {
+public:
+  Wheel();
+
+  // Primera vez en now + phase_ms, después cada period_ms. NONE si no hay lugar.
+  uint8_t every(uint32_t now, uint32_t period_ms, Fn fn, void* ctx, const char* name,
+                uint32_t phase_ms = 0);
+  // Una sola vez en now + delay_ms
+  uint8_t after(uint32_t now, uint32_t delay_ms, Fn fn, void* ctx, const char* name);
+  void cancel(uint8_t id);
+
+  // Período nuevo para un job periódico; el próximo plazo se cuenta desde la
+  // última corrida (si ya pasó, corre en el próximo run())
+  void setPeriod(uint8_t id, uint32_t period_ms);
+  // Adelanta el próximo plazo a now (p. ej. redibujar apenas hay un botón);
+  // los siguientes siguen cada period desde ahí
+  void kick(uint8_t id, uint32_t now);
+
+  // Corre los vencidos en orden de deadline. Devuelve ms hasta el próximo
+  // deadline (0 = ya hay otro vencido), como mucho MAX_WAIT_MS.
+  uint32_t run(uint32_t now);
+
+  bool active(uint8_t id) const { return id < MAX_JOBS && jobs_[id].used; }
+  const char* name(uint8_t id) const { return jobs_[id].name; }
+  uint32_t period(uint8_t id) const { return jobs_[id].period; }
+  uint32_t deadline(uint8_t id) const { return jobs_[id].deadline; }
+  const JobStats& stats(uint8_t id) const { return jobs_[id].st; }
+  void resetStats();
+
+private:
+  struct Job {
+    Fn fn = nullptr;
+    void* ctx = nullptr;
+    const char* name = "";
+    uint32_t deadline = 0;
+    uint32_t period = 0;      // 0 = one-shot
+    uint8_t next = NONE;      // siguiente en el slot
+    uint8_t slot = 0;
+    bool used = false;
+    bool linked = false;      // colgado de un slot (no en la lista de vencidos)
+    JobStats st;
+  };
+
+  uint8_t add(uint32_t now, uint32_t delay_ms, uint32_t period_ms, Fn fn, void* ctx, const char* name);
+  void link(uint8_t id);
+  void unlink(uint8_t id);
+
+  Job jobs_[MAX_JOBS];
+  uint8_t head_[WHEEL];
+  uint32_t tick_ = 0;         // último tick visitado (se revisita en el próximo run)
+  bool started_ = false;
+};
+
+} // namespace sched
@@ -0,0 +1,214 @@
+#include "seq_track.h"
+
+namespace seqtrk {
+
+// ----------------- ventana de secuencia -----------------
+Kind SeqWindow::accept(uint32_t seq, uint32_t& gapOut, uint32_t& advOut) {
+  gapOut = 0;
+  advOut = 0;
+
+  // Lo anterior al primer paquete se da por visto: un LATE siempre
+  // corresponde a un hueco que se contó como perdido.
+  if (!have_) {
+    have_ = true;
+    top_ = seq;
+    bits_ = ~0ull;
+    advOut = 1;
+    return Kind::FIRST;
+  }
+
+  const int32_t d = (int32_t)(seq - top_);
+
+  if (d > 0) {
+    if ((uint32_t)d > MAX_JUMP) {
+      top_ = seq;
+      bits_ = ~0ull;
+      advOut = 1;
+      return Kind::RESET;
+    }
+    gapOut = (uint32_t)d - 1;
+    advOut = (uint32_t)d;
+    bits_ = ((uint32_t)d >= WINDOW) ? 1ull : ((bits_ << d) | 1ull);
+    const bool wrapped = seq < top_;
+    top_ = seq;
+    if (wrapped) return Kind::WRAP;
+    return gapOut ? Kind::GAP : Kind::NEXT;
+  }
+
+  const uint32_t back = (uint32_t)(-(int64_t)d);
+  if (back >= WINDOW) {
+    if (back > MAX_JUMP) {          // el transmisor reinició (seq volvió a 0)
+      top_ = seq;
+      bits_ = ~0ull;
+      advOut = 1;
+      return Kind::RESET;
+    }
+    return Kind::OLD;
+  }
+
+  const uint64_t mask = 1ull << back;
+  if (bits_ & mask) return Kind::DUP;
+  bits_ |= mask;
+  return Kind::LATE;
+}
+
+// ----------------- estadística por ventana -----------------
+float WinStats::lossPct() const {
+  if (expected == 0) return 0.0f;
+  // un tardío puede recuperar un hueco de un bucket que ya salió
+  const uint32_t miss = (expected > got) ? expected - got : 0;
+  return 100.0f * (float)miss / (float)expected;
+}
+
+uint16_t WinStats::jitterPctMs(uint8_t pct) const {
+  uint32_t total = 0;
+  for (uint8_t i = 0; i < JIT_BINS; i++) total += hist[i];
+  if (total == 0) return 0;
+
+  const uint32_t target = (total * pct + 99u) / 100u;
+  uint32_t acc = 0;
+  for (uint8_t i = 0; i < JIT_BINS - 1; i++) {
+    acc += hist[i];
+    if (acc >= target) return JIT_EDGES_MS[i];
+  }
+  return 0xFFFF;   // bin abierto (>= último borde)
+}
+
+void WinStats::add(const WinStats& o, int sign) {
+  expected += (uint32_t)(sign * (int32_t)o.expected);
+  got      += (uint32_t)(sign * (int32_t)o.got);
+  late     += (uint32_t)(sign * (int32_t)o.late);
+  dup      += (uint32_t)(sign * (int32_t)o.dup);
+  for (uint8_t i = 0; i < JIT_BINS; i++) hist[i] += (uint32_t)(sign * (int32_t)o.hist[i]);
+}
+
+static uint8_t jitterBin(uint32_t d_ms) {
+  uint8_t i = 0;
+  while (i < JIT_BINS - 1 && d_ms >= JIT_EDGES_MS[i]) i++;
+  return i;
+}
+
+// ----------------- contadores -----------------
+void Counters::count(Kind k, uint32_t gap) {
+  switch (k) {
+    case Kind::DUP:
+      dup++;
+      break;
+    case Kind::OLD:
+      old++;
+      break;
+    case Kind::LATE:
+      rx++;
+      late++;
+      if (lost) lost--;
+      break;
+    default:   // FIRST, NEXT, GAP, WRAP, RESET
+      rx++;
+      lost += gap;
+      if (k == Kind::WRAP) wrap++;
+      if (k == Kind::RESET) reset++;
+      break;
+  }
+}
+
+// ----------------- LinkStats -----------------
+void LinkStats::clearWindows() {
+  for (uint16_t i = 0; i < BUCKETS; i++) ring_[i] = WinStats();
+  sum10_ = WinStats();
+  sum60_ = WinStats();
+}
+
+void LinkStats::advance(uint32_t now_ms) {
+  const uint32_t sec = now_ms / 1000u;
+  if (!started_) {
+    started_ = true;
+    sec_ = sec;
+    return;
+  }
+  const uint32_t steps = sec - sec_;
+  // loop() puede leer con un 'now' apenas anterior al del último paquete
+  if (steps == 0 || (int32_t)steps < 0) return;
+  if (steps >= BUCKETS) {                          // hueco largo
+    clearWindows();
+    sec_ = sec;
+    return;
+  }
+
+  for (uint32_t k = 0; k < steps; k++) {
+    sec_++;
+    // sale de la ventana corta el bucket de hace SHORT_S s ...
+    sum10_.add(ring_[(sec_ - SHORT_S) % BUCKETS], -1);
+    // ... y de la larga el de hace BUCKETS s, que se reusa como actual
+    WinStats& b = cur();
+    sum60_.add(b, -1);
+    b = WinStats();
+  }
+}
+
+Kind LinkStats::onPacket(uint32_t seq, uint32_t now_ms) {
+  advance(now_ms);
+
+  uint32_t gap = 0, adv = 0;
+  const Kind k = win_.accept(seq, gap, adv);
+
+  tot_.count(k, gap);
+
+  WinStats d;
+  switch (k) {
+    case Kind::DUP:
+      d.dup = 1;
+      break;
+    case Kind::OLD:
+      break;
+    case Kind::LATE:
+      d.got = 1;
+      d.late = 1;
+      break;
+    default:   // FIRST, NEXT, GAP, WRAP, RESET
+      d.expected = adv;
+      d.got = 1;
+      break;
+  }
+
+  cur().add(d, 1);
+  sum10_.add(d, 1);
+  sum60_.add(d, 1);
+  return k;
+}
+
+void LinkStats::onArrival(uint32_t now_ms) {
+  advance(now_ms);
+
+  // jitter entre llegadas de trama
+  if (arrivals_ == 0) {
+    arrivals_ = 1;
+    lastArrMs_ = now_ms;
+    return;
+  }
+
+  const uint32_t iv = now_ms - lastArrMs_;
+  if (arrivals_ > 1) {
+    const uint32_t D = (iv > lastIvMs_) ? iv - lastIvMs_ : lastIvMs_ - iv;
+    jitter16_ = jitter16_ + D - (jitter16_ >> 4);
+    WinStats d;
+    d.hist[jitterBin(D)] = 1;
+    cur().add(d, 1);
+    sum10_.add(d, 1);
+    sum60_.add(d, 1);
+  } else {
+    arrivals_ = 2;
+  }
+  lastIvMs_ = iv;
+  lastArrMs_ = now_ms;
+}
+
+Summary LinkStats::summary() const {
+  Summary s;
+  s.tot = tot_;
+  s.w10 = sum10_;
+  s.w60 = sum60_;
+  s.jitter_ms = (uint16_t)((jitter16_ + 8u) >> 4);
+  return s;
+}
+
+} // namespace seqtrk
@@ -0,0 +1,113 @@
+#pragma once
+#include <stdint.h>
+
+namespace seqtrk {
+
+// ===================== Ventana de secuencia (bitmap 64) =====================
+// Como la ventana anti-replay de IPsec: 'top' es el seq más alto visto y el
+// bit i del bitmap marca si llegó top - i. Cada paquete se clasifica en O(1):
+//
+//   NEXT   : top + 1
+//   GAP    : salto hacia adelante; faltan (seq - top - 1) -> perdidos
+//   LATE   : atrasado dentro de la ventana y no visto -> recupera un perdido
+//   DUP    : ya visto
+//   OLD    : atrasado más de 64 (no se puede saber; no cuenta)
+//   WRAP   : hacia adelante pero el uint32 dio la vuelta
+//   RESET  : salto absurdo (reinicio del transmisor): se re-sincroniza
+//
+// "Perdidos" = huecos abiertos que no se recuperaron (baja con cada LATE).
+
+enum class Kind : uint8_t { FIRST, NEXT, GAP, LATE, DUP, OLD, WRAP, RESET };
+
+static constexpr uint32_t WINDOW = 64;
+static constexpr uint32_t MAX_JUMP = 1000;   // más que esto hacia adelante = RESET
+
+class SeqWindow {
+public:
+  // gapOut: seqs que se saltearon (solo GAP/WRAP), advOut: cuánto avanzó top
+  Kind accept(uint32_t seq, uint32_t& gapOut, uint32_t& advOut);
+  uint32_t top() const { return top_; }
+  bool started() const { return have_; }
+
+private:
+  uint32_t top_ = 0;
+  uint64_t bits_ = 0;
+  bool have_ = false;
+};
+
+// ===================== Estadística por ventana de tiempo =====================
+// Jitter = |intervalo actual - intervalo anterior| entre llegadas de trama, en ms.
+// Histograma de 8 bins con bordes JIT_EDGES_MS (el último es ">= 500").
+static constexpr uint8_t JIT_BINS = 8;
+static constexpr uint16_t JIT_EDGES_MS[JIT_BINS - 1] = { 5, 10, 20, 50, 100, 200, 500 };
+
+struct WinStats {
+  uint32_t expected = 0;   // avance de top (paquetes que debieron llegar)
+  uint32_t got = 0;        // paquetes nuevos (en orden + tardíos)
+  uint32_t late = 0;
+  uint32_t dup = 0;
+  uint32_t hist[JIT_BINS] = {};
+
+  // % perdido en la ventana (tardíos cuentan como recibidos)
+  float lossPct() const;
+  // Borde superior del bin que acumula 'pct' % de las muestras (0 = sin datos)
+  uint16_t jitterPctMs(uint8_t pct) const;
+
+  void add(const WinStats& o, int sign);
+};
+
+struct Counters {
+  uint32_t rx = 0;
+  uint32_t lost = 0;       // huecos sin recuperar
+  uint32_t late = 0;
+  uint32_t dup = 0;
+  uint32_t old = 0;
+  uint32_t wrap = 0;
+  uint32_t reset = 0;
+
+  // Acumula la clasificación de un paquete (gap: los que saltó)
+  void count(Kind k, uint32_t gap);
+};
+
+struct Summary {
+  Counters tot;
+  WinStats w10;            // últimos 10 s
+  WinStats w60;            // últimos 60 s
+  uint16_t jitter_ms = 0;  // estimador suavizado J += (|D| - J) / 16 (RFC 3550)
+};
+
+// Ventanas de 10 s y 60 s con buckets de 1 s y totales corridos:
+// O(1) por paquete, O(1) amortizado por segundo.
+class LinkStats {
+public:
+  static constexpr uint16_t BUCKETS = 60;
+  static constexpr uint16_t SHORT_S = 10;
+
+  // Una muestra (v1 = una por trama; v2 = varias con el mismo now_ms)
+  Kind onPacket(uint32_t seq, uint32_t now_ms);
+  // Una llegada de trama con al menos una muestra nueva: alimenta el jitter.
+  // Una vez por trama, no por muestra (las de un v2 comparten la llegada).
+  void onArrival(uint32_t now_ms);
+  void advance(uint32_t now_ms);
+  Summary summary() const;
+
+private:
+  WinStats& cur() { return ring_[sec_ % BUCKETS]; }
+  void clearWindows();
+
+  SeqWindow win_;
+  Counters tot_;
+
+  WinStats ring_[BUCKETS];
+  WinStats sum10_;
+  WinStats sum60_;
+  uint32_t sec_ = 0;
+  bool started_ = false;
+
+  uint32_t lastArrMs_ = 0;
+  uint32_t lastIvMs_ = 0;
+  uint8_t arrivals_ = 0;     // 0, 1, 2+ (hace falta 2 intervalos para D)
+  uint32_t jitter16_ = 0;    // J * 16
+};
+
+} // namespace seqtrk
@@ -0,0 +1,65 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <atomic>
+
+// ===================== Cola SPSC lock-free =====================
+// Un solo productor (callback WiFi / onRecv) y un solo consumidor (loop()).
+// Capacidad fija N (potencia de 2). head/tail son contadores libres que
+// se enmascaran al indexar, así "lleno" y "vacío" no se confunden.
+// Si está llena, push() descarta el nuevo elemento y cuenta overflow.
+
+template <typename T, uint32_t N>
+class SpscQueue {
+  static_assert(N >= 2 && (N & (N - 1)) == 0, "SpscQueue: N debe ser potencia de 2");
+
+public:
+  static constexpr uint32_t capacity() { return N; }
+
+  // Solo productor
+  bool push(const T& v) {
+    const uint32_t h = head_.load(std::memory_order_relaxed);
+    const uint32_t t = tail_.load(std::memory_order_acquire);
+    if ((h - t) >= N) {
+      overflow_.fetch_add(1, std::memory_order_relaxed);
+      return false;
+    }
+    buf_[h & (N - 1)] = v;
+    head_.store(h + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Solo consumidor
+  bool pop(T& out) {
+    const uint32_t t = tail_.load(std::memory_order_relaxed);
+    const uint32_t h = head_.load(std::memory_order_acquire);
+    if (h == t) return false;
+    out = buf_[t & (N - 1)];
+    tail_.store(t + 1, std::memory_order_release);
+    return true;
+  }
+
+  // Solo consumidor: saca hasta maxN elementos de una vez (un solo acquire/release)
+  size_t popBatch(T* out, size_t maxN) {
+    const uint32_t t = tail_.load(std::memory_order_relaxed);
+    const uint32_t h = head_.load(std::memory_order_acquire);
+    uint32_t n = h - t;
+    if (n > maxN) n = (uint32_t)maxN;
+    for (uint32_t i = 0; i < n; i++) out[i] = buf_[(t + i) & (N - 1)];
+    tail_.store(t + n, std::memory_order_release);
+    return n;
+  }
+
+  // Aproximado si se llama mientras el otro lado trabaja
+  uint32_t size() const {
+    return head_.load(std::memory_order_acquire) - tail_.load(std::memory_order_acquire);
+  }
+
+  uint32_t overflowCount() const { return overflow_.load(std::memory_order_relaxed); }
+
+private:
+  T buf_[N];
+  std::atomic<uint32_t> head_{0};
+  std::atomic<uint32_t> tail_{0};
+  std::atomic<uint32_t> overflow_{0};
+};
@@ -0,0 +1,74 @@
+#include "telemetry.h"
+#include <Arduino.h>
+
+namespace telem {
+
+static Print* s_out = nullptr;
+static volatile bool s_on = false;
+static Stats s_st;
+
+// Ring de tramas ya codificadas; pump() escribe lo que acepte el UART.
+// 2 KB ~ 0.18 s a 115200: absorbe un render lento sin perder registros.
+static constexpr uint16_t TX_LEN = 2048;   // potencia de 2
+static uint8_t  s_tx[TX_LEN];
+static uint16_t s_head = 0;                // próximo a escribir
+static uint16_t s_tail = 0;                // próximo a enviar
+
+static uint16_t txUsed() { return (uint16_t)(s_head - s_tail); }
+static uint16_t txFree() { return (uint16_t)(TX_LEN - txUsed()); }
+
+static void push(uint8_t type, const void* payload, size_t n) {
+  if (!s_on || !s_out) return;
+
+  uint8_t frame[MAX_FRAME];
+  const size_t m = buildFrame(type, payload, n, frame);
+  if (m == 0 || m > txFree()) {
+    s_st.dropped++;
+    return;
+  }
+  for (size_t i = 0; i < m; i++) s_tx[(uint16_t)(s_head + i) & (TX_LEN - 1)] = frame[i];
+  s_head = (uint16_t)(s_head + m);
+  s_st.frames++;
+}
+
+void begin(Print& out) {
+  s_out = &out;
+  s_head = s_tail = 0;
+}
+
+void setEnabled(bool on) {
+  // al entrar, un 0x00 suelto cierra cualquier texto previo en el receptor
+  if (on && !s_on && s_out && txFree() > 0) {
+    s_tx[s_head & (TX_LEN - 1)] = 0x00;
+    s_head++;
+  }
+  s_on = on;
+}
+
+bool enabled() { return s_on; }
+
+void pushPkt(const RecPkt& r) { push(REC_PKT, &r, sizeof(r)); }
+void pushRej(const RecRej& r) { push(REC_REJ, &r, sizeof(r)); }
+
+void pump() {
+  if (!s_out) return;
+
+  int room = s_out->availableForWrite();
+  while (room > 0 && txUsed() > 0) {
+    // tramo contiguo hasta el fin del ring
+    const uint16_t t = s_tail & (TX_LEN - 1);
+    uint16_t n = txUsed();
+    if (n > TX_LEN - t) n = (uint16_t)(TX_LEN - t);
+    if (n > (uint16_t)room) n = (uint16_t)room;
+
+    const size_t w = s_out->write(&s_tx[t], n);
+    if (w == 0) break;
+    s_tail = (uint16_t)(s_tail + w);
+    s_st.bytes += (uint32_t)w;
+    room -= (int)w;
+  }
+}
+
+const Stats& stats() { return s_st; }
+
+} // namespace telem
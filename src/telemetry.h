@@ -0,0 +1,133 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "wind_packet.h"
+#include "crc16_modbus.h"
+
+class Print;
+
+namespace telem {
+
+// ===================== Telemetría binaria (Serial USB) =====================
+// Modo opcional que reemplaza el log de texto: un registro por paquete
+// aceptado y por trama rechazada, a tasa completa.
+//
+// Trama:  COBS( tipo | payload | crc16 LE ) 0x00
+//   - COBS: el 0x00 solo aparece como delimitador -> resync trivial
+//   - crc16: CRC16-Modbus de tipo + payload
+// Todo little-endian (igual que el ESP32), structs packed.
+//
+// Este header no depende de Arduino: lo usa también tools/telem_decode.cpp.
+
+enum RecType : uint8_t {
+  REC_PKT = 1,       // RecPkt
+  REC_REJ = 2,       // RecRej
+};
+
+enum Reject : uint8_t {
+  REJ_LEN = 1,       // largo != sizeof(WindPacket)
+  REJ_MAGIC,         // magic / versión
+  REJ_CRC,
+  REJ_DUP,           // seq ya visto
+  REJ_OLD,           // seq atrasado más que la ventana
+  REJ_LATE,          // seq atrasado dentro de la ventana (cuenta como recibido)
+};
+
+struct __attribute__((packed)) RecPkt {
+  uint32_t rx_ms;
+  WindPacket pkt;
+  uint16_t dir_cdeg;     // dirección corregida (offset), 0..35999
+  uint16_t spd_centi;    // velocidad calculada (fuente x factor), kn*100
+};
+
+struct __attribute__((packed)) RecRej {
+  uint32_t rx_ms;
+  uint8_t  reason;       // Reject
+  uint8_t  len;          // largo recibido (saturado a 255)
+  uint32_t seq;          // seq del paquete si se pudo leer, si no 0
+};
+
+static_assert(sizeof(RecPkt) == 36, "RecPkt: layout de telemetría cambió");
+static_assert(sizeof(RecRej) == 10, "RecRej: layout de telemetría cambió");
+
+static constexpr size_t MAX_REC   = 1 + sizeof(RecPkt) + 2;       // tipo + payload + crc
+static constexpr size_t MAX_FRAME = MAX_REC + MAX_REC / 254 + 2;  // + overhead COBS + 0x00
+
+// ----------------- COBS -----------------
+// Devuelve bytes escritos en out (sin el 0x00 final). out >= n + n/254 + 1.
+static inline size_t cobsEncode(const uint8_t* in, size_t n, uint8_t* out) {
+  size_t o = 1, code_at = 0;
+  uint8_t code = 1;
+  for (size_t i = 0; i < n; i++) {
+    if (in[i] == 0) {
+      out[code_at] = code;
+      code_at = o++;
+      code = 1;
+    } else {
+      out[o++] = in[i];
+      if (++code == 0xFF) {
+        out[code_at] = code;
+        code_at = o++;
+        code = 1;
+      }
+    }
+  }
+  out[code_at] = code;
+  return o;
+}
+
+// Decodifica una trama sin el 0x00. Devuelve bytes en out, o 0 si es inválida.
+static inline size_t cobsDecode(const uint8_t* in, size_t n, uint8_t* out, size_t cap) {
+  size_t i = 0, o = 0;
+  while (i < n) {
+    const uint8_t code = in[i++];
+    if (code == 0) return 0;
+    for (uint8_t k = 1; k < code; k++) {
+      if (i >= n || o >= cap || in[i] == 0) return 0;
+      out[o++] = in[i++];
+    }
+    if (code != 0xFF && i < n) {
+      if (o >= cap) return 0;
+      out[o++] = 0;
+    }
+  }
+  return o;
+}
+
+// Arma la trama completa (con 0x00 final) en out[MAX_FRAME]. 0 si no entra.
+static inline size_t buildFrame(uint8_t type, const void* payload, size_t n, uint8_t* out) {
+  if (n + 3 > MAX_REC) return 0;
+  uint8_t rec[MAX_REC];
+  rec[0] = type;
+  const uint8_t* p = (const uint8_t*)payload;
+  for (size_t i = 0; i < n; i++) rec[1 + i] = p[i];
+  const uint16_t crc = crc16_modbus(rec, n + 1);
+  rec[n + 1] = (uint8_t)(crc & 0xFF);
+  rec[n + 2] = (uint8_t)(crc >> 8);
+
+  const size_t m = cobsEncode(rec, n + 3, out);
+  out[m] = 0x00;
+  return m + 1;
+}
+
+// ----------------- lado equipo -----------------
+struct Stats {
+  uint32_t frames = 0;
+  uint32_t bytes = 0;
+  uint32_t dropped = 0;   // no entraron en el buffer (enlace saturado)
+};
+
+void begin(Print& out);
+void setEnabled(bool on);
+bool enabled();
+
+// Encola la trama entera o nada; nunca bloquea
+void pushPkt(const RecPkt& r);
+void pushRej(const RecRej& r);
+
+// Escribe lo que acepte el UART (llamar en cada loop)
+void pump();
+
+const Stats& stats();
+
+} // namespace telem
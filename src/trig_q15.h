@@ -0,0 +1,179 @@
+#pragma once
+#include <stdint.h>
+
+// ===================== Trig entera (Q15 / BAM) =====================
+// Ángulos en BAM (binary angle units): 65536 = 360°, el wrap es gratis
+// con aritmética uint16/int16. sin/cos devuelven Q15 (32767 = 1.0).
+//
+// Tablas generadas en compile-time (constexpr, en flash):
+//  - cuarto de onda de seno, 257 entradas + interpolación lineal
+//    error máx |sinQ15 - sin| <= 1.03 LSB Q15 (~3e-5)
+//  - arcotangente en [0,1], 257 entradas en 1/4 BAM + interpolación lineal
+//    error máx atan2Bam <= 1 BAM (~0.0055°) para vectores con |v| >= 256
+// (cotas verificadas en host con harness/trig_host)
+//
+// Convención de pantalla (rumbo): 0 = arriba, sentido horario.
+
+namespace trig {
+
+using angle_t = uint16_t;
+
+static constexpr angle_t BAM_90  = 16384;
+static constexpr angle_t BAM_180 = 32768;
+static constexpr int32_t Q15_ONE = 32767;
+
+// ----------------- conversiones -----------------
+static constexpr angle_t fromDdeg(uint32_t ddeg) {   // décimas de grado
+  return (angle_t)(((ddeg % 3600u) * 65536u + 1800u) / 3600u);
+}
+static constexpr angle_t fromCdeg(uint32_t cdeg) {   // centésimas de grado
+  return (angle_t)(((cdeg % 36000u) * 65536u + 18000u) / 36000u);
+}
+static constexpr uint16_t toDdeg(angle_t a) {        // 0..3599
+  return (uint16_t)((((uint32_t)a * 3600u) + 32768u) >> 16) % 3600u;
+}
+static inline angle_t fromDegF(float deg) {          // sin trig, solo escala
+  return (angle_t)(int32_t)(deg * (65536.0f / 360.0f) + (deg >= 0 ? 0.5f : -0.5f));
+}
+
+// ----------------- generación constexpr -----------------
+namespace detail {
+
+constexpr double PI = 3.14159265358979323846;
+
+// Taylor alrededor de 0, x en [0, pi/2]
+constexpr double sinSeries(double x) {
+  double term = x, sum = x;
+  for (int k = 1; k < 12; k++) {
+    term *= -x * x / (double)((2 * k) * (2 * k + 1));
+    sum += term;
+  }
+  return sum;
+}
+
+// atan(z) para |z| <= 0.42 (serie), con reducción para z en [0,1]
+constexpr double atanSmall(double z) {
+  double term = z, sum = z;
+  for (int k = 1; k < 30; k++) {
+    term *= -z * z;
+    sum += term / (double)(2 * k + 1);
+  }
+  return sum;
+}
+constexpr double atan01(double z) {
+  return (z > 0.4142) ? (PI / 4 + atanSmall((z - 1.0) / (z + 1.0))) : atanSmall(z);
+}
+
+struct Tables {
+  int16_t  sinQ[257];   // sin(i * 90°/256) en Q15
+  uint16_t atanB[257];  // atan(i/256) en 1/4 BAM (0..32768)
+};
+
+constexpr Tables makeTables() {
+  Tables t {};
+  for (int i = 0; i <= 256; i++) {
+    const double s = sinSeries((PI / 2) * (double)i / 256.0);
+    t.sinQ[i] = (int16_t)(s * 32767.0 + 0.5);
+    const double a = atan01((double)i / 256.0);
+    t.atanB[i] = (uint16_t)(a * (4 * 32768.0 / PI) + 0.5);
+  }
+  return t;
+}
+
+inline constexpr Tables TABLES = makeTables();
+
+static_assert(TABLES.sinQ[0] == 0 && TABLES.sinQ[256] == 32767, "sin Q15 mal generada");
+static_assert(TABLES.sinQ[128] == 23170, "sin Q15 mal generada");   // sin 45°
+static_assert(TABLES.atanB[256] == 32768, "atan BAM mal generada");  // 45°
+
+} // namespace detail
+
+// ----------------- sin / cos -----------------
+static inline int16_t sinQ15(angle_t a) {
+  // cuadrante (2 bits) | índice en cuarto de onda (8 bits) | fracción (6 bits)
+  const uint8_t quad = (uint8_t)(a >> 14);
+  uint16_t x = (uint16_t)(a & 0x3FFF);
+  if (quad & 1) x = (uint16_t)(0x4000 - x);     // espejo 90..180 / 270..360
+  const uint16_t i = (uint16_t)(x >> 6);
+  const int32_t  f = (int32_t)(x & 0x3F);
+  int32_t v = detail::TABLES.sinQ[i];
+  if (i < 256) v += ((detail::TABLES.sinQ[i + 1] - v) * f + 32) >> 6;
+  return (int16_t)((quad & 2) ? -v : v);
+}
+
+static inline int16_t cosQ15(angle_t a) {
+  return sinQ15((angle_t)(a + BAM_90));
+}
+
+// ----------------- atan2 -----------------
+// Devuelve el ángulo matemático de (x, y) en BAM. (0,0) -> 0.
+static inline angle_t atan2Bam(int32_t y, int32_t x) {
+  uint32_t ax = (x < 0) ? (uint32_t)(-(int64_t)x) : (uint32_t)x;
+  uint32_t ay = (y < 0) ? (uint32_t)(-(int64_t)y) : (uint32_t)y;
+  if (ax == 0 && ay == 0) return 0;
+
+  const bool swap = ay > ax;
+  uint32_t num = swap ? ax : ay;
+  uint32_t den = swap ? ay : ax;
+  while (den >= (1u << 16)) { num >>= 1; den >>= 1; }   // ratio Q16 sin 64 bits
+
+  const uint32_t r = ((num << 16) + den / 2) / den;      // 0..65536, redondeado
+  const uint32_t i = r >> 8;
+  const int32_t  f = (int32_t)(r & 0xFF);
+  int32_t a = detail::TABLES.atanB[i];
+  if (i < 256) a += ((detail::TABLES.atanB[i + 1] - a) * f + 128) >> 8;
+  a = (a + 2) >> 2;                                      // 1/4 BAM -> BAM
+
+  if (swap)  a = BAM_90 - a;
+  if (x < 0) a = BAM_180 - a;
+  if (y < 0) a = -a;
+  return (angle_t)a;
+}
+
+// Lo mismo para sumas de 64 bits (totales de ventanas largas): se corren
+// a la derecha hasta entrar en int32, el cociente y/x no cambia.
+static inline angle_t atan2Bam64(int64_t y, int64_t x) {
+  while (y > INT32_MAX || y < -INT32_MAX || x > INT32_MAX || x < -INT32_MAX) { y >>= 1; x >>= 1; }
+  return atan2Bam((int32_t)y, (int32_t)x);
+}
+
+// ----------------- geometría de pantalla -----------------
+struct Pt {
+  int16_t x;
+  int16_t y;
+};
+
+// Punto a len16/16 px del centro en dirección de rumbo b (0=arriba, horario).
+// Trunca hacia cero como el (int) de la versión float. Se divide por
+// Q15_ONE (no 32768) para que en los cardinales llegue al largo completo.
+static inline Pt polar(int16_t cx, int16_t cy, angle_t b, int32_t len16) {
+  const int32_t dx = ((int32_t)sinQ15(b) * len16) / (Q15_ONE * 16);
+  const int32_t dy = ((int32_t)cosQ15(b) * len16) / (Q15_ONE * 16);
+  return Pt { (int16_t)(cx + dx), (int16_t)(cy - dy) };
+}
+
+// Flecha triangular: punta a tipLen16, base en el centro con media base halfW16
+static inline void arrow(int16_t cx, int16_t cy, angle_t b,
+                         int32_t tipLen16, int32_t halfW16, Pt out[3]) {
+  out[0] = polar(cx, cy, b, tipLen16);
+  out[1] = polar(cx, cy, (angle_t)(b + BAM_90), halfW16);
+  out[2] = polar(cx, cy, (angle_t)(b - BAM_90), halfW16);
+}
+
+// ----------------- media circular -----------------
+// Suma vectorial entera de ángulos (Q15). Con int32 entran >65000 muestras.
+struct VecSum {
+  int32_t s = 0;
+  int32_t c = 0;
+  uint32_t n = 0;
+
+  void add(angle_t a) { s += sinQ15(a); c += cosQ15(a); n++; }
+  void sub(angle_t a) { s -= sinQ15(a); c -= cosQ15(a); n--; }
+  void add(const VecSum& o) { s += o.s; c += o.c; n += o.n; }
+
+  // Rumbo medio (BAM). Como sin/cos van en convención matemática
+  // con el mismo ángulo, la media sale en la misma escala que la entrada.
+  angle_t mean() const { return atan2Bam(s, c); }
+};
+
+} // namespace trig
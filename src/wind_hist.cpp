@@ -0,0 +1,128 @@
+#include "wind_hist.h"
+#include "trig_q15.h"
+
+namespace hist {
+
+void History10m::append(uint16_t dir_ddeg, uint16_t spd_centi) {
+  dir_ddeg_[head_]  = dir_ddeg;
+  spd_centi_[head_] = spd_centi;
+  head_ = (head_ + 1) % HIST_LEN;
+  if (head_ == 0) full_ = true;
+
+  // Columna actual llena -> abrir la siguiente (pisa la más vieja)
+  if (ncols_ == 0 || cols_[colHead_].n >= COL_SAMPLES) {
+    if (ncols_ > 0) {
+      const Column& done = cols_[colHead_];
+      minQ_.push(colSeq_, done.min_spd);
+      maxQ_.push(colSeq_, done.max_spd);
+      colHead_ = (colHead_ + 1) % COLS;
+      colSeq_++;
+    }
+    if (ncols_ < COLS) {
+      ncols_++;
+    } else {
+      const Column& old = cols_[colHead_];      // sale de la ventana
+      run_.sum_sin -= old.sum_sin;
+      run_.sum_cos -= old.sum_cos;
+      run_.n -= old.n;
+    }
+    cols_[colHead_] = Column();
+
+    // quedan visibles las COLS-1 columnas cerradas anteriores a la actual
+    const uint16_t oldest = (uint16_t)(colSeq_ - (COLS - 1));
+    minQ_.expire(oldest);
+    maxQ_.expire(oldest);
+  }
+
+  Column& c = cols_[colHead_];
+  if (c.n == 0) {
+    c.min_spd = spd_centi;
+    c.max_spd = spd_centi;
+  } else {
+    if (spd_centi < c.min_spd) c.min_spd = spd_centi;
+    if (spd_centi > c.max_spd) c.max_spd = spd_centi;
+  }
+  c.sum_spd += spd_centi;
+
+  const trig::angle_t a = trig::fromDdeg(dir_ddeg);
+  const int16_t s = trig::sinQ15(a);
+  const int16_t co = trig::cosQ15(a);
+  c.sum_sin += s;
+  c.sum_cos += co;
+  c.n++;
+
+  run_.sum_sin += s;
+  run_.sum_cos += co;
+  run_.n++;
+}
+
+const Column& History10m::column(uint16_t i) const {
+  // la más vieja está ncols_-1 lugares detrás de colHead_
+  int idx = (int)colHead_ - (int)(ncols_ - 1) + (int)i;
+  if (idx < 0) idx += COLS;
+  return cols_[idx];
+}
+
+Totals History10m::totals() const {
+  Totals t = run_;
+  if (t.n == 0) return t;
+
+  // columna actual (siempre con n > 0 si hay datos) + extremos de las cerradas
+  const Column& c = cols_[colHead_];
+  t.min_spd = c.min_spd;
+  t.max_spd = c.max_spd;
+  if (!minQ_.empty() && minQ_.value() < t.min_spd) t.min_spd = minQ_.value();
+  if (!maxQ_.empty() && maxQ_.value() > t.max_spd) t.max_spd = maxQ_.value();
+  return t;
+}
+
+// ----------------- tiers -----------------
+void BucketAcc::add(uint16_t dir_ddeg, uint16_t spd_centi) {
+  if (n == 0 || spd_centi < min_spd) min_spd = spd_centi;
+  if (n == 0 || spd_centi > max_spd) max_spd = spd_centi;
+  sum_spd += spd_centi;
+
+  const trig::angle_t a = trig::fromDdeg(dir_ddeg);
+  sum_sin += trig::sinQ15(a);
+  sum_cos += trig::cosQ15(a);
+  n++;
+}
+
+void BucketAcc::add(const Bucket& b, uint16_t weight) {
+  if (n == 0 || b.min_spd < min_spd) min_spd = b.min_spd;
+  if (n == 0 || b.max_spd > max_spd) max_spd = b.max_spd;
+  sum_spd += (uint32_t)b.mean_spd * weight;
+
+  // dirección del bucket fino pesada por su cantidad de muestras
+  const trig::angle_t a = trig::fromDdeg(b.dir_ddeg);
+  sum_sin += (int32_t)trig::sinQ15(a) * weight;
+  sum_cos += (int32_t)trig::cosQ15(a) * weight;
+  n = (uint16_t)(n + weight);
+}
+
+Bucket BucketAcc::close() {
+  Bucket b;
+  b.mean_spd = n ? (uint16_t)((sum_spd + n / 2) / n) : 0;
+  b.min_spd  = min_spd;
+  b.max_spd  = max_spd;
+  b.dir_ddeg = trig::toDdeg(trig::atan2Bam(sum_sin, sum_cos));
+  *this = BucketAcc();
+  return b;
+}
+
+void WindHistory::append(uint16_t dir_ddeg, uint16_t spd_centi) {
+  t0_.append(dir_ddeg, spd_centi);
+
+  acc1_.add(dir_ddeg, spd_centi);
+  if (acc1_.n < T1_SEC) return;
+
+  const Bucket b1 = acc1_.close();
+  t1_.push(b1);
+
+  acc2_.add(b1, T1_SEC);
+  if (acc2_.n < T2_SEC) return;
+
+  t2_.push(acc2_.close());
+}
+
+} // namespace hist
@@ -0,0 +1,156 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include "mono_deque.h"
+
+namespace hist {
+
+// ===================== Historial 10 min (1 Hz) =====================
+static constexpr int HIST_LEN    = 600;              // 600 s
+static constexpr int COL_SAMPLES = 5;                // 5 s por columna (120 px)
+static constexpr int COLS        = HIST_LEN / COL_SAMPLES;
+
+// Agregado de una columna de 5 s, se actualiza en cada append
+struct Column {
+  uint32_t sum_spd = 0;      // kn*100
+  uint16_t min_spd = 0;
+  uint16_t max_spd = 0;
+  int32_t  sum_sin = 0;      // Q15, media circular: trig::atan2Bam(sum_sin, sum_cos)
+  int32_t  sum_cos = 0;
+  uint8_t  n = 0;
+};
+
+// Totales de toda la ventana visible (corridos en el append, O(1))
+struct Totals {
+  uint32_t n = 0;
+  uint16_t min_spd = 0;
+  uint16_t max_spd = 0;
+  int32_t  sum_sin = 0;      // Q15
+  int32_t  sum_cos = 0;
+};
+
+class History10m {
+public:
+  // dir en décimas de grado (0..3599), velocidad kn*100
+  void append(uint16_t dir_ddeg, uint16_t spd_centi);
+
+  // Muestras crudas (ring de HIST_LEN, head = próximo a escribir)
+  const uint16_t* dirDdeg() const { return dir_ddeg_; }
+  const uint16_t* spdCenti() const { return spd_centi_; }
+  uint16_t head() const { return head_; }
+  bool full() const { return full_; }
+  uint16_t count() const { return full_ ? HIST_LEN : head_; }
+
+  // Columnas alineadas a múltiplos de 5 muestras; la más nueva puede estar parcial.
+  // i: 0 = más vieja, columnCount()-1 = actual
+  uint16_t columnCount() const { return ncols_; }
+  const Column& column(uint16_t i) const;
+
+  Totals totals() const;
+
+private:
+  uint16_t dir_ddeg_[HIST_LEN] = {};
+  uint16_t spd_centi_[HIST_LEN] = {};
+  uint16_t head_ = 0;
+  bool full_ = false;
+
+  Column cols_[COLS] = {};
+  uint16_t colHead_ = 0;    // columna actual (en llenado)
+  uint16_t ncols_ = 0;
+
+  // min/max de las columnas cerradas visibles (clave = nro de columna);
+  // la actual se combina en totals()
+  uint16_t colSeq_ = 0;
+  MonoDeque<COLS, false> minQ_;
+  MonoDeque<COLS, true>  maxQ_;
+  Totals run_;              // sumas de todas las columnas visibles (min/max sin usar)
+};
+
+// ===================== Historial multi-resolución =====================
+// Tier 0: 1 s x 600 (10 min)  -> History10m
+// Tier 1: 10 s x 360 (1 h)    -> bucket = 10 muestras de tier 0
+// Tier 2: 2 min x 720 (24 h)  -> bucket = 12 buckets de tier 1
+// Todo se alimenta del append de 1 Hz y cascadea al cerrar cada bucket.
+
+static constexpr uint16_t T1_LEN = 360;
+static constexpr uint16_t T1_SEC = 10;
+static constexpr uint16_t T2_LEN = 720;
+static constexpr uint16_t T2_PER_T1 = 12;             // 12 x 10 s = 2 min
+static constexpr uint16_t T2_SEC = T1_SEC * T2_PER_T1;
+
+static constexpr size_t HIST_RAM_BUDGET = 16 * 1024;  // bytes, todo el historial
+
+// Bucket cerrado (8 bytes)
+struct Bucket {
+  uint16_t mean_spd;   // kn*100
+  uint16_t min_spd;
+  uint16_t max_spd;
+  uint16_t dir_ddeg;   // media circular, 0..3599
+};
+
+// Acumulador de un bucket en curso
+struct BucketAcc {
+  uint32_t sum_spd = 0;
+  uint16_t min_spd = 0;
+  uint16_t max_spd = 0;
+  int32_t  sum_sin = 0;   // Q15
+  int32_t  sum_cos = 0;
+  uint16_t n = 0;
+
+  void add(uint16_t dir_ddeg, uint16_t spd_centi);  // una muestra de 1 s
+  void add(const Bucket& b, uint16_t weight);       // un bucket fino (cascada)
+  Bucket close();                                   // devuelve y resetea
+};
+
+// Vista de solo lectura de un tier (para pantallas): 0 = más viejo
+struct TierView {
+  const Bucket* buf;
+  uint16_t len;
+  uint16_t head;          // próximo a escribir
+  uint16_t count;
+  uint16_t bucket_s;      // segundos por bucket
+
+  const Bucket& at(uint16_t i) const {
+    uint16_t idx = (uint16_t)(head + len - count + i);
+    if (idx >= len) idx -= len;
+    return buf[idx];
+  }
+};
+
+template <uint16_t LEN>
+class Tier {
+public:
+  void push(const Bucket& b) {
+    buf_[head_] = b;
+    head_ = (uint16_t)((head_ + 1) % LEN);
+    if (count_ < LEN) count_++;
+  }
+  uint16_t count() const { return count_; }
+  TierView view(uint16_t bucket_s) const { return TierView { buf_, LEN, head_, count_, bucket_s }; }
+
+private:
+  Bucket buf_[LEN] = {};
+  uint16_t head_ = 0;
+  uint16_t count_ = 0;
+};
+
+class WindHistory {
+public:
+  // Punto único de entrada (1 Hz)
+  void append(uint16_t dir_ddeg, uint16_t spd_centi);
+
+  const History10m& h10m() const { return t0_; }
+  TierView h1h() const { return t1_.view(T1_SEC); }
+  TierView h24h() const { return t2_.view(T2_SEC); }
+
+private:
+  History10m t0_;
+  BucketAcc acc1_;
+  Tier<T1_LEN> t1_;
+  BucketAcc acc2_;
+  Tier<T2_LEN> t2_;
+};
+
+static_assert(sizeof(WindHistory) <= HIST_RAM_BUDGET, "historial excede HIST_RAM_BUDGET");
+
+} // namespace hist
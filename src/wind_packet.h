@@ -19,3 +19,4 @@ struct __attribute__((packed)) WindPacket {
 static_assert(sizeof(WindPacket) == 28, "WindPacket must be 28 bytes");
 static constexpr uint16_t WIND_MAGIC = 0x574E;
 static constexpr uint16_t WIND_VER   = 1;
+// v2 (N muestras delta por trama): ver wind_packet_v2.h
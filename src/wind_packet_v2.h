@@ -0,0 +1,159 @@
+#pragma once
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+#include "wind_packet.h"
+#include "crc16_modbus.h"
+
+// ===================== WindPacket v2: N muestras por trama =====================
+// Mismo magic, version = 2. Cabecera fija + muestra 0 completa, después
+// (count-1) muestras como deltas respecto de la anterior y el CRC16-Modbus
+// de todo lo previo al final:
+//
+//   [WindPacketV2Hdr 30 B][delta 1]...[delta count-1][crc16]
+//
+// Cada delta son 4 varints zigzag (LEB128): raw_angle, angle_cdeg, pps, rpm.
+// Los ángulos van por el camino corto (raw mod 4096, cdeg mod 36000), así un
+// cruce por el norte sigue siendo un delta chico. Con viento normal a 20-50
+// Hz cada delta ocupa 4-6 B: ~40-55 muestras en los 250 B de ESP-NOW contra
+// 28 B por muestra en v1.
+//
+// La muestra i lleva seq + i y timestamp_ms + i * period_ms; vbat/status/
+// i2c_err son los de la trama. El receptor la convierte en un WindPacket v1
+// (rxpipe::FrameReader) y sigue por el mismo camino.
+
+static constexpr uint16_t WIND_VER2 = 2;
+static constexpr size_t   ESPNOW_MAX_LEN = 250;
+
+struct __attribute__((packed)) WindPacketV2Hdr {
+  uint16_t magic;          // WIND_MAGIC
+  uint16_t version;        // 2
+  uint32_t seq;            // de la muestra 0
+  uint32_t timestamp_ms;   // de la muestra 0
+  uint16_t period_ms;      // entre muestras
+  uint8_t  count;          // >= 1
+  uint8_t  flags;          // 0 (reservado)
+  uint16_t vbat_mV;
+  uint16_t status;
+  uint16_t i2c_err_count;
+  uint16_t raw_angle;      // muestra 0
+  uint16_t angle_cdeg;
+  uint16_t pps_centi;
+  uint16_t rpm_centi;
+};
+
+static_assert(sizeof(WindPacketV2Hdr) == 30, "WindPacketV2Hdr must be 30 bytes");
+
+namespace wpv2 {
+
+static constexpr size_t MIN_LEN = sizeof(WindPacketV2Hdr) + 2;
+static constexpr uint16_t RAW_MOD = 4096;
+static constexpr uint16_t CDEG_MOD = 36000;
+static constexpr size_t MAX_DELTA_LEN = 4 * 3;   // 4 varints de <= 17 bits
+
+// Delta por el camino corto en un círculo de 'mod'
+static inline int32_t wrapDelta(uint16_t from, uint16_t to, uint16_t mod) {
+  int32_t d = (int32_t)to - (int32_t)from;
+  if (d >= (int32_t)(mod / 2)) d -= mod;
+  else if (d < -(int32_t)(mod / 2)) d += mod;
+  return d;
+}
+
+static inline uint16_t wrapAdd(uint16_t base, int32_t d, uint16_t mod) {
+  int32_t v = ((int32_t)base + d) % (int32_t)mod;
+  if (v < 0) v += mod;
+  return (uint16_t)v;
+}
+
+static inline size_t putVarint(uint8_t* out, int32_t d) {
+  uint32_t z = ((uint32_t)d << 1) ^ (uint32_t)(d >> 31);
+  size_t n = 0;
+  while (z >= 0x80) {
+    out[n++] = (uint8_t)(z | 0x80);
+    z >>= 7;
+  }
+  out[n++] = (uint8_t)z;
+  return n;
+}
+
+// false si se termina el buffer o el varint pasa de 5 bytes
+static inline bool getVarint(const uint8_t*& p, const uint8_t* end, int32_t& d) {
+  uint32_t z = 0;
+  for (uint8_t shift = 0; shift < 35; shift += 7) {
+    if (p >= end) return false;
+    const uint8_t c = *p++;
+    z |= (uint32_t)(c & 0x7F) << shift;
+    if (!(c & 0x80)) {
+      d = (int32_t)(z >> 1) ^ -(int32_t)(z & 1);
+      return true;
+    }
+  }
+  return false;
+}
+
+// ----------------- encoder (transmisor / harness) -----------------
+// Uso: begin(...); while (add(...)) {}; n = finish(); send(data(), n)
+class Builder {
+public:
+  void begin(uint32_t seq, uint32_t timestamp_ms, uint16_t period_ms,
+             uint16_t vbat_mV, uint16_t status, uint16_t i2c_err_count) {
+    memset(&hdr_, 0, sizeof(hdr_));
+    hdr_.magic = WIND_MAGIC;
+    hdr_.version = WIND_VER2;
+    hdr_.seq = seq;
+    hdr_.timestamp_ms = timestamp_ms;
+    hdr_.period_ms = period_ms;
+    hdr_.vbat_mV = vbat_mV;
+    hdr_.status = status;
+    hdr_.i2c_err_count = i2c_err_count;
+    len_ = sizeof(WindPacketV2Hdr);
+  }
+
+  // false si la muestra no entra (la trama queda como estaba)
+  bool add(uint16_t raw_angle, uint16_t angle_cdeg, uint16_t pps_centi, uint16_t rpm_centi) {
+    if (hdr_.count == 255) return false;
+    if (hdr_.count == 0) {
+      hdr_.raw_angle = raw_angle;
+      hdr_.angle_cdeg = angle_cdeg;
+      hdr_.pps_centi = pps_centi;
+      hdr_.rpm_centi = rpm_centi;
+    } else {
+      uint8_t tmp[MAX_DELTA_LEN];
+      size_t n = 0;
+      n += putVarint(tmp + n, wrapDelta(prev_[0], raw_angle, RAW_MOD));
+      n += putVarint(tmp + n, wrapDelta(prev_[1], angle_cdeg, CDEG_MOD));
+      n += putVarint(tmp + n, (int32_t)pps_centi - (int32_t)prev_[2]);
+      n += putVarint(tmp + n, (int32_t)rpm_centi - (int32_t)prev_[3]);
+      if (len_ + n + 2 > ESPNOW_MAX_LEN) return false;
+      memcpy(buf_ + len_, tmp, n);
+      len_ += n;
+    }
+    prev_[0] = raw_angle;
+    prev_[1] = angle_cdeg;
+    prev_[2] = pps_centi;
+    prev_[3] = rpm_centi;
+    hdr_.count++;
+    return true;
+  }
+
+  uint8_t count() const { return hdr_.count; }
+
+  // Cierra la trama (cabecera + CRC); devuelve el largo a enviar
+  size_t finish() {
+    memcpy(buf_, &hdr_, sizeof(hdr_));
+    const uint16_t crc = crc16::update4(crc16::INIT, buf_, len_);
+    buf_[len_] = (uint8_t)(crc & 0xFF);
+    buf_[len_ + 1] = (uint8_t)(crc >> 8);
+    return len_ + 2;
+  }
+
+  const uint8_t* data() const { return buf_; }
+
+private:
+  WindPacketV2Hdr hdr_ {};
+  uint16_t prev_[4] = {};
+  uint8_t buf_[ESPNOW_MAX_LEN];
+  size_t len_ = sizeof(WindPacketV2Hdr);
+};
+
+} // namespace wpv2
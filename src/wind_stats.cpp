@@ -0,0 +1,125 @@
+#include "wind_stats.h"
+
+namespace wstats {
+
+const char* avgLabel(Avg a) {
+  switch (a) {
+    case Avg::INST: return "inst";
+    case Avg::S3:   return "3s";
+    case Avg::M2:   return "2m";
+    case Avg::M10:  return "10m";
+    default:        return "";
+  }
+}
+
+void WindStats::add(uint32_t t_ms, uint16_t dir_cdeg, uint16_t spd_centi) {
+  lastDirCdeg_ = dir_cdeg;
+  lastSpd_ = spd_centi;
+  have_ = true;
+
+  const trig::angle_t a = trig::fromCdeg(dir_cdeg);
+  s3_.add(t_ms, a, spd_centi);
+  m2_.add(t_ms, a, spd_centi);
+  m10_.add(t_ms, a, spd_centi);
+
+  const Bucket& t3 = s3_.totals();
+  gl_.add(t_ms, (uint16_t)((t3.sum_spd + t3.n / 2) / t3.n));
+}
+
+void WindStats::advance(uint32_t now_ms) {
+  s3_.advance(now_ms);
+  m2_.advance(now_ms);
+  m10_.advance(now_ms);
+  gl_.advance(now_ms);
+}
+
+// ----------------- ráfaga / calma -----------------
+void GustLull::closeSlot() {
+  if (!slotHave_) return;
+  gust_.push((uint16_t)sec_, slotMax_);
+  lull_.push((uint16_t)sec_, slotMin_);
+  slotHave_ = false;
+}
+
+void GustLull::advance(uint32_t now_ms) {
+  const uint32_t sec = now_ms / 1000u;
+  if (!started_) {
+    started_ = true;
+    sec_ = sec;
+    return;
+  }
+  if (sec == sec_) return;
+  // muestra tardía (onRecv entre drainRx() y millis()): va al slot actual
+  if ((int32_t)(sec - sec_) < 0 && (sec_ - sec) * 1000u <= LATE_MS) return;
+
+  if ((int32_t)(sec - sec_) < 0 || (sec - sec_) >= WINDOW_S) {   // hueco largo / salto atrás
+    gust_.clear();
+    lull_.clear();
+    slotHave_ = false;
+  } else {
+    closeSlot();
+  }
+  sec_ = sec;
+
+  // visibles: los WINDOW_S-1 segundos cerrados + el actual
+  const uint16_t oldest = (uint16_t)(sec_ - (WINDOW_S - 1));
+  gust_.expire(oldest);
+  lull_.expire(oldest);
+}
+
+void GustLull::add(uint32_t t_ms, uint16_t s3_centi) {
+  advance(t_ms);
+  if (!slotHave_) {
+    slotHave_ = true;
+    slotMax_ = s3_centi;
+    slotMin_ = s3_centi;
+  } else {
+    if (s3_centi > slotMax_) slotMax_ = s3_centi;
+    if (s3_centi < slotMin_) slotMin_ = s3_centi;
+  }
+}
+
+Extremes GustLull::get() const {
+  Extremes e;
+  const bool q = !gust_.empty();
+  if (!q && !slotHave_) return e;
+
+  uint16_t hi = q ? gust_.value() : slotMax_;
+  uint16_t lo = q ? lull_.value() : slotMin_;
+  if (slotHave_) {
+    if (slotMax_ > hi) hi = slotMax_;
+    if (slotMin_ < lo) lo = slotMin_;
+  }
+  e.valid = true;
+  e.gust_kn = (float)hi / 100.0f;
+  e.lull_kn = (float)lo / 100.0f;
+  return e;
+}
+
+static Mean fromBucket(const Bucket& t) {
+  Mean m;
+  if (t.n == 0) return m;
+  m.valid = true;
+  m.n = t.n;
+  m.spd_kn = (float)t.sum_spd / (100.0f * (float)t.n);
+  m.dir_deg = (float)trig::toDdeg(trig::atan2Bam64(t.sum_sin, t.sum_cos)) / 10.0f;
+  return m;
+}
+
+Mean WindStats::mean(Avg which) const {
+  switch (which) {
+    case Avg::S3:  return fromBucket(s3_.totals());
+    case Avg::M2:  return fromBucket(m2_.totals());
+    case Avg::M10: return fromBucket(m10_.totals());
+    default: {
+      Mean m;
+      m.valid = have_;
+      m.n = have_ ? 1 : 0;
+      m.dir_deg = (float)lastDirCdeg_ / 100.0f;
+      m.spd_kn = (float)lastSpd_ / 100.0f;
+      return m;
+    }
+  }
+}
+
+} // namespace wstats
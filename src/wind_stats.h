@@ -0,0 +1,152 @@
+#pragma once
+#include <stdint.h>
+#include "trig_q15.h"
+#include "mono_deque.h"
+
+namespace wstats {
+
+// ===================== Promedios deslizantes (estilo WMO) =====================
+// Cada paquete validado entra una vez (O(1)). Cada ventana es un ring de
+// buckets de tiempo fijo con totales corridos: al avanzar el tiempo se resta
+// el bucket que sale, al llegar un paquete se suma al bucket actual.
+// Velocidad: media escalar. Dirección: media vectorial (Q15, trig::VecSum).
+//
+//   INST : último paquete
+//   S3   : 3 s   = 12 x 250 ms
+//   M2   : 2 min = 120 x 1 s
+//   M10  : 10 min = 120 x 5 s
+// La ventana cubre entre (NB-1) y NB buckets (el actual está en llenado).
+// Sumas en 64 bits y n en uint32: con int32/uint16 la ventana de 10 min se
+// pasaba arriba de ~65k muestras (~109 paquetes/s, alcanzable con v2).
+
+enum class Avg : uint8_t { INST = 0, S3, M2, M10, COUNT };
+
+const char* avgLabel(Avg a);   // "inst", "3s", "2m", "10m"
+
+struct Mean {
+  bool valid = false;
+  float dir_deg = 0.0f;
+  float spd_kn = 0.0f;
+  uint32_t n = 0;              // muestras en la ventana
+};
+
+// Ráfaga / calma: máximo / mínimo de la media de 3 s en los últimos 10 min
+struct Extremes {
+  bool valid = false;
+  float gust_kn = 0.0f;
+  float lull_kn = 0.0f;
+};
+
+struct Bucket {
+  uint64_t sum_spd = 0;        // kn*100
+  int64_t  sum_sin = 0;        // Q15
+  int64_t  sum_cos = 0;
+  uint32_t n = 0;
+};
+
+// Muestras hasta LATE_MS atrás del último advance() se suman al bucket/segundo
+// actual; un salto mayor hacia atrás reinicia las ventanas
+static constexpr uint32_t LATE_MS = 2000;
+
+template <uint16_t NB, uint32_t BUCKET_MS>
+class Window {
+public:
+  // Atraso tolerado sin reiniciar (al menos un bucket)
+  static constexpr uint32_t LATE_BUCKETS = (LATE_MS / BUCKET_MS) ? (LATE_MS / BUCKET_MS) : 1;
+
+  void add(uint32_t t_ms, trig::angle_t dir, uint16_t spd_centi) {
+    advance(t_ms);
+    const int32_t s = trig::sinQ15(dir);
+    const int32_t c = trig::cosQ15(dir);
+    Bucket& b = ring_[cur_ % NB];
+    b.sum_spd += spd_centi; b.sum_sin += s; b.sum_cos += c; b.n++;
+    tot_.sum_spd += spd_centi; tot_.sum_sin += s; tot_.sum_cos += c; tot_.n++;
+  }
+
+  // Saca los buckets que quedaron fuera de la ventana (amortizado O(1))
+  void advance(uint32_t t_ms) {
+    const uint32_t idx = t_ms / BUCKET_MS;
+    if (!started_) {
+      started_ = true;
+      cur_ = idx;
+      return;
+    }
+    const uint32_t steps = idx - cur_;
+    if (steps == 0) return;
+    // una muestra estampada por onRecv entre drainRx() y now = millis() llega
+    // apenas atrás del último advance(now): va al bucket actual
+    if ((int32_t)steps < 0 && (uint32_t)-(int32_t)steps <= LATE_BUCKETS) return;
+    if ((int32_t)steps < 0 || steps >= NB) {   // hueco largo o salto grande hacia atrás
+      clear();
+      cur_ = idx;
+      return;
+    }
+    for (uint32_t k = 0; k < steps; k++) {
+      cur_++;
+      Bucket& b = ring_[cur_ % NB];
+      tot_.sum_spd -= b.sum_spd; tot_.sum_sin -= b.sum_sin; tot_.sum_cos -= b.sum_cos; tot_.n -= b.n;
+      b = Bucket();
+    }
+  }
+
+  const Bucket& totals() const { return tot_; }
+
+private:
+  void clear() {
+    for (uint16_t i = 0; i < NB; i++) ring_[i] = Bucket();
+    tot_ = Bucket();
+  }
+
+  Bucket ring_[NB];
+  Bucket tot_;
+  uint32_t cur_ = 0;
+  bool started_ = false;
+};
+
+// Extremos de la media de 3 s. Cada paquete actualiza el máx/mín del
+// segundo en curso; al cerrar el segundo entra a deques monótonas de 600 s
+// (O(1) amortizado). Resolución de la ventana: 1 s.
+class GustLull {
+public:
+  static constexpr uint16_t WINDOW_S = 600;
+
+  void add(uint32_t t_ms, uint16_t s3_centi);
+  void advance(uint32_t now_ms);
+  Extremes get() const;
+
+private:
+  void closeSlot();
+
+  uint32_t sec_ = 0;          // segundo del slot actual
+  bool started_ = false;
+  bool slotHave_ = false;
+  uint16_t slotMax_ = 0;
+  uint16_t slotMin_ = 0;
+
+  MonoDeque<WINDOW_S, true>  gust_;
+  MonoDeque<WINDOW_S, false> lull_;
+};
+
+class WindStats {
+public:
+  // dir en centésimas de grado ya corregida (0..35999), velocidad kn*100
+  void add(uint32_t t_ms, uint16_t dir_cdeg, uint16_t spd_centi);
+
+  // Llamar en cada loop(): vacía ventanas aunque no lleguen paquetes
+  void advance(uint32_t now_ms);
+
+  Mean mean(Avg which) const;
+  Extremes gustLull() const { return gl_.get(); }
+
+private:
+  uint16_t lastDirCdeg_ = 0;
+  uint16_t lastSpd_ = 0;
+  bool have_ = false;
+
+  Window<12, 250>   s3_;
+  Window<120, 1000> m2_;
+  Window<120, 5000> m10_;
+  GustLull gl_;
+};
+
+} // namespace wstats
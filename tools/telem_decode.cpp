@@ -0,0 +1,99 @@
+// Decodificador de telemetría binaria (host) -> CSV
+//
+//   g++ -std=c++17 -O2 -I../src telem_decode.cpp -o telem_decode
+//   ./telem_decode captura.bin > captura.csv      (o por stdin)
+//
+// Captura: lo que sale por el Serial USB después de mandar 'b', por ejemplo
+//   stty -F /dev/ttyUSB0 115200 raw && cat /dev/ttyUSB0 > captura.bin
+// Lo que no sea una trama válida (texto previo, tramas cortadas, CRC malo)
+// se cuenta y se descarta; el resumen va a stderr.
+
+#include <stdio.h>
+#include <string.h>
+#include <vector>
+#include "telemetry.h"
+
+static const char* rejName(uint8_t r) {
+  switch (r) {
+    case telem::REJ_LEN:   return "len";
+    case telem::REJ_MAGIC: return "magic";
+    case telem::REJ_CRC:   return "crc";
+    case telem::REJ_DUP:   return "dup";
+    case telem::REJ_OLD:   return "old";
+    case telem::REJ_LATE:  return "late";
+    default:               return "?";
+  }
+}
+
+struct Counts {
+  unsigned long pkt = 0, rej = 0, badCobs = 0, badCrc = 0, badType = 0;
+};
+
+static void decodeFrame(const uint8_t* f, size_t n, Counts& c) {
+  uint8_t rec[telem::MAX_REC];
+  if (n == 0) return;                          // 0x00 consecutivos
+  if (n > telem::MAX_FRAME) { c.badCobs++; return; }
+
+  const size_t m = telem::cobsDecode(f, n, rec, sizeof(rec));
+  if (m < 3) { c.badCobs++; return; }
+
+  const uint16_t crc = (uint16_t)(rec[m - 2] | (rec[m - 1] << 8));
+  if (crc16_modbus(rec, m - 2) != crc) { c.badCrc++; return; }
+
+  const uint8_t type = rec[0];
+  const uint8_t* p = rec + 1;
+  const size_t plen = m - 3;
+
+  if (type == telem::REC_PKT && plen == sizeof(telem::RecPkt)) {
+    telem::RecPkt r;
+    memcpy(&r, p, sizeof(r));
+    const WindPacket& w = r.pkt;
+    printf("pkt,%lu,%lu,,,%lu,%u,%u,%u,%u,%u,0x%04X,%u,%.2f,%.2f\n",
+           (unsigned long)r.rx_ms, (unsigned long)w.seq, (unsigned long)w.timestamp_ms,
+           w.raw_angle, w.angle_cdeg, w.pps_centi, w.rpm_centi, w.vbat_mV,
+           w.status, w.i2c_err_count,
+           r.dir_cdeg / 100.0, r.spd_centi / 100.0);
+    c.pkt++;
+  } else if (type == telem::REC_REJ && plen == sizeof(telem::RecRej)) {
+    telem::RecRej r;
+    memcpy(&r, p, sizeof(r));
+    printf("rej,%lu,%lu,%s,%u,,,,,,,,,,\n",
+           (unsigned long)r.rx_ms, (unsigned long)r.seq, rejName(r.reason), r.len);
+    c.rej++;
+  } else {
+    c.badType++;
+  }
+}
+
+int main(int argc, char** argv) {
+  FILE* in = stdin;
+  if (argc > 1) {
+    in = fopen(argv[1], "rb");
+    if (!in) {
+      perror(argv[1]);
+      return 1;
+    }
+  }
+
+  printf("type,rx_ms,seq,reject,len,tx_ms,raw_angle,angle_cdeg,pps_centi,rpm_centi,"
+         "vbat_mV,status,i2c_err,dir_deg,spd_kn\n");
+
+  Counts c;
+  std::vector<uint8_t> frame;
+  frame.reserve(telem::MAX_FRAME);
+
+  int ch;
+  while ((ch = fgetc(in)) != EOF) {
+    if (ch == 0x00) {
+      decodeFrame(frame.data(), frame.size(), c);
+      frame.clear();
+    } else if (frame.size() <= telem::MAX_FRAME) {
+      frame.push_back((uint8_t)ch);            // si se pasa, se descarta al cerrar
+    }
+  }
+
+  if (in != stdin) fclose(in);
+  fprintf(stderr, "pkt=%lu rej=%lu  descartadas: cobs=%lu crc=%lu tipo=%lu\n",
+          c.pkt, c.rej, c.badCobs, c.badCrc, c.badType);
+  return 0;
+}